@@ -5,40 +5,112 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../Core/Src/app_rtos.c \
+../Core/Src/batch_queue.c \
+../Core/Src/boot_profile.c \
+../Core/Src/chamber_model.c \
+../Core/Src/control_timing.c \
+../Core/Src/cooling.c \
+../Core/Src/cpu_load.c \
+../Core/Src/double_buffer.c \
+../Core/Src/energy_meter.c \
+../Core/Src/event_queue.c \
 ../Core/Src/gui_backend.c \
+../Core/Src/halfcycle_modulator.c \
+../Core/Src/heater_zones.c \
 ../Core/Src/main.c \
+../Core/Src/mains_monitor.c \
 ../Core/Src/max6675.c \
+../Core/Src/mem_guard.c \
 ../Core/Src/pid.c \
+../Core/Src/power_linearization.c \
+../Core/Src/profiler.c \
 ../Core/Src/reflow_oven_process.c \
+../Core/Src/run_recorder.c \
+../Core/Src/scheduler.c \
 ../Core/Src/stm32f4xx_hal_msp.c \
 ../Core/Src/stm32f4xx_it.c \
 ../Core/Src/syscalls.c \
 ../Core/Src/sysmem.c \
-../Core/Src/system_stm32f4xx.c 
+../Core/Src/system_stm32f4xx.c \
+../Core/Src/telemetry.c \
+../Core/Src/thermal_fault.c \
+../Core/Src/thermal_mass.c \
+../Core/Src/trace.c \
+../Core/Src/transient_detector.c \
+../Core/Src/watchdog.c 
 
 OBJS += \
+./Core/Src/app_rtos.o \
+./Core/Src/batch_queue.o \
+./Core/Src/boot_profile.o \
+./Core/Src/chamber_model.o \
+./Core/Src/control_timing.o \
+./Core/Src/cooling.o \
+./Core/Src/cpu_load.o \
+./Core/Src/double_buffer.o \
+./Core/Src/energy_meter.o \
+./Core/Src/event_queue.o \
 ./Core/Src/gui_backend.o \
+./Core/Src/halfcycle_modulator.o \
+./Core/Src/heater_zones.o \
 ./Core/Src/main.o \
+./Core/Src/mains_monitor.o \
 ./Core/Src/max6675.o \
+./Core/Src/mem_guard.o \
 ./Core/Src/pid.o \
+./Core/Src/power_linearization.o \
+./Core/Src/profiler.o \
 ./Core/Src/reflow_oven_process.o \
+./Core/Src/run_recorder.o \
+./Core/Src/scheduler.o \
 ./Core/Src/stm32f4xx_hal_msp.o \
 ./Core/Src/stm32f4xx_it.o \
 ./Core/Src/syscalls.o \
 ./Core/Src/sysmem.o \
-./Core/Src/system_stm32f4xx.o 
+./Core/Src/system_stm32f4xx.o \
+./Core/Src/telemetry.o \
+./Core/Src/thermal_fault.o \
+./Core/Src/thermal_mass.o \
+./Core/Src/trace.o \
+./Core/Src/transient_detector.o \
+./Core/Src/watchdog.o 
 
 C_DEPS += \
+./Core/Src/app_rtos.d \
+./Core/Src/batch_queue.d \
+./Core/Src/boot_profile.d \
+./Core/Src/chamber_model.d \
+./Core/Src/control_timing.d \
+./Core/Src/cooling.d \
+./Core/Src/cpu_load.d \
+./Core/Src/double_buffer.d \
+./Core/Src/energy_meter.d \
+./Core/Src/event_queue.d \
 ./Core/Src/gui_backend.d \
+./Core/Src/halfcycle_modulator.d \
+./Core/Src/heater_zones.d \
 ./Core/Src/main.d \
+./Core/Src/mains_monitor.d \
 ./Core/Src/max6675.d \
+./Core/Src/mem_guard.d \
 ./Core/Src/pid.d \
+./Core/Src/power_linearization.d \
+./Core/Src/profiler.d \
 ./Core/Src/reflow_oven_process.d \
+./Core/Src/run_recorder.d \
+./Core/Src/scheduler.d \
 ./Core/Src/stm32f4xx_hal_msp.d \
 ./Core/Src/stm32f4xx_it.d \
 ./Core/Src/syscalls.d \
 ./Core/Src/sysmem.d \
-./Core/Src/system_stm32f4xx.d 
+./Core/Src/system_stm32f4xx.d \
+./Core/Src/telemetry.d \
+./Core/Src/thermal_fault.d \
+./Core/Src/thermal_mass.d \
+./Core/Src/trace.d \
+./Core/Src/transient_detector.d \
+./Core/Src/watchdog.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -48,7 +120,7 @@ Core/Src/%.o Core/Src/%.su Core/Src/%.cyclo: ../Core/Src/%.c Core/Src/subdir.mk
 clean: clean-Core-2f-Src
 
 clean-Core-2f-Src:
-	-$(RM) ./Core/Src/gui_backend.cyclo ./Core/Src/gui_backend.d ./Core/Src/gui_backend.o ./Core/Src/gui_backend.su ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/max6675.cyclo ./Core/Src/max6675.d ./Core/Src/max6675.o ./Core/Src/max6675.su ./Core/Src/pid.cyclo ./Core/Src/pid.d ./Core/Src/pid.o ./Core/Src/pid.su ./Core/Src/reflow_oven_process.cyclo ./Core/Src/reflow_oven_process.d ./Core/Src/reflow_oven_process.o ./Core/Src/reflow_oven_process.su ./Core/Src/stm32f4xx_hal_msp.cyclo ./Core/Src/stm32f4xx_hal_msp.d ./Core/Src/stm32f4xx_hal_msp.o ./Core/Src/stm32f4xx_hal_msp.su ./Core/Src/stm32f4xx_it.cyclo ./Core/Src/stm32f4xx_it.d ./Core/Src/stm32f4xx_it.o ./Core/Src/stm32f4xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32f4xx.cyclo ./Core/Src/system_stm32f4xx.d ./Core/Src/system_stm32f4xx.o ./Core/Src/system_stm32f4xx.su
+	-$(RM) ./Core/Src/app_rtos.cyclo ./Core/Src/app_rtos.d ./Core/Src/app_rtos.o ./Core/Src/app_rtos.su ./Core/Src/batch_queue.cyclo ./Core/Src/batch_queue.d ./Core/Src/batch_queue.o ./Core/Src/batch_queue.su ./Core/Src/boot_profile.cyclo ./Core/Src/boot_profile.d ./Core/Src/boot_profile.o ./Core/Src/boot_profile.su ./Core/Src/chamber_model.cyclo ./Core/Src/chamber_model.d ./Core/Src/chamber_model.o ./Core/Src/chamber_model.su ./Core/Src/control_timing.cyclo ./Core/Src/control_timing.d ./Core/Src/control_timing.o ./Core/Src/control_timing.su ./Core/Src/cooling.cyclo ./Core/Src/cooling.d ./Core/Src/cooling.o ./Core/Src/cooling.su ./Core/Src/cpu_load.cyclo ./Core/Src/cpu_load.d ./Core/Src/cpu_load.o ./Core/Src/cpu_load.su ./Core/Src/double_buffer.cyclo ./Core/Src/double_buffer.d ./Core/Src/double_buffer.o ./Core/Src/double_buffer.su ./Core/Src/energy_meter.cyclo ./Core/Src/energy_meter.d ./Core/Src/energy_meter.o ./Core/Src/energy_meter.su ./Core/Src/event_queue.cyclo ./Core/Src/event_queue.d ./Core/Src/event_queue.o ./Core/Src/event_queue.su ./Core/Src/gui_backend.cyclo ./Core/Src/gui_backend.d ./Core/Src/gui_backend.o ./Core/Src/gui_backend.su ./Core/Src/halfcycle_modulator.cyclo ./Core/Src/halfcycle_modulator.d ./Core/Src/halfcycle_modulator.o ./Core/Src/halfcycle_modulator.su ./Core/Src/heater_zones.cyclo ./Core/Src/heater_zones.d ./Core/Src/heater_zones.o ./Core/Src/heater_zones.su ./Core/Src/main.cyclo ./Core/Src/main.d ./Core/Src/main.o ./Core/Src/main.su ./Core/Src/mains_monitor.cyclo ./Core/Src/mains_monitor.d ./Core/Src/mains_monitor.o ./Core/Src/mains_monitor.su ./Core/Src/max6675.cyclo ./Core/Src/max6675.d ./Core/Src/max6675.o ./Core/Src/max6675.su ./Core/Src/mem_guard.cyclo ./Core/Src/mem_guard.d ./Core/Src/mem_guard.o ./Core/Src/mem_guard.su ./Core/Src/pid.cyclo ./Core/Src/pid.d ./Core/Src/pid.o ./Core/Src/pid.su ./Core/Src/power_linearization.cyclo ./Core/Src/power_linearization.d ./Core/Src/power_linearization.o ./Core/Src/power_linearization.su ./Core/Src/profiler.cyclo ./Core/Src/profiler.d ./Core/Src/profiler.o ./Core/Src/profiler.su ./Core/Src/reflow_oven_process.cyclo ./Core/Src/reflow_oven_process.d ./Core/Src/reflow_oven_process.o ./Core/Src/reflow_oven_process.su ./Core/Src/run_recorder.cyclo ./Core/Src/run_recorder.d ./Core/Src/run_recorder.o ./Core/Src/run_recorder.su ./Core/Src/scheduler.cyclo ./Core/Src/scheduler.d ./Core/Src/scheduler.o ./Core/Src/scheduler.su ./Core/Src/stm32f4xx_hal_msp.cyclo ./Core/Src/stm32f4xx_hal_msp.d ./Core/Src/stm32f4xx_hal_msp.o ./Core/Src/stm32f4xx_hal_msp.su ./Core/Src/stm32f4xx_it.cyclo ./Core/Src/stm32f4xx_it.d ./Core/Src/stm32f4xx_it.o ./Core/Src/stm32f4xx_it.su ./Core/Src/syscalls.cyclo ./Core/Src/syscalls.d ./Core/Src/syscalls.o ./Core/Src/syscalls.su ./Core/Src/sysmem.cyclo ./Core/Src/sysmem.d ./Core/Src/sysmem.o ./Core/Src/sysmem.su ./Core/Src/system_stm32f4xx.cyclo ./Core/Src/system_stm32f4xx.d ./Core/Src/system_stm32f4xx.o ./Core/Src/system_stm32f4xx.su ./Core/Src/telemetry.cyclo ./Core/Src/telemetry.d ./Core/Src/telemetry.o ./Core/Src/telemetry.su ./Core/Src/thermal_fault.cyclo ./Core/Src/thermal_fault.d ./Core/Src/thermal_fault.o ./Core/Src/thermal_fault.su ./Core/Src/thermal_mass.cyclo ./Core/Src/thermal_mass.d ./Core/Src/thermal_mass.o ./Core/Src/thermal_mass.su ./Core/Src/trace.cyclo ./Core/Src/trace.d ./Core/Src/trace.o ./Core/Src/trace.su ./Core/Src/transient_detector.cyclo ./Core/Src/transient_detector.d ./Core/Src/transient_detector.o ./Core/Src/transient_detector.su ./Core/Src/watchdog.cyclo ./Core/Src/watchdog.d ./Core/Src/watchdog.o ./Core/Src/watchdog.su
 
 .PHONY: clean-Core-2f-Src
 
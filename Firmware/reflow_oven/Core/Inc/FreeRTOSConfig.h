@@ -0,0 +1,111 @@
+/*
+ * FreeRTOSConfig.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: FreeRTOS kernel configuration of the Debug_RTOS build
+ *              (REFLOW_USE_RTOS = 1). Every kernel object is statically
+ *              allocated, the tick runs at 1 kHz on SysTick so the time base
+ *              matches HAL_GetTick, and the idle task stops the tick while
+ *              nothing is ready (tickless idle).
+ *
+ *              Interrupts that call the kernel API must sit at or below
+ *              configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY in urgency; the
+ *              zero-cross timer (TIM1, priority 0) never calls the kernel
+ *              and stays above the masked range so the half-cycle firing is
+ *              never delayed by a critical section.
+ */
+
+#ifndef INC_FREERTOSCONFIG_H_
+#define INC_FREERTOSCONFIG_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+#include <stdint.h>
+extern uint32_t SystemCoreClock;
+extern void Error_Handler(void);
+extern void CpuLoad_sleepBegin(void);
+extern void CpuLoad_sleepEnd(void);
+#endif
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+/* Scheduling */
+#define configUSE_PREEMPTION                    1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#define configCPU_CLOCK_HZ                      (SystemCoreClock)
+#define configTICK_RATE_HZ                      ((TickType_t)1000)
+#define configMAX_PRIORITIES                    5
+#define configMINIMAL_STACK_SIZE                ((uint16_t)128)
+#define configMAX_TASK_NAME_LEN                 8
+#define configUSE_16_BIT_TICKS                  0
+#define configIDLE_SHOULD_YIELD                 1
+#define configUSE_TIME_SLICING                  0 /* Equal priorities never share the CPU here */
+
+/* Tickless idle: SysTick stops while every task is blocked */
+#define configUSE_TICKLESS_IDLE                 1
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   2
+/* The time asleep in WFI gives the CPU load (cpu_load.h) */
+#define configPRE_SLEEP_PROCESSING(x)           CpuLoad_sleepBegin()
+#define configPOST_SLEEP_PROCESSING(x)          CpuLoad_sleepEnd()
+
+/* Memory: static allocation only, no heap_x.c in the build */
+#define configSUPPORT_STATIC_ALLOCATION         1
+#define configSUPPORT_DYNAMIC_ALLOCATION        0
+
+/* Features */
+#define configUSE_MUTEXES                       0
+#define configUSE_COUNTING_SEMAPHORES           0
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configUSE_TIMERS                        0
+#define configUSE_CO_ROUTINES                   0
+#define configQUEUE_REGISTRY_SIZE               0
+
+/* Hooks */
+#define configUSE_IDLE_HOOK                     0
+#define configUSE_TICK_HOOK                     0
+#define configUSE_MALLOC_FAILED_HOOK            0
+#define configCHECK_FOR_STACK_OVERFLOW          2 /* vApplicationStackOverflowHook forces the safe state */
+
+/* Optional API */
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_vTaskDelayUntil                 1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_vTaskDelete                     0
+#define INCLUDE_uxTaskPriorityGet               0
+#define INCLUDE_vTaskPrioritySet                0
+
+/* Cortex-M4 interrupt priorities (4 priority bits on the STM32F4) */
+#ifdef __NVIC_PRIO_BITS
+#define configPRIO_BITS __NVIC_PRIO_BITS
+#else
+#define configPRIO_BITS 4
+#endif
+
+#define configLIBRARY_LOWEST_INTERRUPT_PRIORITY      15 /* Same as TICK_INT_PRIORITY */
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY 5  /* Highest priority allowed to call ...FromISR */
+
+#define configKERNEL_INTERRUPT_PRIORITY      (configLIBRARY_LOWEST_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+
+/* A failed kernel assertion is a firmware bug: heaters off, halt until the watchdog resets */
+#define configASSERT(x) \
+    if ((x) == 0) {     \
+        Error_Handler(); \
+    }
+
+/* Kernel handlers take the CMSIS vector names. CubeMX must not generate
+ * SVC_Handler and PendSV_Handler (NVIC > Code generation > "Generate IRQ
+ * handler" unchecked for both); the cooperative build's PendSV_Handler is in
+ * main.c. SysTick_Handler stays generated and forwards to xPortSysTickHandler
+ * itself so HAL_IncTick keeps running before the scheduler starts */
+#define vPortSVCHandler    SVC_Handler
+#define xPortPendSVHandler PendSV_Handler
+
+#endif /* INC_FREERTOSCONFIG_H_ */
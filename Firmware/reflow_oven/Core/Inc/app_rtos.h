@@ -0,0 +1,101 @@
+/*
+ * app_rtos.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: FreeRTOS task set of the Debug_RTOS build (REFLOW_USE_RTOS = 1),
+ *              the alternative to the cooperative scheduler:
+ *
+ *                acquisition --sample queue--> control --tick queue--> telemetry
+ *                gui (periodic, independent)
+ *
+ *              - acquisition: reads the probes every APPRTOS_CONTROL_PERIOD_MS;
+ *                the blocking SPI reads and the inter-read delays only block
+ *                this task.
+ *              - control: highest priority, wakes on a sample and runs the
+ *                fault checks, the process and the actuators, then feeds the
+ *                watchdog.
+ *              - gui: encoder and pages every APPRTOS_GUI_PERIOD_MS.
+ *              - telemetry: lowest priority, wakes on every completed control
+ *                tick for the run recorder, batch hand-off and reports.
+ *
+ *              Tasks, stacks and queues are statically allocated. The task
+ *              bodies stay in main.c and are passed in through
+ *              AppRtos_config_t, so both builds run the same code.
+ */
+
+#ifndef INC_APP_RTOS_H_
+#define INC_APP_RTOS_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "main.h"
+#include <stdint.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define APPRTOS_NUM_PROBES        4u    /* Probes carried by a sample */
+#define APPRTOS_CONTROL_PERIOD_MS 250u  /* Acquisition period, paces the control loop (4 Hz) */
+#define APPRTOS_GUI_PERIOD_MS     10u   /* Encoder and page update period */
+
+/* Queue depths: one sample of slack, telemetry may fall a few ticks behind */
+#define APPRTOS_SAMPLE_QUEUE_LEN  2u
+#define APPRTOS_TICK_QUEUE_LEN    4u
+
+/* Stack sizes (words) */
+#define APPRTOS_ACQ_STACK         256u
+#define APPRTOS_CONTROL_STACK     512u
+#define APPRTOS_GUI_STACK         512u
+#define APPRTOS_TELEMETRY_STACK   768u  /* Telemetry_printf formats floats */
+
+/* Priorities (higher number = more urgent) */
+#define APPRTOS_CONTROL_PRIO      4u
+#define APPRTOS_ACQ_PRIO          3u
+#define APPRTOS_GUI_PRIO          2u
+#define APPRTOS_TELEMETRY_PRIO    1u
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief One acquisition, passed by value from acquisition to control
+ */
+typedef struct {
+    uint32_t timeMs;                   /* Acquisition release time (ms, HAL_GetTick base) */
+    float probes[APPRTOS_NUM_PROBES];  /* Reading of each probe (°C) */
+    float chamber;                     /* Fused chamber temperature (°C) */
+} AppRtos_sample_t;
+
+/**
+ * @brief Task bodies supplied by the application
+ */
+typedef struct {
+    void (*acquire)(AppRtos_sample_t *sample);       /* Read the probes into the sample */
+    void (*control)(const AppRtos_sample_t *sample); /* Faults -> process -> actuators */
+    void (*logging)(uint32_t nowMs);                 /* Recorder and batch hand-off of a tick */
+    void (*telemetry)(uint32_t nowMs);               /* UART reports */
+    void (*gui)(uint32_t nowMs);                     /* Encoder and pages */
+} AppRtos_config_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Create the tasks and queues and start the kernel; does not return
+ *
+ * @param config Task bodies (must stay valid)
+ */
+void AppRtos_start(const AppRtos_config_t *config);
+
+/**
+ * @brief Control ticks the telemetry task dropped because its queue was full
+ *
+ * @return uint32_t - Dropped ticks since boot
+ */
+uint32_t AppRtos_getDroppedTicks(void);
+
+#endif /* INC_APP_RTOS_H_ */
@@ -0,0 +1,180 @@
+/*
+ * batch_queue.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Batch mode. A queue of (profile, count) entries is run board
+ *              after board: every board cools only to a safe unload
+ *              temperature, the oven holds there (warm standby) until the
+ *              operator confirms the next board is loaded, and preheat starts
+ *              again with the next queued profile. A run summary is kept for
+ *              every board of the batch.
+ *
+ *              The module never prints: it is driven from the GUI under the
+ *              control lock and from the control step (a fault aborts the
+ *              batch), so its events are queued and the telemetry task
+ *              reports them (BatchQueue_getReport).
+ */
+
+#ifndef INC_BATCH_QUEUE_H_
+#define INC_BATCH_QUEUE_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "reflow_oven_process.h"
+#include "run_recorder.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define BATCH_MAX_ENTRIES          4u     /* Different profiles in one batch */
+#define BATCH_MAX_BOARDS           24u    /* Boards in one batch (one summary each) */
+#define BATCH_DEFAULT_UNLOAD_TEMP  80.0f  /* Safe unload temperature (°C) */
+#define BATCH_REPORT_SLOTS         4u     /* Events held for the telemetry task (power of two) */
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Batch execution state
+ */
+typedef enum {
+    BATCH_IDLE,         /* No batch running */
+    BATCH_RUNNING,      /* A board is going through its profile */
+    BATCH_WAIT_CONFIRM, /* Board done, waiting for the operator to swap boards */
+} BatchQueue_state_t;
+
+/**
+ * @brief Batch event waiting to be reported
+ */
+typedef enum {
+    BATCH_REPORT_START, /* Batch started */
+    BATCH_REPORT_BOARD, /* Board finished, with its summary */
+    BATCH_REPORT_WAIT,  /* Waiting for the operator to swap boards */
+    BATCH_REPORT_END,   /* Every queued board done */
+    BATCH_REPORT_ABORT, /* Batch stopped early */
+} BatchQueue_reportType_t;
+
+/**
+ * @brief Batch event, as the telemetry task reports it
+ */
+typedef struct {
+    BatchQueue_reportType_t type;
+    uint8_t boards;           /* START: boards queued, otherwise boards finished */
+    uint8_t entries;          /* START: entries queued, WAIT: boards queued, BOARD: entry of the board */
+    uint8_t endReason;        /* BOARD: RunRecorder_endReason_t */
+    float boardsPerHour;      /* WAIT, END, ABORT: throughput of the batch */
+    float durationS;          /* BOARD: run duration (s) */
+    float peakTemperature;    /* BOARD: highest fused temperature (°C) */
+    float timeAboveLiquidusS; /* BOARD: time above liquidus (s) */
+    float zoneSpreadMax;      /* BOARD: worst heater zone spread (°C) */
+    float energyWh;           /* BOARD: heater energy (Wh) */
+} BatchQueue_report_t;
+
+/**
+ * @brief One queue entry: a profile and how many boards run with it
+ */
+typedef struct {
+    ReflowOven_parameters_t profile;
+    uint8_t count;
+} BatchQueue_entry_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Empty the queue and forget the previous batch
+ */
+void BatchQueue_Init(void);
+
+/**
+ * @brief Append an entry to the queue
+ *
+ * @param profile Profile the boards of this entry run with
+ * @param count Number of boards
+ * @return bool - False if a batch is running or the queue/board limit is reached
+ */
+bool BatchQueue_add(const ReflowOven_parameters_t *profile, uint8_t count);
+
+/**
+ * @brief Set the temperature boards cool down to before unloading
+ *
+ * @param temperature Unload temperature (°C), 40..100
+ * @return bool - False if out of range or a batch is running
+ */
+bool BatchQueue_setUnloadTemperature(float temperature);
+
+/**
+ * @brief Start the queued batch with the first board
+ *
+ * @param currentTimeMs Current system time in milliseconds
+ * @return bool - False if the queue is empty or the oven is mid-run
+ */
+bool BatchQueue_start(uint32_t currentTimeMs);
+
+/**
+ * @brief Operator confirmation: the finished board was unloaded and the next one loaded
+ *
+ * @return bool - True if the next board started
+ */
+bool BatchQueue_confirm(void);
+
+/**
+ * @brief Abort the batch; a board in progress goes to cooldown
+ */
+void BatchQueue_abort(void);
+
+/**
+ * @brief Follow the running board, to be called every control tick after the recorder
+ *
+ * @param currentTimeMs Current system time in milliseconds
+ */
+void BatchQueue_update(uint32_t currentTimeMs);
+
+/**
+ * @brief Get the batch state
+ *
+ * @return BatchQueue_state_t - Current state
+ */
+BatchQueue_state_t BatchQueue_getState(void);
+
+/**
+ * @brief Throughput of the current (or last) batch
+ *
+ * @param currentTimeMs Current system time in milliseconds
+ * @return float - Finished boards per hour since the batch started, 0 before the first board
+ */
+float BatchQueue_getBoardsPerHour(uint32_t currentTimeMs);
+
+/**
+ * @brief Number of boards finished in the current (or last) batch
+ *
+ * @return uint8_t - Boards with a stored summary
+ */
+uint8_t BatchQueue_getBoardCount(void);
+
+/**
+ * @brief Run summary of a finished board
+ *
+ * @param board Board index in the batch (0 = first)
+ * @return const RunRecorder_summary_t* - Summary, NULL if out of range
+ */
+const RunRecorder_summary_t *BatchQueue_getBoardSummary(uint8_t board);
+
+/**
+ * @brief Take the oldest batch event not reported yet
+ *
+ * Call from the telemetry task with the control lock held: the events are
+ * queued from the control step too.
+ *
+ * @param report Event, filled when one is pending
+ * @return bool - False when nothing is pending
+ */
+bool BatchQueue_getReport(BatchQueue_report_t *report);
+
+#endif /* INC_BATCH_QUEUE_H_ */
@@ -0,0 +1,94 @@
+/*
+ * boot_profile.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Startup profile. main() marks the end of each init step and
+ *              the first valid thermocouple reading marks the end of boot;
+ *              each mark keeps the time since the entry to main(). The two
+ *              figures that matter are:
+ *              - boot -> safe actuators: SSR and fan inputs driven low
+ *              - boot -> first valid sample: the control loop has a reading
+ *              The second one is bounded by the MAX6675 conversion time
+ *              (~220 ms from releasing the chip selects), so everything
+ *              else is initialised while the first conversions run.
+ *
+ *              Times come from the DWT cycle counter at the core clock in
+ *              force at the previous mark. The clock step switches from the
+ *              16 MHz HSI to the 100 MHz PLL and is counted at HSI rate: its
+ *              few microseconds at 100 MHz are over-counted, so the figure
+ *              is an upper bound. Marks further apart than the counter span
+ *              fall back to the millisecond tick.
+ */
+
+#ifndef INC_BOOT_PROFILE_H_
+#define INC_BOOT_PROFILE_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define BOOT_PROFILE_CYCLES_SPAN_MS 10000u /* Longest gap timed with CYCCNT (wraps in 43 s at 100 MHz) */
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Startup steps, in boot order
+ */
+typedef enum {
+    BOOT_STEP_SAFE_STATE,   /* SSR and fan inputs driven low, before anything else */
+    BOOT_STEP_HAL,          /* HAL_Init: flash accelerators, SysTick on the HSI */
+    BOOT_STEP_WATCHDOG,     /* IWDG running */
+    BOOT_STEP_CLOCK,        /* HSE start-up, PLL lock, 100 MHz, CSS */
+    BOOT_STEP_PERIPHERALS,  /* MX_*_Init */
+    BOOT_STEP_SENSORS,      /* MAX6675 chip selects released: first conversions running */
+    BOOT_STEP_MODULES,      /* Queues, GUI, telemetry and control state */
+    BOOT_STEP_ACTUATORS,    /* Zero-cross timer and heater/cooling PWM running */
+    BOOT_STEP_SCHEDULER,    /* Timebase running (kernel about to start in the RTOS build) */
+    BOOT_STEP_FIRST_SAMPLE, /* First reading with a probe answering */
+    BOOT_NUM_STEPS
+} BootProfile_step_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Start the profile; call first thing in main() with the DWT counter running
+ */
+void BootProfile_Init(void);
+
+/**
+ * @brief Mark the end of a step (thread context only)
+ *
+ * Only the first mark of a step counts, later ones are ignored.
+ *
+ * @param step Step just completed
+ */
+void BootProfile_mark(BootProfile_step_t step);
+
+/**
+ * @brief Time at which a step completed
+ *
+ * @param step Startup step
+ * @param us Microseconds since the entry to main()
+ * @return bool - False while the step has not been marked
+ */
+bool BootProfile_get(BootProfile_step_t step, uint32_t *us);
+
+/**
+ * @brief Short name of a step for telemetry
+ *
+ * @param step Startup step
+ * @return const char* - Step name, "?" when unknown
+ */
+const char *BootProfile_getName(BootProfile_step_t step);
+
+#endif /* INC_BOOT_PROFILE_H_ */
@@ -0,0 +1,84 @@
+/*
+ * chamber_model.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: First-order model of the oven chamber, shared by the thermal
+ *              mass identification, the feedforward, the transient detector
+ *              and the fault detector:
+ *
+ *                  slope = gain * power / 100 - (T - AMBIENT) / TAU
+ *
+ *              The losses (TAU, AMBIENT) are fixed by the oven. The heating
+ *              gain depends on the load and is the one identified value: the
+ *              preheat identification sets it at the start of every run and
+ *              the transient detector keeps tracking it afterwards.
+ */
+
+#ifndef INC_CHAMBER_MODEL_H_
+#define INC_CHAMBER_MODEL_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define CHAMBER_REF_GAIN  1.5f    /* Slope at full power from ambient with the reference load (°C/s) */
+#define CHAMBER_TAU       600.0f  /* Chamber loss time constant (s) */
+#define CHAMBER_AMBIENT   25.0f   /* Ambient temperature of the model (°C) */
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Reset the heating gain to the reference load
+ */
+void ChamberModel_Init(void);
+
+/**
+ * @brief Replace the identified heating gain
+ *
+ * @param gain Slope at full power from ambient (°C/s), ignored unless positive
+ */
+void ChamberModel_setGain(float gain);
+
+/**
+ * @brief Identified heating gain of the loaded oven
+ *
+ * @return float - Slope at full power from ambient (°C/s)
+ */
+float ChamberModel_getGain(void);
+
+/**
+ * @brief Cooling slope of the chamber at a temperature
+ *
+ * @param temperature Chamber temperature (°C)
+ * @return float - (T - AMBIENT) / TAU (°C/s), negative below ambient
+ */
+float ChamberModel_losses(float temperature);
+
+/**
+ * @brief Slope the model expects for a heater command
+ *
+ * @param power Mean heater command (%)
+ * @param temperature Mean chamber temperature (°C)
+ * @return float - Expected slope with the identified gain (°C/s)
+ */
+float ChamberModel_slope(float power, float temperature);
+
+/**
+ * @brief Heating gain that explains an observed slope
+ *
+ * @param slope Observed slope (°C/s)
+ * @param power Mean heater command (%), must be positive
+ * @param temperature Mean chamber temperature (°C)
+ * @return float - Slope at full power from ambient (°C/s)
+ */
+float ChamberModel_solveGain(float slope, float power, float temperature);
+
+#endif /* INC_CHAMBER_MODEL_H_ */
@@ -0,0 +1,108 @@
+/*
+ * control_isr.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Control step in interrupt context (REFLOW_CONTROL_IN_ISR).
+ *              The TIM3 timebase pends PendSV on the control release and
+ *              the PendSV handler runs sample -> ReflowOven_operate ->
+ *              actuators to completion, so the loop latency no longer
+ *              depends on how long the GUI or telemetry keep the background
+ *              loop busy. PendSV sits at the lowest priority: every hardware
+ *              interrupt, SysTick included (moved one level up), preempts
+ *              the control step, and the step preempts the background loop.
+ *
+ *              Background code that changes the process state the control
+ *              step works on (start, stop, batch hand-off, calibration)
+ *              brackets it with ControlIsr_lock()/ControlIsr_unlock(), which
+ *              holds the control step back through BASEPRI. In the RTOS
+ *              build the same calls suspend the kernel scheduler, which
+ *              keeps the control task out instead; in the cooperative build
+ *              nothing preempts the caller and they do nothing.
+ */
+
+#ifndef INC_CONTROL_ISR_H_
+#define INC_CONTROL_ISR_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "main.h"
+#include <stdint.h>
+#if REFLOW_USE_RTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define CONTROLISR_PRIORITY   15u /* PendSV: below every interrupt */
+#define CONTROLISR_TICK_PRIO  14u /* SysTick: keeps HAL_GetTick running inside the control step */
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Set the PendSV and SysTick priorities of the control step
+ */
+static inline void ControlIsr_Init(void)
+{
+#if REFLOW_CONTROL_IN_ISR
+    HAL_NVIC_SetPriority(SysTick_IRQn, CONTROLISR_TICK_PRIO, 0);
+    HAL_NVIC_SetPriority(PendSV_IRQn, CONTROLISR_PRIORITY, 0);
+#endif
+}
+
+/**
+ * @brief Release the control step; it runs once no other interrupt is active
+ */
+static inline void ControlIsr_trigger(void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+/**
+ * @brief Hold the control step back while the caller changes process state
+ *
+ * @return uint32_t - State to hand to ControlIsr_unlock (calls nest)
+ */
+static inline uint32_t ControlIsr_lock(void)
+{
+#if REFLOW_CONTROL_IN_ISR
+    uint32_t basepri = __get_BASEPRI();
+
+    __set_BASEPRI_MAX(CONTROLISR_PRIORITY << (8u - __NVIC_PRIO_BITS));
+    return basepri;
+#elif REFLOW_USE_RTOS
+    if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        vTaskSuspendAll();
+        return 1u;
+    }
+    return 0u;
+#else
+    return 0u;
+#endif
+}
+
+/**
+ * @brief Let the control step run again; a release held back runs now
+ *
+ * @param state Value returned by the matching ControlIsr_lock
+ */
+static inline void ControlIsr_unlock(uint32_t state)
+{
+#if REFLOW_CONTROL_IN_ISR
+    __set_BASEPRI(state);
+#elif REFLOW_USE_RTOS
+    if (state != 0u) {
+        (void)xTaskResumeAll();
+    }
+#else
+    (void)state;
+#endif
+}
+
+#endif /* INC_CONTROL_ISR_H_ */
@@ -0,0 +1,126 @@
+/*
+ * control_timing.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Control-loop timing monitor. Each control cycle is stamped
+ *              with the DWT cycle counter at three points:
+ *              - release: the timebase interrupt that requests the sample
+ *                (TIM3 through the scheduler, or the acquisition task wake
+ *                in the RTOS build)
+ *              - start: entry of the control step
+ *              - end: actuators written
+ *
+ *              From these it keeps:
+ *              - period jitter: start -> start interval minus the nominal
+ *                period (min, max, RMS)
+ *              - release latency: release -> start (min, max; their spread
+ *                is the release jitter)
+ *              - response time: release -> end, checked against the deadline
+ *              - missed periods: a release that arrives while the previous
+ *                cycle has not ended yet
+ *
+ *              Missed periods and deadline overruns in a row trip the
+ *              monitor once they reach the configured limit; the caller
+ *              forces the safe state. A cycle that does not end at all is
+ *              left to the watchdog.
+ */
+
+#ifndef INC_CONTROL_TIMING_H_
+#define INC_CONTROL_TIMING_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define CONTROLTIMING_DEADLINE_US 50000u /* Default release -> end budget (us) */
+#define CONTROLTIMING_MAX_MISSES  4u     /* Default misses/overruns in a row that trip the monitor (1 s at 4 Hz) */
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Timing of the control cycles
+ *
+ * Jitter, latency and response cover the cycles since the last
+ * ControlTiming_reset(); missed and overruns count from the initialisation.
+ */
+typedef struct {
+    uint32_t intervals;       /* Measured start -> start intervals */
+    float minDeviationUs;     /* Shortest interval minus the period (us, negative when early) */
+    float maxDeviationUs;     /* Longest interval minus the period (us) */
+    float rmsDeviationUs;     /* RMS of the deviation (us) */
+    float minLatencyUs;       /* Shortest release -> start (us) */
+    float maxLatencyUs;       /* Longest release -> start (us) */
+    float maxResponseUs;      /* Longest release -> end (us) */
+    uint32_t missed;          /* Releases that found the previous cycle still running */
+    uint32_t overruns;        /* Cycles that ended after the deadline */
+} ControlTiming_stats_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Set the nominal period, restore the default limits and clear everything
+ *
+ * @param periodUs Nominal control period (us)
+ * @param cyclesPerUs Cycle counter rate (core clock in MHz)
+ */
+void ControlTiming_Init(uint32_t periodUs, uint32_t cyclesPerUs);
+
+/**
+ * @brief Set the deadline and the trip limit
+ *
+ * @param deadlineUs Release -> end budget (us)
+ * @param maxMisses Misses/overruns in a row that trip the monitor (0 disables the trip)
+ */
+void ControlTiming_setLimits(uint32_t deadlineUs, uint8_t maxMisses);
+
+/**
+ * @brief Stamp the release of a control cycle (timebase ISR)
+ *
+ * @param cycles Cycle counter stamp (DWT_getCycles)
+ */
+void ControlTiming_release(uint32_t cycles);
+
+/**
+ * @brief Stamp the start of the control step
+ *
+ * @param cycles Cycle counter stamp (DWT_getCycles)
+ */
+void ControlTiming_start(uint32_t cycles);
+
+/**
+ * @brief Stamp the end of the control cycle (actuators written)
+ *
+ * @param cycles Cycle counter stamp (DWT_getCycles)
+ */
+void ControlTiming_end(uint32_t cycles);
+
+/**
+ * @brief Whether the misses/overruns in a row reached the limit
+ *
+ * @return bool - True until a cycle ends in time again
+ */
+bool ControlTiming_isTripped(void);
+
+/**
+ * @brief Timing since the last reset
+ *
+ * @param stats Filled with the statistics
+ */
+void ControlTiming_get(ControlTiming_stats_t *stats);
+
+/**
+ * @brief Clear the jitter, latency and response figures; the next start only sets the reference stamp
+ */
+void ControlTiming_reset(void);
+
+#endif /* INC_CONTROL_TIMING_H_ */
@@ -0,0 +1,83 @@
+/*
+ * cooling.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Closed-loop forced cooling for REFLOW_COOLDOWN. A second,
+ *              reverse acting PID drives a cooling demand (0..100 %) that is
+ *              split over two actuators on TIM4: the fan takes the first half
+ *              of the range and the door servo opens over the second half.
+ *              Split-range with the heater: the cooling loop only runs while
+ *              every heater output is saturated at zero, and it is reset as
+ *              soon as any heater turns on again, so both never fight.
+ */
+
+#ifndef INC_COOLING_H_
+#define INC_COOLING_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "pid.h"
+#include "reflow_oven_process.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define COOLING_FAN_SPLIT     50.0f  /* Demand (%) at which the fan is at 100 % and the door starts opening */
+
+/* TIM4 outputs: 1 MHz counter, 20 ms period (standard hobby servo frame) */
+#define COOLING_PWM_PERIOD_US 20000u /* Fan PWM and servo frame period (µs) */
+#define COOLING_DOOR_CLOSED_US 1000u /* Servo pulse with the door closed (µs) */
+#define COOLING_DOOR_OPEN_US   2000u /* Servo pulse with the door fully open (µs) */
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Initialize the cooling controller, fan off and door closed
+ *
+ * @param samplePeriod Period of the control tick calling Cooling_update() (s)
+ */
+void Cooling_Init(float samplePeriod);
+
+/**
+ * @brief Run the cooling controller for one control tick
+ *
+ * Active in REFLOW_COOLDOWN while the heaters are off; the controller tracks
+ * the cooldown setpoint ramp, i.e. the requested cooling rate.
+ *
+ * @param phase Current reflow phase
+ * @param setpoint Current temperature setpoint (°C)
+ * @param temperature Measured chamber temperature (°C)
+ * @param heaterOff True when every heater output is zero in this tick
+ * @return float - Cooling demand (0..100 %)
+ */
+float Cooling_update(ReflowPhases_t phase, float setpoint, float temperature, bool heaterOff);
+
+/**
+ * @brief Fan duty for the last cooling demand
+ *
+ * @return float - Fan duty (0..100 %)
+ */
+float Cooling_getFanDuty(void);
+
+/**
+ * @brief Door opening for the last cooling demand
+ *
+ * @return float - Door opening (0 = closed .. 100 % = fully open)
+ */
+float Cooling_getDoorOpening(void);
+
+/**
+ * @brief Cooling controller, exposed for tuning
+ *
+ * @return PIDController* - Reverse acting cooling PID (output in %)
+ */
+PIDController *Cooling_getController(void);
+
+#endif /* INC_COOLING_H_ */
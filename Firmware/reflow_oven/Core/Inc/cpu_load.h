@@ -0,0 +1,81 @@
+/*
+ * cpu_load.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: CPU load from the time the core spends asleep. The idle path
+ *              (the scheduler loop, or the FreeRTOS tickless idle) stamps
+ *              the DWT cycle counter around its WFI; over a report window
+ *
+ *                  awake = CYCCNT advance - cycles stamped asleep
+ *                  load  = awake / window length
+ *
+ *              with the window length taken from the millisecond time base.
+ *              This holds whether or not CYCCNT keeps counting while the
+ *              core clock is gated: if it stops, the stamps around the WFI
+ *              are (almost) equal and the advance is the awake time alone.
+ *              Interrupt handlers count as load.
+ */
+
+#ifndef INC_CPU_LOAD_H_
+#define INC_CPU_LOAD_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Load over the last closed window
+ */
+typedef struct {
+    uint32_t windowMs;   /* Window length (ms) */
+    float loadPct;       /* Time awake (%) */
+    float idlePct;       /* Time asleep (%) */
+    uint32_t wakeups;    /* WFI exits in the window */
+} CpuLoad_stats_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Open the first window
+ *
+ * @param nowMs Current time (ms)
+ * @param cyclesPerMs Core clock cycles per millisecond
+ */
+void CpuLoad_Init(uint32_t nowMs, uint32_t cyclesPerMs);
+
+/**
+ * @brief Sleep until the next interrupt and account for it
+ *
+ * Call with interrupts masked (PRIMASK) after checking that there is no
+ * work: a pending interrupt still ends the WFI, and it is taken once the
+ * caller unmasks.
+ */
+void CpuLoad_sleep(void);
+
+/**
+ * @brief Stamp the start of a sleep entered by someone else (kernel idle)
+ */
+void CpuLoad_sleepBegin(void);
+
+/**
+ * @brief Stamp the end of the sleep started by CpuLoad_sleepBegin
+ */
+void CpuLoad_sleepEnd(void);
+
+/**
+ * @brief Close the window and open the next one
+ *
+ * @param nowMs Current time (ms)
+ * @param stats Load over the closed window
+ */
+void CpuLoad_update(uint32_t nowMs, CpuLoad_stats_t *stats);
+
+#endif /* INC_CPU_LOAD_H_ */
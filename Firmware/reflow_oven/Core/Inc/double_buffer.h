@@ -0,0 +1,83 @@
+/*
+ * double_buffer.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Latest-value handoff between one writer and one reader that
+ *              preempts it (background -> control interrupt, GUI task ->
+ *              control task). The writer fills the back slot and publishes it
+ *              by flipping the front index; the reader copies the front slot
+ *              whenever the sequence moved since its last copy. Since the
+ *              writer never runs in the middle of a read, the front slot is
+ *              stable while it is copied and neither side masks interrupts.
+ *
+ *              The reader only ever sees whole values: a half-written update
+ *              stays in the back slot until it is published. Values
+ *              published faster than the reader runs are overwritten, only
+ *              the newest one is delivered.
+ */
+
+#ifndef INC_DOUBLE_BUFFER_H_
+#define INC_DOUBLE_BUFFER_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Handoff state; the two slots are supplied by the owner
+ */
+typedef struct {
+    void *slots[2];
+    size_t size;                  /* Bytes per slot */
+    volatile uint8_t front;       /* Slot the reader copies, writer only */
+    volatile uint32_t sequence;   /* Bumped by every publish, writer only */
+} DoubleBuffer_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Bind the storage; both slots start with the content of the first one
+ *
+ * @param buffer Handoff to initialise
+ * @param slotA First slot, holds the initial value
+ * @param slotB Second slot, same size
+ * @param size Bytes per slot
+ */
+void DoubleBuffer_Init(DoubleBuffer_t *buffer, void *slotA, void *slotB, size_t size);
+
+/**
+ * @brief Slot the writer may fill (writer side)
+ *
+ * @param buffer Handoff
+ * @return void* - Back slot, invisible to the reader until published
+ */
+void *DoubleBuffer_back(DoubleBuffer_t *buffer);
+
+/**
+ * @brief Make the back slot the new value (writer side)
+ *
+ * @param buffer Handoff
+ */
+void DoubleBuffer_publish(DoubleBuffer_t *buffer);
+
+/**
+ * @brief Copy the latest value out if it is new to this reader (reader side)
+ *
+ * @param buffer Handoff
+ * @param value Destination, size bytes
+ * @param seen Sequence of the reader's last copy, updated on a copy
+ * @return bool - True when a newer value was copied
+ */
+bool DoubleBuffer_read(DoubleBuffer_t *buffer, void *value, uint32_t *seen);
+
+#endif /* INC_DOUBLE_BUFFER_H_ */
@@ -0,0 +1,56 @@
+/*
+ * dwt.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Cortex-M4 DWT cycle counter helpers. CYCCNT runs at the core
+ *              clock (100 MHz, 10 ns per count) and wraps every ~43 s, so
+ *              differences of two readings are valid up to that span.
+ */
+
+#ifndef INC_DWT_H_
+#define INC_DWT_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "main.h"
+#include <stdint.h>
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Enable the trace block and start the cycle counter
+ */
+static inline void DWT_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Read the cycle counter
+ *
+ * @return uint32_t - Core clock cycles since DWT_Init (wrapping)
+ */
+static inline uint32_t DWT_getCycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Convert a cycle count to microseconds
+ *
+ * @param cycles Cycle count (e.g. difference of two DWT_getCycles readings)
+ * @return float - Time in microseconds
+ */
+static inline float DWT_cyclesToUs(uint32_t cycles)
+{
+    return cycles * (1.0e6f / SystemCoreClock);
+}
+
+#endif /* INC_DWT_H_ */
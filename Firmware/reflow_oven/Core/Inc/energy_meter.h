@@ -0,0 +1,84 @@
+/*
+ * energy_meter.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Heater energy metering from the delivered half-cycles. The
+ *              zero-cross interrupt counts the half-cycles fired on every
+ *              channel (one increment per channel, nothing else), and the
+ *              control tick turns the counts of the last tick into energy
+ *              with the rated power of each element and the measured number
+ *              of half-cycles per second. The per-tick energy feeds the run
+ *              recorder, which integrates it per phase and per run.
+ */
+
+#ifndef INC_ENERGY_METER_H_
+#define INC_ENERGY_METER_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define ENERGY_MAX_CHANNELS 4u /* One per TIM1 channel */
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Clear every counter and the rated powers
+ */
+void EnergyMeter_Init(void);
+
+/**
+ * @brief Set the rated power of the element on a channel
+ *
+ * @param channel Modulator channel (heater zone)
+ * @param watts Element power at nominal line voltage (W)
+ */
+void EnergyMeter_setChannelPower(uint8_t channel, float watts);
+
+/**
+ * @brief Count the half-cycles fired at a zero cross, to be called from the zero-cross interrupt
+ *
+ * @param firedMask Bit per channel, set if the channel conducts this half-cycle
+ */
+void EnergyMeter_onHalfCycle(uint8_t firedMask);
+
+/**
+ * @brief Convert the half-cycles fired since the last call into energy, once per control tick
+ *
+ * @param halfCyclesPerSecond Measured half-cycles per second (twice the line frequency)
+ * @return float - Energy delivered since the previous call (Wh)
+ */
+float EnergyMeter_update(float halfCyclesPerSecond);
+
+/**
+ * @brief Energy delivered in the last control tick
+ *
+ * @return float - Energy (Wh)
+ */
+float EnergyMeter_getTickEnergyWh(void);
+
+/**
+ * @brief Energy delivered since power-up
+ *
+ * @return float - Energy (Wh)
+ */
+float EnergyMeter_getTotalEnergyWh(void);
+
+/**
+ * @brief Half-cycles fired on a channel since power-up
+ *
+ * @param channel Modulator channel
+ * @return uint32_t - Half-cycle count (wraps after ~1 year at 120 Hz)
+ */
+uint32_t EnergyMeter_getHalfCycles(uint8_t channel);
+
+#endif /* INC_ENERGY_METER_H_ */
@@ -0,0 +1,120 @@
+/*
+ * event_queue.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Lock-free single-producer / single-consumer ring of
+ *              timestamped events, for handing events from an ISR to the
+ *              task that consumes them. The producer only writes the head
+ *              and the consumer only writes the tail, so neither side masks
+ *              interrupts; a release fence orders the slot write before the
+ *              index update. One slot is kept free to tell full from empty.
+ *
+ *              Each queue has exactly one producer and one consumer. A push
+ *              into a full queue is refused and counted, so a lost event is
+ *              always visible in the overflow counter, and the high-water
+ *              mark shows how close a queue came to overflowing.
+ */
+
+#ifndef INC_EVENT_QUEUE_H_
+#define INC_EVENT_QUEUE_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Event kinds carried by the queues
+ */
+typedef enum {
+    EVENT_BUTTON_PRESS,   /* Encoder push button falling edge */
+    EVENT_MAINS_LOST,     /* No zero cross for a timer period; value = zero crosses since the line came back */
+    EVENT_MAINS_RESTORED, /* First valid zero cross after a loss */
+    EVENT_UART_RX,        /* Command byte received; value = the byte */
+} EventQueue_type_t;
+
+/**
+ * @brief One event
+ */
+typedef struct {
+    uint32_t cycles;      /* DWT stamp taken by the producer */
+    int32_t value;        /* Payload, meaning depends on the type */
+    uint8_t type;         /* EventQueue_type_t */
+} EventQueue_event_t;
+
+/**
+ * @brief Queue state; storage is supplied by the owner
+ */
+typedef struct {
+    EventQueue_event_t *slots;
+    uint16_t mask;                /* Slot count - 1 (power of two) */
+    volatile uint16_t head;       /* Next slot to write, producer only */
+    volatile uint16_t tail;       /* Next slot to read, consumer only */
+    volatile uint32_t overflows;  /* Pushes refused because the queue was full */
+    volatile uint16_t highWater;  /* Most events ever waiting at once */
+} EventQueue_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Bind the storage and empty the queue
+ *
+ * @param queue Queue to initialise
+ * @param slots Event storage
+ * @param length Slot count, power of two (holds length - 1 events)
+ */
+void EventQueue_Init(EventQueue_t *queue, EventQueue_event_t *slots, uint16_t length);
+
+/**
+ * @brief Append an event (producer side, ISR safe)
+ *
+ * @param queue Queue
+ * @param type Event kind
+ * @param value Payload
+ * @param cycles DWT stamp of the event
+ * @return bool - False when the queue was full (the event is counted as an overflow)
+ */
+bool EventQueue_push(EventQueue_t *queue, EventQueue_type_t type, int32_t value, uint32_t cycles);
+
+/**
+ * @brief Take the oldest event (consumer side)
+ *
+ * @param queue Queue
+ * @param event Filled with the event
+ * @return bool - False when the queue was empty
+ */
+bool EventQueue_pop(EventQueue_t *queue, EventQueue_event_t *event);
+
+/**
+ * @brief Events waiting
+ *
+ * @param queue Queue
+ * @return uint16_t - Event count
+ */
+uint16_t EventQueue_getCount(const EventQueue_t *queue);
+
+/**
+ * @brief Events lost to a full queue since the initialisation
+ *
+ * @param queue Queue
+ * @return uint32_t - Overflow count
+ */
+uint32_t EventQueue_getOverflows(const EventQueue_t *queue);
+
+/**
+ * @brief Most events ever waiting at once
+ *
+ * @param queue Queue
+ * @return uint16_t - High-water mark
+ */
+uint16_t EventQueue_getHighWater(const EventQueue_t *queue);
+
+#endif /* INC_EVENT_QUEUE_H_ */
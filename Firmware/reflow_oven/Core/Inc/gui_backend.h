@@ -19,19 +19,24 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "pid.h"
+#include "event_queue.h"
 
 /******************************************************************************
  * EXTERNAL REFERENCES
  *****************************************************************************/
 /* PID's data type instance */
 extern PIDController PID;
+/* Fused chamber temperature (°C), sampled by the control loop */
+extern float chamber_temp;
 /* Microcontroller's hardware related to rotary encoder for user's interaction with GUI */
 extern TIM_HandleTypeDef htim2; // Encoder
-extern TIM_HandleTypeDef htim3; // Periodic sample of sensors
+extern TIM_HandleTypeDef htim3; // Scheduler timebase (1 kHz)
 
 /******************************************************************************
  * USER INPUT DEFINITIONS
  *****************************************************************************/
+#define ENCODER_DEBOUNCE_US 50000u /* Presses closer than this to the last accepted one are contact bounce */
+
 /**
  * @brief  Encoder event types
  */
@@ -51,8 +56,9 @@ typedef enum
  */
 typedef struct
 {
-    encoder_event_t ev;  /* Current event type */
-    uint8_t isr_reg;     /* Bit 0 is pulse_flag */
+    encoder_event_t ev;     /* Current event type */
+    EventQueue_t *events;   /* Button presses from the EXTI ISR */
+    uint32_t press_cycles;  /* DWT stamp of the last accepted press */
     uint8_t prev_cnt;    /* Previous counter value */
     uint8_t current_cnt; /* Current counter value */
     uint8_t prev_dir;    /* Previous direction */
@@ -70,6 +76,7 @@ typedef enum
     MAIN_PAGE,          /* Display graph and running parameters */
     OVEN_SETTINGS_PAGE, /* Configure reflow oven parameters */
     PID_SETTINGS_PAGE,  /* Configure PID controller parameters */
+    DIAGNOSTICS_PAGE,   /* Control loop timing and its safety limits */
     NUM_STATES          /* Total number of UI pages */
 } ui_pages_t;
 
@@ -78,11 +85,15 @@ typedef enum
  */
 typedef enum
 {
-    START_BTN,         /* Starts reflow process */
-    STOP_BTN,          /* Stops reflow process */
-    OVEN_SETTINGS_BTN, /* Navigate to oven settings page */
-    PID_SETTINGS_BTN,  /* Navigate to PID settings page */
-    NUM_MAIN_PAGE_BTN  /* Total number of main page elements */
+    START_BTN,           /* Starts reflow process (confirms the next board in batch mode) */
+    STOP_BTN,            /* Stops reflow process (aborts the batch) */
+    OVEN_SETTINGS_BTN,   /* Navigate to oven settings page */
+    PID_SETTINGS_BTN,    /* Navigate to PID settings page */
+    BATCH_SIZE_BOX,      /* Boards in the next batch */
+    BATCH_BTN,           /* Starts a batch of the current profile */
+    BOARDS_PER_HOUR_BOX, /* Batch throughput (display only) */
+    DIAGNOSTICS_BTN,     /* Navigate to diagnostics page */
+    NUM_MAIN_PAGE_BTN    /* Total number of main page elements */
 } ui_main_page_boxes_t;
 
 /**
@@ -108,11 +119,28 @@ typedef enum
 {
     PID_KP_BOX,     /* Proportional gain */
     PID_KI_BOX,     /* Integral gain */
-    PID_KD_BOX,     /* Derivative gain */
-    PID_RETURN_BTN, /* Return to main page */
-    NUM_PID_BOXES   /* Total number of PID settings elements */
+    PID_KD_BOX,        /* Derivative gain */
+    PID_CALIBRATE_BTN, /* Starts/aborts the heater power calibration */
+    PID_RETURN_BTN,    /* Return to main page */
+    NUM_PID_BOXES      /* Total number of PID settings elements */
 } ui_pid_settings_page_boxes_t;
 
+/**
+ * @brief  Diagnostics page elements
+ */
+typedef enum
+{
+    DIAG_JITTER_BOX,     /* Worst control period deviation (ms, display only) */
+    DIAG_LATENCY_BOX,    /* Worst release -> start of the control step (ms, display only) */
+    DIAG_RESPONSE_BOX,   /* Worst release -> actuators written (ms, display only) */
+    DIAG_MISSED_BOX,     /* Missed control periods since boot (display only) */
+    DIAG_OVERRUNS_BOX,   /* Control cycles past the deadline since boot (display only) */
+    DIAG_DEADLINE_BOX,   /* Control cycle deadline (ms) */
+    DIAG_MISS_LIMIT_BOX, /* Misses/overruns in a row that force the safe state (0 = off) */
+    DIAG_RETURN_BTN,     /* Return to main page */
+    NUM_DIAG_BOXES       /* Total number of diagnostics elements */
+} ui_diagnostics_page_boxes_t;
+
 /******************************************************************************
  * UI ELEMENT STRUCTURES
  *****************************************************************************/
@@ -182,6 +210,7 @@ typedef void (*state_handler_t)(state_machine_t *, encoder_event_t);
 void main_page_handler(state_machine_t *sm, encoder_event_t ev);
 void oven_settings_page_handler(state_machine_t *sm, encoder_event_t ev);
 void pid_settings_page_handler(state_machine_t *sm, encoder_event_t ev);
+void diagnostics_page_handler(state_machine_t *sm, encoder_event_t ev);
 
 /******************************************************************************
  * EXTERNAL FUNCTION DECLARATIONS
@@ -239,4 +268,13 @@ float GUI_GetValue(ui_pages_t page, uint8_t element_idx);
  */
 void GUI_DrawPage(ui_pages_t page);
 
+/**
+ * @brief  Fetch the PID gains edited on the PID settings page
+ * @note   Control side of a double-buffered handoff: call only from the
+ *         control step, which takes the gains at a tick boundary
+ * @param  gains: Destination for the latest published gains
+ * @retval True when the gains changed since the previous call
+ */
+bool GUI_GetPidGains(PIDGains *gains);
+
 #endif /* INC_GUI_BACKEND_H_ */
@@ -0,0 +1,89 @@
+/*
+ * halfcycle_modulator.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: First-order sigma-delta modulator for the zero-cross SSR
+ *              outputs. The control loop sets a level in percent of full
+ *              power, and every zero-cross interrupt decides whether the next
+ *              half-cycle is ON. The ON half-cycles come out evenly spread
+ *              (Bresenham distribution) instead of a single burst, and any
+ *              fraction left over carries into the next decision. Working per
+ *              half-cycle keeps the delivered power independent of the mains
+ *              frequency (100 or 120 half-cycles per second).
+ *
+ *              All channels are scheduled together. By default every channel
+ *              may conduct in the same half-cycle, so each level is a
+ *              fraction of that element's full power. A board whose supply
+ *              cannot carry every element at once (breaker, inrush) caps
+ *              them with HalfCycle_setMaxConcurrent(). When more channels
+ *              are due than allowed, the ones owed the most energy fire and
+ *              the rest keep their debt for the next half-cycle, so every
+ *              channel still gets its average duty as long as the sum of the
+ *              levels fits under the limit; above it the channels share the
+ *              allowed conduction and the peak power drops. The accumulators
+ *              start staggered, so channels at equal levels do not line up
+ *              on the same edges.
+ */
+
+#ifndef INC_HALFCYCLE_MODULATOR_H_
+#define INC_HALFCYCLE_MODULATOR_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define HALFCYCLE_MAX_CHANNELS 4u         /* One per TIM1 channel */
+#define HALFCYCLE_ONE          0x10000u   /* Q16 unit: one full half-cycle of energy */
+#define HALFCYCLE_MAX_DEBT     (4u * HALFCYCLE_ONE) /* Deferred energy kept when the limit is oversubscribed */
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Reset every channel: level 0 and empty accumulator, no concurrency limit
+ */
+void HalfCycle_Init(void);
+
+/**
+ * @brief Set the output level of a channel
+ *
+ * Safe to call from the control loop while the zero-cross interrupt runs:
+ * the level is a single word.
+ *
+ * @param channel Modulator channel (heater zone)
+ * @param power Fraction of ON half-cycles, 0..100 (% of full power)
+ */
+void HalfCycle_setLevel(uint8_t channel, float power);
+
+/**
+ * @brief Set how many channels may conduct in the same half-cycle
+ *
+ * Levels above the limit's share are no longer delivered in full: only use
+ * it when the supply requires it.
+ *
+ * @param maxConcurrent 1..HALFCYCLE_MAX_CHANNELS (HALFCYCLE_MAX_CHANNELS = no limit)
+ */
+void HalfCycle_setMaxConcurrent(uint8_t maxConcurrent);
+
+/**
+ * @brief Decide the next half-cycle of every channel, to be called once per zero cross
+ *
+ * @param numChannels Channels in use (0..HALFCYCLE_MAX_CHANNELS)
+ * @return uint8_t - Bit per channel, set if its next half-cycle is ON
+ */
+uint8_t HalfCycle_step(uint8_t numChannels);
+
+/**
+ * @brief Drop the accumulated error of every channel (mains loss, emergency)
+ */
+void HalfCycle_flush(void);
+
+#endif /* INC_HALFCYCLE_MODULATOR_H_ */
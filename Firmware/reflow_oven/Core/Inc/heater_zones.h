@@ -0,0 +1,91 @@
+/*
+ * heater_zones.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Multi-zone heater control. Every zone owns a zero-cross SSR
+ *              channel on TIM1, a PID controller with its own limits and the
+ *              set of thermocouples that measure it. All zones follow the
+ *              profile setpoint and are updated in one pass per control tick.
+ */
+
+#ifndef INC_HEATER_ZONES_H_
+#define INC_HEATER_ZONES_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "pid.h"
+#include "reflow_oven_process.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define HEATER_MAX_ZONES  REFLOW_MAX_ZONES /* TIM1 CH1..CH4 */
+#define HEATER_NUM_PROBES 4u               /* MAX6675 readings handed to the update (probeMask bits 0..3) */
+
+/**
+ * @brief Static configuration of a heater zone
+ */
+typedef struct {
+    uint32_t channel;  /* TIM1 channel driving the zone's SSR (TIM_CHANNEL_x) */
+    uint8_t probeMask; /* Thermocouples (bit per MAX6675 id) measuring the zone */
+    float limMax;      /* Maximum output (% of full power) */
+    float gainScale;   /* Zone gains relative to the master PID gains */
+    float ratedPower;  /* Element power at nominal line voltage (W), for energy metering */
+} HeaterZone_config_t;
+
+/**
+ * @brief Runtime state of a heater zone
+ */
+typedef struct {
+    HeaterZone_config_t config;
+    PIDController pid; /* Zone controller, output in % of full power */
+    float temperature; /* Zone temperature used in the last update (°C) */
+    float power;       /* Output commanded in the last update (% of full power) */
+} HeaterZone_t;
+
+/******************************************************************************
+ * EXTERNAL VARIABLES
+ ******************************************************************************/
+extern HeaterZone_t HeaterZones[HEATER_MAX_ZONES];
+extern uint8_t HeaterZones_count;
+extern uint8_t HeaterZones_maxConcurrent; /* Elements the board lets conduct together (HeaterZones_count = no limit) */
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Initialize the zones from the board configuration
+ *
+ * @param master PID whose configuration seeds every zone controller
+ */
+void HeaterZones_Init(const PIDController *master);
+
+/**
+ * @brief Run every zone controller for one control tick
+ *
+ * Gains follow the master PID (so edits from the GUI apply to every zone),
+ * the output limit follows the profile's zone balance for the current phase
+ * (the preheat one in standby) and is zero while idle.
+ *
+ * @param master Master PID (gains source)
+ * @param probeTemperature Temperature of each MAX6675 (°C), HEATER_NUM_PROBES entries
+ * @param healthyProbes Bitmask of probes with a valid reading
+ * @param chamberTemperature Fused chamber temperature, used when a zone has no healthy probe
+ */
+void HeaterZones_update(const PIDController *master, const float *probeTemperature,
+                        uint8_t healthyProbes, float chamberTemperature);
+
+/**
+ * @brief Spread between the hottest and coldest zone in the last update
+ *
+ * @return float - Temperature difference (°C), 0 with a single zone
+ */
+float HeaterZones_getSpread(void);
+
+#endif /* INC_HEATER_ZONES_H_ */
@@ -41,7 +41,19 @@ extern "C" {
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
-
+/* Build flavour: 0 = cooperative scheduler on TIM3 (Debug, Release),
+ * 1 = FreeRTOS tasks (Debug_RTOS, see app_rtos.h) */
+#ifndef REFLOW_USE_RTOS
+#define REFLOW_USE_RTOS 0
+#endif
+/* Control step: 0 = scheduler task in the background loop, 1 = PendSV
+ * chained from the TIM3 release (see control_isr.h); cooperative build only */
+#ifndef REFLOW_CONTROL_IN_ISR
+#define REFLOW_CONTROL_IN_ISR 0
+#endif
+#if REFLOW_USE_RTOS && REFLOW_CONTROL_IN_ISR
+#error "REFLOW_CONTROL_IN_ISR needs the cooperative build: PendSV belongs to the kernel"
+#endif
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
@@ -55,6 +67,7 @@ void HAL_TIM_MspPostInit(TIM_HandleTypeDef *htim);
 void Error_Handler(void);
 
 /* USER CODE BEGIN EFP */
+void control_step_isr(void);
 
 /* USER CODE END EFP */
 
@@ -78,6 +91,12 @@ void Error_Handler(void);
 #define CS_3_GPIO_Port GPIOB
 #define fire_Pin GPIO_PIN_8
 #define fire_GPIO_Port GPIOA
+#define fire_top_Pin GPIO_PIN_11
+#define fire_top_GPIO_Port GPIOA
+#define fan_Pin GPIO_PIN_8
+#define fan_GPIO_Port GPIOB
+#define door_Pin GPIO_PIN_9
+#define door_GPIO_Port GPIOB
 #define zc_crossing_Pin GPIO_PIN_12
 #define zc_crossing_GPIO_Port GPIOA
 
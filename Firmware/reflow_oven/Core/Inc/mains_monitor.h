@@ -0,0 +1,100 @@
+/*
+ * mains_monitor.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Mains frequency detection from the zero-cross input. The
+ *              zero-cross interrupt timestamps every crossing with the core
+ *              cycle counter; crossings are accumulated in blocks and each
+ *              block publishes the measured line frequency, the period jitter
+ *              and the nominal grid (50 or 60 Hz). The nominal value only
+ *              changes after MAINS_CONFIRM_BLOCKS blocks agree, so a single
+ *              noisy block cannot retime the heater outputs.
+ */
+
+#ifndef INC_MAINS_MONITOR_H_
+#define INC_MAINS_MONITOR_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define MAINS_BLOCK_HALFCYCLES 20u    /* Crossings averaged per published measurement (~0.2 s) */
+#define MAINS_CONFIRM_BLOCKS   2u     /* Agreeing blocks needed to change the nominal frequency */
+#define MAINS_MIN_PERIOD_US    5000u  /* Shorter gaps are contact bounce / noise (100 Hz line) */
+#define MAINS_MAX_PERIOD_US    40000u /* Longer gaps restart the measurement (missed crossings) */
+#define MAINS_SPLIT_HZ         55.0f  /* Boundary between a 50 Hz and a 60 Hz grid */
+#define MAINS_DEFAULT_HZ       60u    /* Assumed until the first block is measured */
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Reset the monitor: no mains, nominal frequency MAINS_DEFAULT_HZ
+ *
+ * @param cpuHz Frequency of the timestamp counter (SystemCoreClock for DWT->CYCCNT)
+ */
+void Mains_Init(uint32_t cpuHz);
+
+/**
+ * @brief Record a zero crossing, to be called from the zero-cross interrupt
+ *
+ * @param cycles Timestamp of the crossing (free running cycle counter)
+ */
+void Mains_onZeroCross(uint32_t cycles);
+
+/**
+ * @brief Report that the expected crossing did not come (mains loss)
+ */
+void Mains_onLoss(void);
+
+/**
+ * @brief Mains present, i.e. crossings are arriving in the valid period range
+ *
+ * @return bool - True while crossings arrive
+ */
+bool Mains_isPresent(void);
+
+/**
+ * @brief At least one full block has been measured since Mains_Init
+ *
+ * @return bool - True once the nominal frequency comes from a measurement
+ */
+bool Mains_isLocked(void);
+
+/**
+ * @brief Measured line frequency of the last block
+ *
+ * @return float - Line frequency (Hz), 0 before the first block
+ */
+float Mains_getFrequency(void);
+
+/**
+ * @brief Nominal grid frequency
+ *
+ * @return uint8_t - 50 or 60 (Hz)
+ */
+uint8_t Mains_getNominalHz(void);
+
+/**
+ * @brief Heater half-cycles per second on the nominal grid
+ *
+ * @return uint8_t - 100 or 120
+ */
+uint8_t Mains_getHalfCyclesPerSecond(void);
+
+/**
+ * @brief Zero-cross jitter of the last block, half the spread of the half-cycle periods
+ *
+ * @return float - Jitter (µs)
+ */
+float Mains_getJitterUs(void);
+
+#endif /* INC_MAINS_MONITOR_H_ */
@@ -26,6 +26,13 @@
  */
 #define MAX6675_MAX_DEVICES 4
 
+/**
+ * @brief Conversion time (ms, datasheet maximum)
+ * @note  A conversion starts when CS is released; reading the device
+ *        before it completes aborts it and returns the previous result
+ */
+#define MAX6675_CONVERSION_MS 220
+
 /* MAX6675 Chip Select Pin Definitions --------------------------------------*/
 /**
  * @brief Array of GPIO ports for all CS pins (do not use directly)
@@ -104,6 +111,9 @@ HAL_StatusTypeDef MAX6675_Init(MAX6675_Driver_t *driver, SPI_HandleTypeDef *hspi
 
 /**
  * @brief   Add a new MAX6675 device to the driver
+ * @note    No SPI transfer: the device counts as disconnected until its
+ *          first MAX6675_ReadTemperature, which should come at least
+ *          MAX6675_CONVERSION_MS after MAX6675_Init released the CS pins
  * @param   driver      Pointer to driver control structure
  * @param   device_id   Device ID (0-3) corresponding to CS pin index
  * @return  HAL_StatusTypeDef   HAL status (HAL_OK, HAL_ERROR)
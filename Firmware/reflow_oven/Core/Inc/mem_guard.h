@@ -0,0 +1,87 @@
+/*
+ * mem_guard.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: RAM budget at runtime. Everything the firmware owns is
+ *              static (.data/.bss); the newlib heap grows up from _end and
+ *              the main stack down from _estack:
+ *
+ *                  | .data .bss | heap ->   ...   | canary | <- MSP stack |
+ *                  ^ _sdata     ^ _end            ^ _estack - _Min_Stack_Size
+ *
+ *              _sbrk already keeps the heap below the reserved stack; the
+ *              stack had no such limit. MemGuard_Init puts a canary at the
+ *              bottom of the reserved stack and paints the rest of it, so
+ *              - a stack that grew past its reserve breaks the canary
+ *                (MemGuard_isIntact), checked by the control loop
+ *              - the deepest stack use so far is where the paint stops
+ *              The static budget is checked offline by Tools/stack from the
+ *              compiler's .su files; this is its runtime counterpart.
+ *
+ *              In the RTOS build the task stacks are static arrays in .bss
+ *              watched by the kernel (configCHECK_FOR_STACK_OVERFLOW); the
+ *              main stack measured here is the one of the interrupts.
+ */
+
+#ifndef INC_MEM_GUARD_H_
+#define INC_MEM_GUARD_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define MEMGUARD_CANARY       0xC0DEF00Du /* Guard words at the bottom of the reserved stack */
+#define MEMGUARD_CANARY_WORDS 8u          /* 32 bytes: a frame that skips one word still hits another */
+#define MEMGUARD_PAINT        0xA5A5A5A5u /* Unused stack */
+#define MEMGUARD_PAINT_MARGIN 64u         /* Left unpainted below the SP of MemGuard_Init (bytes) */
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief RAM use
+ */
+typedef struct {
+    uint32_t staticBytes;    /* .data + .bss */
+    uint32_t heapBytes;      /* Heap handed out by _sbrk (never shrinks: also its high-water mark) */
+    uint32_t stackPeakBytes; /* Deepest main stack use since boot */
+    uint32_t stackReserve;   /* _Min_Stack_Size, canary included */
+    uint32_t freeBytes;      /* Between the heap and the reserved stack */
+    bool intact;             /* Canary untouched */
+} MemGuard_stats_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Place the canary and paint the unused reserved stack
+ *
+ * Call early in main(), with the stack still shallow.
+ */
+void MemGuard_Init(void);
+
+/**
+ * @brief Whether the main stack stayed within its reserve
+ *
+ * @return bool - False once the canary was overwritten (memory below may be corrupt)
+ */
+bool MemGuard_isIntact(void);
+
+/**
+ * @brief Measure the RAM use
+ *
+ * Scans the painted stack: a few microseconds, call from a background task.
+ *
+ * @param stats RAM use
+ */
+void MemGuard_getStats(MemGuard_stats_t *stats);
+
+#endif /* INC_MEM_GUARD_H_ */
@@ -74,6 +74,10 @@ void PID_Reset(PIDController *pid);
 // Update the PID controller output based on the setpoint and current measurement
 float PID_Update(PIDController *pid, float setpoint, float measurement);
 
+// Same as PID_Update, but the integrator keeps its value (e.g. while the oven door is open):
+// the output is P + held integrator + D, within the output limits
+float PID_UpdateHoldIntegrator(PIDController *pid, float setpoint, float measurement);
+
 // Update the PID controller gains (Kp, Ki, Kd) in real time
 void PID_UpdateGains(PIDController *pid, float kp, float ki, float kd);
 
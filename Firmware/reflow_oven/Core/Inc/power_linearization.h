@@ -0,0 +1,158 @@
+/*
+ * power_linearization.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Heater power linearization. The power the elements deliver is
+ *              not proportional to the commanded duty (element resistance
+ *              rises with temperature, the line sags under load), so the loop
+ *              gain seen by the PID changes with the operating point. A lookup
+ *              table maps the requested power (PID output, %) to the duty
+ *              written to the modulator (%).
+ *
+ *              The table comes from an open-loop calibration run from a cold,
+ *              idle oven: the heaters are stepped through increasing duties,
+ *              each step is held until the chamber temperature settles, and
+ *              the steady-state rise over ambient is taken as proportional to
+ *              the delivered power. The measured duty/power curve is forced
+ *              monotonic and inverted onto an evenly spaced request axis, so
+ *              applying the table is one index and one interpolation.
+ *
+ *              The calibration captures the line voltage at the time it runs;
+ *              redo it after moving the oven to another supply.
+ *
+ *              A finished calibration is stored in the last kilobyte of the
+ *              recorder flash sector (RUNLOG) and loaded again at boot. Each
+ *              save takes the next blank slot, so no erase is needed. The
+ *              recorder erases the sector at the end of every run and then
+ *              writes the table in use back to the first slot.
+ */
+
+#ifndef INC_POWER_LINEARIZATION_H_
+#define INC_POWER_LINEARIZATION_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define PWRLIN_POINTS          11u      /* Table points, 0..100 % in 10 % steps */
+#define PWRLIN_STEP            (100.0f / (PWRLIN_POINTS - 1))
+
+#define PWRLIN_MAX_START_TEMP  50.0f    /* Calibration only starts from a cold oven (°C) */
+#define PWRLIN_MAX_TEMP        250.0f   /* Calibration stops stepping above this (°C) */
+#define PWRLIN_SETTLE_WINDOW_MS 60000u  /* Settling check period (ms) */
+#define PWRLIN_SETTLE_DELTA    1.0f     /* Settled when the temperature moved less than this in a window (°C) */
+#define PWRLIN_STEP_TIMEOUT_MS 1800000u /* Longest hold of one duty step (ms) */
+#define PWRLIN_MIN_RISE        2.0f     /* Rise of the first step needed for a usable table (°C) */
+
+#define PWRLIN_FLASH_SECTOR    FLASH_SECTOR_7 /* Shared with the run recorder (RUNLOG) */
+#define PWRLIN_FLASH_OFFSET    0x1FC00u /* Table slots from this offset in the sector: its last 1 KB */
+#define PWRLIN_FLASH_SLOTS     16u      /* Saves before the sector must be erased again */
+#define PWRLIN_FLASH_MAGIC     0x4E494C50u /* "PLIN" */
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief State of the calibration routine
+ */
+typedef enum {
+    PWRLIN_CAL_IDLE,      /* Not calibrating, the table is applied */
+    PWRLIN_CAL_RUNNING,   /* Stepping the heaters open loop */
+    PWRLIN_CAL_DONE,      /* Last calibration produced a new table */
+    PWRLIN_CAL_FAILED     /* Last calibration was aborted or unusable, table unchanged */
+} PowerLin_calState_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Load the last table saved in flash, or the identity (duty = requested power) if none
+ */
+void PowerLin_Init(void);
+
+/**
+ * @brief Map a requested power to the duty for the modulator, O(1)
+ *
+ * @param requested Requested power (PID output, % of full power)
+ * @return float - Duty to write to the actuator (%)
+ */
+float PowerLin_apply(float requested);
+
+/**
+ * @brief Current table, duty (%) for requests 0, PWRLIN_STEP, ... 100 %
+ *
+ * @return const float* - PWRLIN_POINTS entries
+ */
+const float *PowerLin_getTable(void);
+
+/**
+ * @brief Use a table kept elsewhere, e.g. the one stored with a recorded run
+ *
+ * @param table PWRLIN_POINTS duties (%), as returned by PowerLin_getTable()
+ */
+void PowerLin_setTable(const float *table);
+
+/**
+ * @brief Save the table in use to the next blank flash slot
+ *
+ * Called when a calibration finishes, and by the run recorder right after it
+ * erased the sector. Programs a few words without erasing, so it is safe
+ * from the control loop. The identity table is not saved.
+ *
+ * @return bool - True if the table in use is in flash, false when every slot is taken or programming failed
+ */
+bool PowerLin_store(void);
+
+/**
+ * @brief Whether the table in use survives a reset
+ *
+ * @return bool - True when it was loaded from flash or saved since, or is the identity
+ */
+bool PowerLin_isStored(void);
+
+/**
+ * @brief Start the calibration run
+ *
+ * @param currentTimeMs Current system time (ms)
+ * @param temperature Chamber temperature, taken as ambient (°C)
+ * @return bool - True if started, false if already running or the oven is warm
+ */
+bool PowerLin_startCalibration(uint32_t currentTimeMs, float temperature);
+
+/**
+ * @brief Abort the calibration run, the previous table stays in use
+ */
+void PowerLin_abortCalibration(void);
+
+/**
+ * @brief Run the calibration for one control tick
+ *
+ * @param currentTimeMs Current system time (ms)
+ * @param temperature Chamber temperature (°C)
+ * @return float - Open-loop duty to drive every heater with (%), 0 when not running
+ */
+float PowerLin_calibrationUpdate(uint32_t currentTimeMs, float temperature);
+
+/**
+ * @brief State of the calibration routine
+ *
+ * @return PowerLin_calState_t - Current state
+ */
+PowerLin_calState_t PowerLin_getCalibrationState(void);
+
+/**
+ * @brief True while the calibration drives the heaters
+ *
+ * @return bool - True while running
+ */
+bool PowerLin_isCalibrating(void);
+
+#endif /* INC_POWER_LINEARIZATION_H_ */
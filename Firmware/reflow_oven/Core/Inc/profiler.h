@@ -0,0 +1,121 @@
+/*
+ * profiler.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Cycle-accurate profiling of the control loop stages with the
+ *              DWT cycle counter. PROF_BEGIN / PROF_END bracket a stage and
+ *              accumulate, per probe point, the count, min, max and mean
+ *              duration and a log2 histogram:
+ *
+ *                  bucket 0:  < 2^PROF_BUCKET_BASE cycles
+ *                  bucket n:  [2^(PROF_BUCKET_BASE + n - 1), 2^(PROF_BUCKET_BASE + n)) cycles
+ *                  last:      everything longer
+ *
+ *              With PROF_ENABLE = 0 the macros expand to nothing and no
+ *              probe code or RAM is left in the image. Default: on in Debug
+ *              builds, off in Release.
+ */
+
+#ifndef INC_PROFILER_H_
+#define INC_PROFILER_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#ifndef PROF_ENABLE
+#ifdef DEBUG
+#define PROF_ENABLE 1
+#else
+#define PROF_ENABLE 0
+#endif
+#endif
+
+#define PROF_NUM_BUCKETS 16u /* Histogram buckets */
+#define PROF_BUCKET_BASE 7u  /* Bucket 0 ends at 2^7 cycles (1.28 us at 100 MHz); the last starts at 2^21 (21 ms) */
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Probe points
+ */
+typedef enum {
+    PROF_SENSE,      /* chamber_sense_temperature: four MAX6675 reads */
+    PROF_OPERATE,    /* ReflowOven_operate */
+    PROF_ACTUATOR,   /* update_randomCrossover_actuator, per zone */
+    PROF_GUI_MAIN,   /* main_page_handler */
+    PROF_GUI_OVEN,   /* oven_settings_page_handler */
+    PROF_GUI_PID,    /* pid_settings_page_handler */
+    PROF_GUI_DIAG,   /* diagnostics_page_handler */
+    PROF_NUM_POINTS
+} Profiler_point_t;
+
+/**
+ * @brief Accumulated durations of a probe point
+ */
+typedef struct {
+    uint32_t count;                        /* Measured runs */
+    uint32_t minCycles;                    /* Shortest run */
+    uint32_t maxCycles;                    /* Longest run */
+    uint64_t totalCycles;                  /* Sum of every run, for the mean */
+    uint32_t histogram[PROF_NUM_BUCKETS];  /* Runs per log2 bucket */
+} Profiler_stats_t;
+
+/******************************************************************************
+ * INSTRUMENTATION MACROS
+ ******************************************************************************/
+#if PROF_ENABLE
+#include "dwt.h"
+
+/* Open a bracket; must be closed with PROF_END(point) in the same scope */
+#define PROF_BEGIN(point) uint32_t prof_start_##point = DWT_getCycles()
+/* Close the bracket and record the duration */
+#define PROF_END(point)   Profiler_record((point), DWT_getCycles() - prof_start_##point)
+#else
+#define PROF_BEGIN(point)
+#define PROF_END(point)
+#endif
+
+#if PROF_ENABLE
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Clear every probe point
+ */
+void Profiler_reset(void);
+
+/**
+ * @brief Record one run of a probe point
+ *
+ * @param point Probe point
+ * @param cycles Duration (cycles)
+ */
+void Profiler_record(Profiler_point_t point, uint32_t cycles);
+
+/**
+ * @brief Accumulated durations of a probe point
+ *
+ * @param point Probe point
+ * @return const Profiler_stats_t* - Statistics, NULL for an unknown point
+ */
+const Profiler_stats_t *Profiler_getStats(Profiler_point_t point);
+
+/**
+ * @brief Short name of a probe point
+ *
+ * @param point Probe point
+ * @return const char* - Name for telemetry
+ */
+const char *Profiler_getName(Profiler_point_t point);
+#endif /* PROF_ENABLE */
+
+#endif /* INC_PROFILER_H_ */
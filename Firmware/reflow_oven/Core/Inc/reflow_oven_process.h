@@ -24,6 +24,9 @@
 /* PID's data type instance */
 extern PIDController PID;
 
+/* Maximum number of independently controlled heater zones */
+#define REFLOW_MAX_ZONES 4
+
 /**
  * @brief Enum defining the various phases of the reflow process
  */
@@ -34,6 +37,7 @@ typedef enum {
     REFLOW_REFLOW,   /* Reflow phase: Peak temperature to melt solder and form joints */
     REFLOW_COOLDOWN, /* Cool down phase: Gradual cooling to solidify solder joints */
     REFLOW_IDLE,     /* Idle phase: Oven is not actively running a process */
+    REFLOW_STANDBY,  /* Standby phase: Oven holds a warm temperature waiting for the next board */
 } ReflowPhases_t;
 
 /**
@@ -48,6 +52,7 @@ typedef enum {
     PARAM_ReflowTime,        /* Reflow duration (seconds) */
     PARAM_CoolDownRate,      /* Cool down rate (°C/s) */
     PARAM_CoolDownTempeture, /* Cool down temperature (°C) */
+    PARAM_StandbyTempeture,  /* Warm hold temperature between runs (°C), 0 = standby off */
 } ReflowParameters_enum;
 
 /**
@@ -62,6 +67,8 @@ typedef struct {
     float ReflowTime;        /* Reflow duration (seconds) */
     float CoolDownRate;      /* Cool down rate (°C/s) */
     float CoolDownTempeture; /* Cool down temperature (°C) */
+    float StandbyTempeture;  /* Warm hold temperature between runs (°C), 0 = standby off */
+    float ZoneBalance[REFLOW_IDLE][REFLOW_MAX_ZONES]; /* Share of each zone's max power per phase (0..1) */
 } ReflowOven_parameters_t;
 
 /**
@@ -75,6 +82,11 @@ typedef struct {
     float currentSetpoint;            /* Current temperature setpoint for PID */
     bool emergencyStop;               /* Emergency stop flag */
     float temperatureAtPhaseStart;    /* Temperature recorded at phase start */
+    uint32_t entryOffsetMs;           /* Profile time skipped by a warm start (ms) */
+    uint32_t lastOperateTime;         /* Time of the previous control cycle (ms) */
+    float gainScale;                  /* Controller gains for the identified load (1 = reference load) */
+    float feedforward;                /* Model power for the current setpoint (%), 0 until identified */
+    uint32_t soakTimeMs;              /* Soak duration for the identified load (ms) */
 } ReflowOven_t;
 
 /******************************************************************************
@@ -105,17 +117,52 @@ void ReflowOven_Init(void);
 bool ReflowOven_modifyParameters(ReflowParameters_enum parameterUpdate, float newParameterValue);
 
 /**
- * @brief Start the reflow process from idle state
+ * @brief Update the power share of a heater zone for one phase of the profile
+ *
+ * @param phase Active phase (REFLOW_PREHEAT..REFLOW_COOLDOWN)
+ * @param zone Heater zone index
+ * @param share Fraction of the zone's maximum power allowed in that phase (0..1)
+ *
+ * @return bool - True if the balance was updated, false otherwise
+ */
+bool ReflowOven_setZoneBalance(ReflowPhases_t phase, uint8_t zone, float share);
+
+/**
+ * @brief Replace the whole profile (e.g. the next profile of a batch)
+ *
+ * @param profile Profile to use from the next run on
+ *
+ * @return bool - True if the profile was loaded, false while a run is in progress
+ */
+bool ReflowOven_loadProfile(const ReflowOven_parameters_t *profile);
+
+/**
+ * @brief Start the reflow process from idle or standby state
+ *
+ * A warm oven does not restart the profile from ambient: preheat enters the
+ * ramp at the point where it reaches the current temperature (see
+ * ReflowOven_getEntryOffset), so every board sees the same trajectory.
+ *
+ * The first seconds of preheat identify the loaded thermal mass (see
+ * thermal_mass.h); the controller gains, a model feedforward and the soak
+ * time are then scaled for the load for the rest of the run.
  *
  * @return bool - True if process started successfully, false otherwise
  */
 bool ReflowOven_startProcess(void);
 
 /**
- * @brief Stop the reflow process and return to idle state
+ * @brief Stop the reflow process (cool down), or leave standby and return to idle
  */
 void ReflowOven_stopProcess(void);
 
+/**
+ * @brief Abort the process at once: heaters off and straight back to idle
+ *
+ * Used by the fault detection; the run is recorded as an emergency stop.
+ */
+void ReflowOven_emergencyStop(void);
+
 /**
  * @brief Execute one control cycle for the reflow oven
  *
@@ -144,4 +191,15 @@ ReflowPhases_t ReflowOven_getCurrentPhase(void);
  */
 uint32_t ReflowOven_getPhaseElapsedTime(uint32_t currentTimeMs);
 
+/**
+ * @brief Profile time a preheat starting at a given temperature skips
+ *
+ * The reference trajectory ramps from ambient (25 °C) at the preheat rate;
+ * starting warm means entering it where it crosses the start temperature.
+ *
+ * @param startTemperature Chamber temperature when preheat starts (°C)
+ * @return uint32_t - Entry offset into the preheat ramp (ms), 0 from ambient or below
+ */
+uint32_t ReflowOven_getEntryOffset(float startTemperature);
+
 #endif /* INC_REFLOW_OVEN_PROCESS_H_ */
@@ -0,0 +1,216 @@
+/*
+ * run_recorder.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Compact binary recorder for reflow runs. Every control tick is
+ *              delta-encoded into a fixed RAM ring of independently decodable
+ *              blocks. At the end of a run a summary (and optionally the full
+ *              trace) is written to a dedicated flash sector.
+ */
+
+#ifndef INC_RUN_RECORDER_H_
+#define INC_RUN_RECORDER_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "pid.h"
+#include "power_linearization.h"
+#include "reflow_oven_process.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define RUNREC_NUM_PROBES      4        /* Thermocouples recorded per tick */
+
+/*
+ * Ring sizing: the longest run the parameter limits allow is bounded by the
+ * phase timeouts (600 + 180 + 600 + 90 + 600 s = 2070 s), i.e. ~8300 ticks at
+ * 4 Hz. A steady-state tick packs into a 6 byte record, so 56 blocks of 1 KB
+ * (keyframe overhead included) hold the whole run in 56 KB of RAM.
+ */
+#define RUNREC_BLOCK_SIZE      1024u    /* Bytes per block (starts with a keyframe) */
+#define RUNREC_NUM_BLOCKS      56u      /* Blocks in the RAM ring */
+
+#define RUNREC_PROBE_SCALE     4.0f     /* Probe readings in 1/4 °C (MAX6675 LSB) */
+#define RUNREC_TEMP_SCALE      16.0f    /* Setpoint and fused temperature in 1/16 °C */
+#define RUNREC_PID_SCALE       16.0f    /* PID terms in 1/16 % of full power */
+
+#define RUNREC_LIQUIDUS_TEMP   217.0f   /* SAC305 liquidus for time-above-liquidus (°C) */
+#define RUNREC_PROBE_FAULT     (-404 * 4) /* Quarter-degree value of a faulted MAX6675 */
+
+#define RUNREC_FLASH_MAGIC     0x4E555252u /* "RRUN" */
+#define RUNREC_FLASH_VERSION   8u
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief One control tick, as captured by the recorder
+ */
+typedef struct {
+    uint32_t timeMs;                   /* HAL tick handed to ReflowOven_operate() (ms) */
+    uint8_t phase;                     /* ReflowPhases_t of the tick */
+    uint8_t output;                    /* Highest zone duty written to the modulator (%) */
+    int16_t setpoint;                  /* Setpoint (1/16 °C) */
+    int16_t probe[RUNREC_NUM_PROBES];  /* Each MAX6675 reading (1/4 °C) */
+    int16_t fused;                     /* Fused chamber temperature (1/16 °C) */
+    int16_t pTerm;                     /* Proportional term (1/16 %) */
+    int16_t iTerm;                     /* Integral term (1/16 %) */
+    int16_t dTerm;                     /* Derivative term (1/16 %) */
+} RunRecorder_sample_t;
+
+/**
+ * @brief Reason why a recorded run ended
+ */
+typedef enum {
+    RUNREC_END_COMPLETED, /* Went through reflow and cooled down */
+    RUNREC_END_ABORTED,   /* Stopped by the operator or a phase timeout */
+    RUNREC_END_EMERGENCY, /* Over-temperature emergency stop */
+} RunRecorder_endReason_t;
+
+/**
+ * @brief Per-run summary, kept in RAM and written to flash at end of run
+ */
+typedef struct {
+    uint32_t runId;                        /* Monotonic run counter since boot */
+    uint32_t startTimeMs;                  /* HAL tick of the first recorded sample */
+    uint32_t durationMs;                   /* Run duration (ms) */
+    uint32_t samples;                      /* Control ticks recorded */
+    uint32_t phaseDurationMs[REFLOW_IDLE]; /* Time spent in PREHEAT..COOLDOWN (ms) */
+    uint32_t entryOffsetMs;                /* Preheat ramp skipped by a warm start (ms) */
+    uint32_t doorOpenMs;                   /* Time with the door open, profile clock paused (ms) */
+    uint32_t soakTimeMs;                   /* Soak duration used, extended for a heavy load (ms) */
+    float peakTemperature;                 /* Highest fused temperature (°C) */
+    float timeAboveLiquidusS;              /* Time above RUNREC_LIQUIDUS_TEMP (s) */
+    float maxProbeSpread;                  /* Worst spread between healthy probes (°C) */
+    float zoneSpreadMax;                   /* Worst heater zone spread during soak and reflow (°C) */
+    float zoneSpreadMean;                  /* Mean heater zone spread during soak and reflow (°C) */
+    float energyWh;                        /* Heater energy delivered during the run (Wh) */
+    float phaseEnergyWh[REFLOW_IDLE];      /* Heater energy per phase PREHEAT..COOLDOWN (Wh) */
+    float massRatio;                       /* Identified thermal mass relative to the reference load */
+    float massGain;                        /* Identified heating gain (°C/s at full power) */
+    uint16_t droppedBlocks;                /* Ring blocks overwritten during the run */
+    uint8_t endReason;                     /* RunRecorder_endReason_t */
+    uint8_t probeFaults;                   /* Bitmask of probes that faulted during the run */
+    uint8_t doorOpenings;                  /* Times the door was opened during the run */
+    uint8_t loadChanges;                   /* Load changes detected during the run */
+} RunRecorder_summary_t;
+
+/**
+ * @brief Layout of the recorder flash sector; trace blocks follow it, oldest first
+ */
+typedef struct {
+    uint32_t magic;                    /* RUNREC_FLASH_MAGIC */
+    uint16_t version;                  /* RUNREC_FLASH_VERSION */
+    uint16_t blockSize;                /* RUNREC_BLOCK_SIZE of the writer */
+    uint16_t numBlocks;                /* Trace blocks stored after the header (0 = summary only) */
+    uint16_t headerSize;               /* sizeof(RunRecorder_flashHeader_t), padded to a word */
+    RunRecorder_summary_t summary;     /* Run summary */
+    ReflowOven_parameters_t profile;   /* Profile the run was started with */
+    PIDController pid;                 /* PID configuration at run start */
+    float powerTable[PWRLIN_POINTS];   /* Power linearization table in use */
+} RunRecorder_flashHeader_t;
+
+/**
+ * @brief Callback used by the decoder for every sample found in a block
+ */
+typedef void (*RunRecorder_sampleCallback_t)(const RunRecorder_sample_t *sample, void *context);
+
+/******************************************************************************
+ * EXTERNAL VARIABLES
+ ******************************************************************************/
+extern bool RunRecorder_saveTrace; /* Also store the full trace in flash at end of run */
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Reset the recorder ring and summary
+ */
+void RunRecorder_Init(void);
+
+/**
+ * @brief Record one control tick
+ *
+ * Starts a run on the first sample of an active phase and finishes it
+ * (summary and flash write) on the first idle or standby sample after that. Cheap enough to be called
+ * from every control tick.
+ *
+ * @param sample Control tick to record
+ */
+void RunRecorder_record(const RunRecorder_sample_t *sample);
+
+/**
+ * @brief Fold the heater zone spread of the last tick into the run summary
+ *
+ * Only soak and reflow ticks count: that is where the board must be uniform.
+ * Call after RunRecorder_record() for the same tick.
+ *
+ * @param spread Difference between the hottest and coldest zone (°C)
+ */
+void RunRecorder_recordZoneSpread(float spread);
+
+/**
+ * @brief Add the heater energy of the last tick to the run and its phase
+ *
+ * Call after RunRecorder_record() for the same tick.
+ *
+ * @param energyWh Energy delivered during the tick (Wh)
+ */
+void RunRecorder_recordEnergy(float energyWh);
+
+/**
+ * @brief Check whether a run is being recorded
+ *
+ * @return bool - True while a run is in progress
+ */
+bool RunRecorder_isRecording(void);
+
+/**
+ * @brief Get the summary of the current (or last finished) run
+ *
+ * @return const RunRecorder_summary_t* - Pointer to the summary
+ */
+const RunRecorder_summary_t *RunRecorder_getSummary(void);
+
+/**
+ * @brief Get a trace block from the RAM ring, oldest first
+ *
+ * @param index Block index (0 = oldest)
+ * @return const uint8_t* - Block of RUNREC_BLOCK_SIZE bytes, NULL if out of range
+ */
+const uint8_t *RunRecorder_getBlock(uint16_t index);
+
+/**
+ * @brief Number of trace blocks currently held in the RAM ring
+ *
+ * @return uint16_t - Blocks available through RunRecorder_getBlock()
+ */
+uint16_t RunRecorder_getBlockCount(void);
+
+/**
+ * @brief Decode every sample stored in a trace block
+ *
+ * @param block Block of RUNREC_BLOCK_SIZE bytes
+ * @param callback Called once per decoded sample
+ * @param context User pointer handed to the callback
+ * @return uint32_t - Number of samples decoded, 0 if the block is corrupt or empty
+ */
+uint32_t RunRecorder_decodeBlock(const uint8_t *block, RunRecorder_sampleCallback_t callback, void *context);
+
+/**
+ * @brief Convert a value to the recorder's fixed-point representation
+ *
+ * @param value Value to convert
+ * @param scale Fixed-point scale (e.g. RUNREC_TEMP_SCALE)
+ * @return int16_t - Rounded and saturated fixed-point value
+ */
+int16_t RunRecorder_quantize(float value, float scale);
+
+#endif /* INC_RUN_RECORDER_H_ */
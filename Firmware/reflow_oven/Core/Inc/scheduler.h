@@ -0,0 +1,168 @@
+/*
+ * scheduler.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Run-to-completion cooperative scheduler. A single 1 ms
+ *              hardware timebase (TIM3) calls Scheduler_tick(), which
+ *              releases every task whose period has come up. The main loop
+ *              calls Scheduler_runNext(), which runs the highest priority
+ *              released task to completion. Tasks never preempt each other,
+ *              so the worst-case latency of a task is the longest execution
+ *              time of any other task plus the ones of higher priority
+ *              released with it.
+ *
+ *              Per task the scheduler keeps, measured with the DWT cycle
+ *              counter from the release instant:
+ *              - latency: release -> start
+ *              - response: release -> end, checked against the deadline
+ *                (overrun)
+ *              - skipped releases: the period came up again before the
+ *                previous release ran (one activation lost)
+ *
+ *              Besides its period, a task can be released by an event
+ *              (Scheduler_release, e.g. an input interrupt waking the GUI).
+ *              With nothing released the loop sleeps in WFI until the next
+ *              interrupt (Scheduler_sleep); the time asleep gives the CPU
+ *              load (cpu_load.h).
+ */
+
+#ifndef INC_SCHEDULER_H_
+#define INC_SCHEDULER_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define SCHEDULER_MAX_TASKS 8u /* Task slots */
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Task body, run to completion
+ *
+ * @param nowMs Release time of this activation (ms, same base as HAL_GetTick)
+ */
+typedef void (*Scheduler_taskFn_t)(uint32_t nowMs);
+
+/**
+ * @brief Static description of a task
+ */
+typedef struct {
+    const char *name;         /* Short name for telemetry */
+    Scheduler_taskFn_t run;   /* Task body */
+    uint16_t periodMs;        /* Release period (ms) */
+    uint16_t offsetMs;        /* First release after Scheduler_start (ms), spreads tasks of equal period */
+    uint32_t deadlineUs;      /* Release -> end budget (us); later counts as an overrun */
+    uint8_t priority;         /* 0 = highest; ties run in registration order */
+} Scheduler_taskConfig_t;
+
+/**
+ * @brief Timing statistics of a task
+ */
+typedef struct {
+    uint32_t runs;            /* Completed activations */
+    uint32_t overruns;        /* Activations that ended after their deadline */
+    uint32_t skipped;         /* Releases lost because the previous one had not run yet */
+    uint32_t maxLatencyUs;    /* Worst release -> start (us) */
+    uint32_t maxResponseUs;   /* Worst release -> end (us) */
+    uint32_t maxExecUs;       /* Worst start -> end (us) */
+} Scheduler_stats_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Drop every task and set the scheduler clock
+ *
+ * @param nowMs Initial scheduler time (ms); HAL_GetTick() keeps both clocks aligned
+ */
+void Scheduler_Init(uint32_t nowMs);
+
+/**
+ * @brief Register a task; call before Scheduler_start
+ *
+ * @param config Task description (copied)
+ * @return int8_t - Task id, -1 when every slot is taken
+ */
+int8_t Scheduler_addTask(const Scheduler_taskConfig_t *config);
+
+/**
+ * @brief Schedule the first release of every task from the current time
+ */
+void Scheduler_start(void);
+
+/**
+ * @brief Advance the clock by 1 ms and release the due tasks (timebase ISR)
+ *
+ * @return uint32_t - Bit per task id whose period came up in this tick (released or skipped)
+ */
+uint32_t Scheduler_tick(void);
+
+/**
+ * @brief Release a task now, outside its period (ISR safe)
+ *
+ * A task already waiting to run is left as it is.
+ *
+ * @param id Task id; unknown ids and a stopped scheduler are ignored
+ */
+void Scheduler_release(uint8_t id);
+
+/**
+ * @brief Run the highest priority released task to completion
+ *
+ * @return bool - False when no task was released (the CPU is idle)
+ */
+bool Scheduler_runNext(void);
+
+/**
+ * @brief Sleep until the next interrupt unless a task is already released
+ *
+ * Call when Scheduler_runNext() found nothing to run.
+ */
+void Scheduler_sleep(void);
+
+/**
+ * @brief Scheduler time
+ *
+ * @return uint32_t - Milliseconds (same base as HAL_GetTick)
+ */
+uint32_t Scheduler_getTime(void);
+
+/**
+ * @brief Number of registered tasks
+ *
+ * @return uint8_t - Task count
+ */
+uint8_t Scheduler_getTaskCount(void);
+
+/**
+ * @brief Description of a task
+ *
+ * @param id Task id
+ * @return const Scheduler_taskConfig_t* - Task description, NULL for an unknown id
+ */
+const Scheduler_taskConfig_t *Scheduler_getTask(uint8_t id);
+
+/**
+ * @brief Timing statistics of a task
+ *
+ * @param id Task id
+ * @return const Scheduler_stats_t* - Statistics, NULL for an unknown id
+ */
+const Scheduler_stats_t *Scheduler_getStats(uint8_t id);
+
+/**
+ * @brief Clear the statistics of every task
+ */
+void Scheduler_resetStats(void);
+
+#endif /* INC_SCHEDULER_H_ */
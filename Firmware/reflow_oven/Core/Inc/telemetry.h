@@ -0,0 +1,49 @@
+/*
+ * telemetry.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Line based telemetry over USART1. Every record is one ASCII
+ *              line starting with a '$' tag followed by comma separated
+ *              fields, e.g. "$BOARD,3,1,412.5,223.4,41.0,0\r\n", so a serial
+ *              terminal or a script can log it directly.
+ */
+
+#ifndef INC_TELEMETRY_H_
+#define INC_TELEMETRY_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "main.h"
+#include <stdint.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define TELEMETRY_LINE_SIZE     128u /* Longest line, terminator included */
+#define TELEMETRY_TX_TIMEOUT_MS 20u  /* 128 bytes take ~11 ms at 115200 baud */
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Initialize telemetry on an already configured UART
+ *
+ * @param huart UART handle used for transmission
+ */
+void Telemetry_Init(UART_HandleTypeDef *huart);
+
+/**
+ * @brief Send one formatted telemetry line
+ *
+ * The line is truncated to TELEMETRY_LINE_SIZE and "\r\n" is appended.
+ * Transmission is blocking and bounded by TELEMETRY_TX_TIMEOUT_MS.
+ *
+ * @param format printf style format of the line, without terminator
+ */
+void Telemetry_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+#endif /* INC_TELEMETRY_H_ */
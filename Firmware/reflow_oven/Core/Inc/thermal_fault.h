@@ -0,0 +1,130 @@
+/*
+ * thermal_fault.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Model-based heater and probe fault detection. The chamber
+ *              model (chamber_model.h), with the gain identified for the
+ *              current load, predicts the temperature slope for the
+ *              commanded heater power, and every FAULT_WINDOW_MS the observed slope is compared with
+ *              it. Three faults are detected:
+ *              - Uncommanded heating: the chamber keeps rising after the
+ *                heaters have been off long enough (stuck-on SSR).
+ *              - No rise at full command: the model expects a clear rise but
+ *                the chamber barely moves (open element, blown fuse, SSR that
+ *                does not turn on).
+ *              - Probe divergence: a thermocouple strays from the median of
+ *                the others (probe fell off the board).
+ *              Faults latch until cleared by the operator; the caller forces
+ *              the safe state in the same tick that detects the fault.
+ */
+
+#ifndef INC_THERMAL_FAULT_H_
+#define INC_THERMAL_FAULT_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define FAULT_NUM_PROBES          4u      /* MAX6675 probes checked for divergence */
+
+/* Slope checks, evaluated once per window */
+#define FAULT_WINDOW_MS           5000u   /* Slope measurement window (ms) */
+#define FAULT_OFF_SETTLE_MS       30000u  /* Heaters off this long before uncommanded heating counts (element lag) */
+#define FAULT_UNCOMMANDED_SLOPE   0.3f    /* Rise with the heaters off that counts as heating (°C/s) */
+#define FAULT_UNCOMMANDED_WINDOWS 2u      /* Consecutive windows to flag uncommanded heating */
+#define FAULT_FULL_POWER          90.0f   /* Mean command treated as full power (%) */
+#define FAULT_MIN_EXPECTED_SLOPE  0.3f    /* Only check the rise when the model expects at least this (°C/s) */
+#define FAULT_NO_RISE_RATIO       0.25f   /* Observed / expected slope below this counts as no rise */
+#define FAULT_NO_RISE_WINDOWS     6u      /* Consecutive windows to flag no rise (covers the element lag) */
+
+/* Probe check, evaluated every tick */
+#define FAULT_PROBE_MAX_DEVIATION 30.0f   /* Distance from the median of the healthy probes (°C) */
+#define FAULT_PROBE_TICKS         8u      /* Consecutive ticks to flag a diverging probe (2 s at 4 Hz) */
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Latched fault
+ */
+typedef enum {
+    FAULT_NONE,
+    FAULT_UNCOMMANDED_HEATING, /* Rising with zero command */
+    FAULT_NO_RISE,             /* Not rising at full command */
+    FAULT_PROBE_DIVERGENCE,    /* One probe far from the others */
+    FAULT_CONTROL_TIMING,      /* Control loop missing its periods (raised by the timing monitor) */
+} ThermalFault_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Reset the detector and clear any latched fault
+ */
+void ThermalFault_Init(void);
+
+/**
+ * @brief Run the detector for one control tick
+ *
+ * @param currentTimeMs Current system time (ms)
+ * @param power Heater command applied since the previous tick (highest zone, %)
+ * @param temperature Fused chamber temperature (°C)
+ * @param probes Reading of each probe (°C), FAULT_NUM_PROBES entries
+ * @param healthyMask Bit per probe that answered in this tick
+ * @return ThermalFault_t - Latched fault, FAULT_NONE while healthy
+ */
+ThermalFault_t ThermalFault_update(uint32_t currentTimeMs, float power, float temperature,
+                                   const float *probes, uint8_t healthyMask);
+
+/**
+ * @brief Latched fault
+ *
+ * @return ThermalFault_t - FAULT_NONE while healthy
+ */
+ThermalFault_t ThermalFault_get(void);
+
+/**
+ * @brief Probe that triggered FAULT_PROBE_DIVERGENCE
+ *
+ * @return uint8_t - Probe id
+ */
+uint8_t ThermalFault_getProbe(void);
+
+/**
+ * @brief Slopes of the last evaluated window
+ *
+ * @param observed Measured slope (°C/s), may be NULL
+ * @param expected Model slope for the mean command (°C/s), may be NULL
+ */
+void ThermalFault_getSlopes(float *observed, float *expected);
+
+/**
+ * @brief Skip the slope checks of this tick (door open), the probe check still runs
+ *
+ * Call before ThermalFault_update(); the slope window restarts afterwards.
+ */
+void ThermalFault_holdSlopeChecks(void);
+
+/**
+ * @brief Latch a fault detected outside the thermal model (e.g. control loop timing)
+ *
+ * A fault already latched is kept.
+ *
+ * @param fault Fault to latch
+ */
+void ThermalFault_raise(ThermalFault_t fault);
+
+/**
+ * @brief Clear the latched fault (operator acknowledge); the checks restart from scratch
+ */
+void ThermalFault_clear(void);
+
+#endif /* INC_THERMAL_FAULT_H_ */
@@ -0,0 +1,107 @@
+/*
+ * thermal_mass.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Identification of the loaded thermal mass at the start of
+ *              preheat. For the first THERMALMASS_WINDOW_MS of the phase the
+ *              heaters run open loop at THERMALMASS_STEP_POWER; once the
+ *              element lag has passed the chamber slope is measured and the
+ *              heating gain of the chamber model (chamber_model.h) is solved
+ *              from it and becomes the model's identified gain.
+ *
+ *              The mass ratio is CHAMBER_REF_GAIN / gain: 1.0 for the
+ *              reference load (bare 1.6 mm FR4 panel), above 1 for heavier
+ *              boards (aluminium core, thick copper), below 1 for lighter
+ *              ones. The process scales its controller gains, feedforward and
+ *              soak time from it.
+ */
+
+#ifndef INC_THERMAL_MASS_H_
+#define INC_THERMAL_MASS_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "chamber_model.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define THERMALMASS_STEP_POWER  50.0f   /* Open-loop power step applied for the identification (%) */
+#define THERMALMASS_WINDOW_MS   30000u  /* Identification window from preheat start (ms) */
+#define THERMALMASS_LAG_MS      10000u  /* Element lag skipped before measuring the slope (ms) */
+#define THERMALMASS_MIN_RISE    1.0f    /* Smallest rise over the measurement that is trusted (°C) */
+
+/* Accepted range of the mass ratio; estimates outside it are clamped */
+#define THERMALMASS_MIN_RATIO   0.5f
+#define THERMALMASS_MAX_RATIO   3.0f
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief State of the identification
+ */
+typedef enum {
+    THERMALMASS_IDLE,        /* Not run since the last preheat start */
+    THERMALMASS_IDENTIFYING, /* Power step applied, window running */
+    THERMALMASS_DONE,        /* Estimate available */
+    THERMALMASS_FAILED,      /* Aborted or no usable rise: the reference load is assumed */
+} ThermalMass_state_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Reset the estimate to the reference load
+ */
+void ThermalMass_Init(void);
+
+/**
+ * @brief Start the identification window, back to the reference gain until it closes
+ *
+ * @param currentTimeMs Current system time (ms)
+ */
+void ThermalMass_start(uint32_t currentTimeMs);
+
+/**
+ * @brief Feed one control tick while identifying
+ *
+ * @param temperature Fused chamber temperature (°C)
+ * @param currentTimeMs Current system time (ms)
+ * @return ThermalMass_state_t - State after this tick
+ */
+ThermalMass_state_t ThermalMass_update(float temperature, uint32_t currentTimeMs);
+
+/**
+ * @brief Drop a running identification (door opened, run stopped)
+ */
+void ThermalMass_abort(void);
+
+/**
+ * @brief Current state of the identification
+ *
+ * @return ThermalMass_state_t - Identification state
+ */
+ThermalMass_state_t ThermalMass_getState(void);
+
+/**
+ * @brief Whether the power step is being applied
+ *
+ * @return bool - True while the controllers must hold THERMALMASS_STEP_POWER
+ */
+bool ThermalMass_isIdentifying(void);
+
+/**
+ * @brief Loaded thermal mass relative to the reference load
+ *
+ * @return float - Mass ratio, 1.0 until an identification succeeded
+ */
+float ThermalMass_getRatio(void);
+
+#endif /* INC_THERMAL_MASS_H_ */
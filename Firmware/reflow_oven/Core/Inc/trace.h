@@ -0,0 +1,155 @@
+/*
+ * trace.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Event trace: a fixed RAM ring of TRACE_RECORDS 8-byte
+ *              records, each holding the DWT cycle stamp, the event id and a
+ *              24-bit payload. TRACE(event, payload) is callable from any
+ *              context: every caller claims its slot with one atomic
+ *              increment, so ISRs preempting each other never share a
+ *              record, and the oldest records are overwritten (flight
+ *              recorder). A mask selects the events recorded.
+ *
+ *              The "TRACE" command dumps the ring over the telemetry UART
+ *              as hex lines, a few per telemetry tick; recording is frozen
+ *              meanwhile. Tools/trace turns a captured log into a Chrome
+ *              trace (chrome://tracing, Perfetto) timeline.
+ *
+ *              With TRACE_ENABLE = 0 the macro expands to nothing and no
+ *              ring is left in the image. Default: on in Debug builds, off
+ *              in Release.
+ */
+
+#ifndef INC_TRACE_H_
+#define INC_TRACE_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#ifndef TRACE_ENABLE
+#ifdef DEBUG
+#define TRACE_ENABLE 1
+#else
+#define TRACE_ENABLE 0
+#endif
+#endif
+
+#define TRACE_RECORDS      1024u        /* Ring length, power of two (8 KB) */
+#define TRACE_PAYLOAD_MASK 0x00FFFFFFu  /* Payload bits kept per record */
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Traced events; _BEGIN/_END pairs become durations on the timeline
+ */
+typedef enum {
+    TRACE_ZERO_CROSS,       /* TIM1 zero-cross ISR (masked by default: 100-120 per second) */
+    TRACE_MAINS_LOST,       /* TIM1 ISR, no zero cross; payload = zero crosses since the line came back */
+    TRACE_MAINS_RESTORED,   /* TIM1 ISR, first zero cross after a loss */
+    TRACE_BUTTON,           /* EXTI2 encoder push button */
+    TRACE_ENCODER,          /* TIM2 encoder step; payload = counter */
+    TRACE_UART_RX,          /* USART1 command byte; payload = byte */
+    TRACE_CONTROL_RELEASE,  /* Timebase released a control cycle */
+    TRACE_CONTROL_BEGIN,    /* Control step entered */
+    TRACE_CONTROL_END,      /* Actuators written; payload = applied power (%) */
+    TRACE_TASK_BEGIN,       /* Scheduler task started; payload = task id */
+    TRACE_TASK_END,         /* Scheduler task finished; payload = task id */
+    TRACE_PHASE,            /* Reflow phase transition; payload = old << 8 | new */
+    TRACE_SENSOR_BEGIN,     /* MAX6675 read started; payload = device */
+    TRACE_SENSOR_END,       /* MAX6675 read finished; payload = device */
+    TRACE_SENSOR_ERROR,     /* MAX6675 SPI error or open probe; payload = device << 16 | raw word */
+    TRACE_GUI_EVENT,        /* Encoder event handled; payload = page << 8 | event */
+    TRACE_FAULT,            /* Fault latched; payload = fault */
+    TRACE_NUM_EVENTS
+} Trace_event_t;
+
+/**
+ * @brief One record
+ */
+typedef struct {
+    uint32_t cycles;        /* DWT stamp */
+    uint32_t data;          /* Event id << 24 | payload */
+} Trace_record_t;
+
+/******************************************************************************
+ * INSTRUMENTATION MACROS
+ ******************************************************************************/
+#if TRACE_ENABLE
+/* Record an event with its payload (low 24 bits kept) */
+#define TRACE(event, payload) Trace_record((event), (uint32_t)(payload))
+#else
+#define TRACE(event, payload)
+#endif
+
+#if TRACE_ENABLE
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Empty the ring and record every event but the zero crosses
+ */
+void Trace_Init(void);
+
+/**
+ * @brief Append one record (any context)
+ *
+ * @param event Event id
+ * @param payload Event data, low 24 bits kept
+ */
+void Trace_record(Trace_event_t event, uint32_t payload);
+
+/**
+ * @brief Select the events recorded
+ *
+ * @param mask Bit per Trace_event_t
+ */
+void Trace_setMask(uint32_t mask);
+
+/**
+ * @brief Events recorded
+ *
+ * @return uint32_t - Bit per Trace_event_t
+ */
+uint32_t Trace_getMask(void);
+
+/**
+ * @brief Stop or resume recording (while the ring is read out)
+ *
+ * @param frozen True to drop new events
+ */
+void Trace_freeze(bool frozen);
+
+/**
+ * @brief Records held in the ring
+ *
+ * @return uint32_t - At most TRACE_RECORDS
+ */
+uint32_t Trace_getCount(void);
+
+/**
+ * @brief Read a record, oldest first; freeze the ring first
+ *
+ * @param index 0 for the oldest record held
+ * @return const Trace_record_t* - Record, NULL past the last one
+ */
+const Trace_record_t *Trace_get(uint32_t index);
+
+/**
+ * @brief Events dropped while the ring was frozen
+ *
+ * @return uint32_t - Dropped events since Trace_Init
+ */
+uint32_t Trace_getDropped(void);
+#endif /* TRACE_ENABLE */
+
+#endif /* INC_TRACE_H_ */
@@ -0,0 +1,98 @@
+/*
+ * transient_detector.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Door-open and load-change detection from the temperature
+ *              sample stream, run once per control tick by the process.
+ *
+ *              Door open: during a heating phase the chamber air drops
+ *              faster than TRANSIENT_DOOR_SLOPE over one second. While the
+ *              door is open the process pauses the profile clock and the
+ *              controllers hold their integrators; the door counts as
+ *              closed again once the chamber stops falling.
+ *
+ *              Load change: the detector keeps tracking the heating gain of
+ *              the chamber model (chamber_model.h) from windows with enough
+ *              heater power. A heavy panel shows up as windows whose gain
+ *              stays far from the model's. After a door closing or a load
+ *              change the gain is relearnt quickly from the next windows.
+ */
+
+#ifndef INC_TRANSIENT_DETECTOR_H_
+#define INC_TRANSIENT_DETECTOR_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "chamber_model.h"
+#include "reflow_oven_process.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define TRANSIENT_SLOPE_TICKS      4u      /* Slope span in control ticks (1 s at 4 Hz) */
+#define TRANSIENT_DOOR_SLOPE       (-1.5f) /* Falling faster than this opens the door (°C/s) */
+#define TRANSIENT_DOOR_TICKS       2u      /* Consecutive ticks to flag the door open */
+#define TRANSIENT_CLOSE_SLOPE      (-0.2f) /* Falling slower than this closes the door (°C/s) */
+#define TRANSIENT_CLOSE_TICKS      4u      /* Consecutive ticks to flag the door closed */
+#define TRANSIENT_MAX_PAUSE_MS     120000u /* Longest profile pause; the clock runs again after it */
+
+/* Heating gain estimate */
+#define TRANSIENT_WINDOW_MS        5000u   /* Gain measurement window (ms) */
+#define TRANSIENT_MIN_POWER        30.0f   /* Mean power needed for a usable window (%) */
+#define TRANSIENT_RELEARN_WINDOWS  4u      /* Windows learnt with the fast filter after a transient */
+#define TRANSIENT_FAST_ALPHA       0.5f    /* Filter weight while relearning */
+#define TRANSIENT_SLOW_ALPHA       0.1f    /* Filter weight in steady operation */
+#define TRANSIENT_LOAD_RATIO       0.4f    /* Relative gain error that counts as a load change */
+#define TRANSIENT_LOAD_WINDOWS     3u      /* Consecutive windows to flag a load change */
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+/**
+ * @brief Door / load state seen by the detector
+ */
+typedef enum {
+    TRANSIENT_NONE,        /* Steady operation */
+    TRANSIENT_DOOR_OPEN,   /* Door open: profile clock paused, integrators held */
+} Transient_state_t;
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Reset the detector and the gain estimate
+ */
+void Transient_Init(void);
+
+/**
+ * @brief Feed one control tick
+ *
+ * @param phase Current reflow phase
+ * @param temperature Fused chamber temperature (°C)
+ * @param power Heater command of the previous tick (%)
+ * @param currentTimeMs Current system time (ms)
+ * @return Transient_state_t - State after this tick
+ */
+Transient_state_t Transient_update(ReflowPhases_t phase, float temperature, float power, uint32_t currentTimeMs);
+
+/**
+ * @brief Current door state
+ *
+ * @return Transient_state_t - TRANSIENT_DOOR_OPEN while the door is open
+ */
+Transient_state_t Transient_getState(void);
+
+/**
+ * @brief Number of load changes detected since Transient_Init
+ *
+ * @return uint16_t - Load change count
+ */
+uint16_t Transient_getLoadChanges(void);
+
+#endif /* INC_TRANSIENT_DETECTOR_H_ */
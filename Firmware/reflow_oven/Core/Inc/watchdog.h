@@ -0,0 +1,69 @@
+/*
+ * watchdog.h
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Independent watchdog (IWDG) tied to control loop liveness.
+ *              The IWDG runs from the 32 kHz LSI, independent of the system
+ *              clock, and is driven through its registers (the HAL IWDG
+ *              driver is not part of this build). The control loop feeds it
+ *              only after a complete sense -> operate -> actuate cycle, so a
+ *              hang anywhere in that path (SPI timeouts, Error_Handler with
+ *              IRQs disabled) resets the MCU within WATCHDOG_TIMEOUT_MS. At
+ *              reset every pin returns to a floating input: the SSR inputs
+ *              need their pull-downs for the heaters to stay off.
+ */
+
+#ifndef INC_WATCHDOG_H_
+#define INC_WATCHDOG_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define WATCHDOG_TIMEOUT_MS       1000u /* Longest gap between two control cycles (4 ticks at 4 Hz) */
+#define WATCHDOG_FLASH_TIMEOUT_MS 4000u /* While erasing a 128 KB flash sector (2 s max, CPU stalled) */
+/* The LSI may run anywhere in 17..47 kHz: the real timeout is 0.7..1.9 times the nominal one */
+
+/*************************
+ *  Function Prototypes
+ *************************/
+
+/**
+ * @brief Start the IWDG; it cannot be stopped again until the next reset
+ *
+ * The counter is frozen while the core is halted by a debugger.
+ *
+ * @param timeoutMs Reset timeout (ms), up to 4095
+ */
+void Watchdog_Init(uint32_t timeoutMs);
+
+/**
+ * @brief Change the reset timeout of the running IWDG and feed it
+ *
+ * @param timeoutMs Reset timeout (ms), up to 4095
+ */
+void Watchdog_setTimeout(uint32_t timeoutMs);
+
+/**
+ * @brief Reload the IWDG counter
+ */
+void Watchdog_feed(void);
+
+/**
+ * @brief Whether the last reset was caused by the IWDG; clears the reset flags
+ *
+ * Call once at boot, before anything else reads RCC->CSR.
+ *
+ * @return bool - True after a watchdog reset
+ */
+bool Watchdog_causedReset(void);
+
+#endif /* INC_WATCHDOG_H_ */
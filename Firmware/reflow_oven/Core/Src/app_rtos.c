@@ -0,0 +1,216 @@
+/*
+ * app_rtos.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the FreeRTOS task set. Compiled empty in
+ *              the bare-metal build.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "app_rtos.h"
+
+#if REFLOW_USE_RTOS
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static const AppRtos_config_t *appRtos_config;
+static uint32_t appRtos_tickOffset;     /* HAL tick when the kernel took over the time base */
+static volatile uint32_t appRtos_droppedTicks;
+
+// Queues
+static QueueHandle_t appRtos_sampleQueue;
+static StaticQueue_t appRtos_sampleQueueCtrl;
+static uint8_t appRtos_sampleQueueStorage[APPRTOS_SAMPLE_QUEUE_LEN * sizeof(AppRtos_sample_t)];
+
+static QueueHandle_t appRtos_tickQueue;
+static StaticQueue_t appRtos_tickQueueCtrl;
+static uint8_t appRtos_tickQueueStorage[APPRTOS_TICK_QUEUE_LEN * sizeof(uint32_t)];
+
+// Tasks
+static StaticTask_t appRtos_acqTcb;
+static StackType_t appRtos_acqStack[APPRTOS_ACQ_STACK];
+static StaticTask_t appRtos_controlTcb;
+static StackType_t appRtos_controlStack[APPRTOS_CONTROL_STACK];
+static StaticTask_t appRtos_guiTcb;
+static StackType_t appRtos_guiStack[APPRTOS_GUI_STACK];
+static StaticTask_t appRtos_telemetryTcb;
+static StackType_t appRtos_telemetryStack[APPRTOS_TELEMETRY_STACK];
+static StaticTask_t appRtos_idleTcb;
+static StackType_t appRtos_idleStack[configMINIMAL_STACK_SIZE];
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+static void AppRtos_acquisitionTask(void *argument);
+static void AppRtos_controlTask(void *argument);
+static void AppRtos_guiTask(void *argument);
+static void AppRtos_telemetryTask(void *argument);
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void AppRtos_start(const AppRtos_config_t *config)
+{
+    appRtos_config = config;
+
+    appRtos_sampleQueue = xQueueCreateStatic(APPRTOS_SAMPLE_QUEUE_LEN, sizeof(AppRtos_sample_t),
+                                             appRtos_sampleQueueStorage, &appRtos_sampleQueueCtrl);
+    appRtos_tickQueue = xQueueCreateStatic(APPRTOS_TICK_QUEUE_LEN, sizeof(uint32_t),
+                                           appRtos_tickQueueStorage, &appRtos_tickQueueCtrl);
+
+    xTaskCreateStatic(AppRtos_controlTask, "control", APPRTOS_CONTROL_STACK, NULL,
+                      APPRTOS_CONTROL_PRIO, appRtos_controlStack, &appRtos_controlTcb);
+    xTaskCreateStatic(AppRtos_acquisitionTask, "acq", APPRTOS_ACQ_STACK, NULL,
+                      APPRTOS_ACQ_PRIO, appRtos_acqStack, &appRtos_acqTcb);
+    xTaskCreateStatic(AppRtos_guiTask, "gui", APPRTOS_GUI_STACK, NULL,
+                      APPRTOS_GUI_PRIO, appRtos_guiStack, &appRtos_guiTcb);
+    xTaskCreateStatic(AppRtos_telemetryTask, "telem", APPRTOS_TELEMETRY_STACK, NULL,
+                      APPRTOS_TELEMETRY_PRIO, appRtos_telemetryStack, &appRtos_telemetryTcb);
+
+    // The kernel tick restarts from 0: keep HAL_GetTick continuous across the hand-over
+    appRtos_tickOffset = uwTick;
+    vTaskStartScheduler();
+
+    // Only reached when the kernel could not start
+    Error_Handler();
+}
+
+uint32_t AppRtos_getDroppedTicks(void)
+{
+    return appRtos_droppedTicks;
+}
+
+/*
+ * HAL time base. With tickless idle SysTick stops while the CPU sleeps and
+ * HAL_IncTick would miss those ticks, so once the kernel runs its tick count
+ * (corrected for the sleep) is the time base.
+ */
+uint32_t HAL_GetTick(void)
+{
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        return uwTick;
+    }
+    return appRtos_tickOffset + (uint32_t)xTaskGetTickCount();
+}
+
+/*
+ * Blocking delays (MAX6675 conversion gaps, LCD) yield to the other tasks
+ * instead of spinning once the kernel runs.
+ */
+void HAL_Delay(uint32_t Delay)
+{
+    uint32_t start;
+
+    if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        // HAL semantics: at least Delay full milliseconds
+        vTaskDelay(pdMS_TO_TICKS(Delay) + 1);
+        return;
+    }
+    start = HAL_GetTick();
+    while ((HAL_GetTick() - start) <= Delay) {
+    }
+}
+
+// Kernel hooks
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &appRtos_idleTcb;
+    *ppxIdleTaskStackBuffer = appRtos_idleStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
+{
+    // Memory may already be corrupt: heaters off and halt, the watchdog resets
+    Error_Handler();
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ ******************************************************************************/
+/**
+ * @brief Read the probes every control period and hand the sample to control
+ *
+ * @param argument Unused
+ */
+static void AppRtos_acquisitionTask(void *argument)
+{
+    TickType_t lastWake = xTaskGetTickCount();
+    AppRtos_sample_t sample;
+
+    for (;;) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(APPRTOS_CONTROL_PERIOD_MS));
+
+        sample.timeMs = appRtos_tickOffset + (uint32_t)lastWake;
+        appRtos_config->acquire(&sample);
+
+        // Control is more urgent and drains the queue at once; a full queue means it is hung
+        xQueueSend(appRtos_sampleQueue, &sample, 0);
+    }
+}
+
+/**
+ * @brief Run one control step per sample, then release the telemetry task
+ *
+ * @param argument Unused
+ */
+static void AppRtos_controlTask(void *argument)
+{
+    AppRtos_sample_t sample;
+
+    for (;;) {
+        if (xQueueReceive(appRtos_sampleQueue, &sample, portMAX_DELAY) != pdPASS) {
+            continue;
+        }
+        appRtos_config->control(&sample);
+
+        if (xQueueSend(appRtos_tickQueue, &sample.timeMs, 0) != pdPASS) {
+            appRtos_droppedTicks++;
+        }
+    }
+}
+
+/**
+ * @brief Poll the encoder and run the page handlers
+ *
+ * @param argument Unused
+ */
+static void AppRtos_guiTask(void *argument)
+{
+    TickType_t lastWake = xTaskGetTickCount();
+
+    for (;;) {
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(APPRTOS_GUI_PERIOD_MS));
+        appRtos_config->gui(appRtos_tickOffset + (uint32_t)lastWake);
+    }
+}
+
+/**
+ * @brief Log and report every completed control tick
+ *
+ * @param argument Unused
+ */
+static void AppRtos_telemetryTask(void *argument)
+{
+    uint32_t nowMs;
+
+    for (;;) {
+        if (xQueueReceive(appRtos_tickQueue, &nowMs, portMAX_DELAY) != pdPASS) {
+            continue;
+        }
+        appRtos_config->logging(nowMs);
+        appRtos_config->telemetry(nowMs);
+    }
+}
+
+#endif /* REFLOW_USE_RTOS */
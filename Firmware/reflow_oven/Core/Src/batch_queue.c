@@ -0,0 +1,311 @@
+/*
+ * batch_queue.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the batch mode queue.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <string.h>
+#include "batch_queue.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static BatchQueue_entry_t batch_entries[BATCH_MAX_ENTRIES];
+static uint8_t batch_numEntries;
+static uint8_t batch_entryIndex;      /* Entry of the current board */
+static uint8_t batch_entryBoardsDone; /* Boards of the current entry already finished */
+static uint8_t batch_totalBoards;     /* Boards queued over all entries */
+
+static RunRecorder_summary_t batch_boards[BATCH_MAX_BOARDS];
+static uint8_t batch_boardCount;
+
+static BatchQueue_state_t batch_state;
+static bool batch_boardActive;        /* The current board left IDLE/STANDBY */
+static uint32_t batch_startMs;
+static uint32_t batch_lastBoardMs;
+static float batch_unloadTemperature = BATCH_DEFAULT_UNLOAD_TEMP;
+static ReflowOven_parameters_t batch_savedProfile; /* Operator profile restored at the end */
+
+/* Events for the telemetry task; a full queue drops the newest */
+static BatchQueue_report_t batch_reports[BATCH_REPORT_SLOTS];
+static volatile uint8_t batch_reportHead;
+static volatile uint8_t batch_reportTail;
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+static bool BatchQueue_startBoard(void);
+static void BatchQueue_finish(uint32_t currentTimeMs, BatchQueue_reportType_t reason);
+static void BatchQueue_queueReport(const BatchQueue_report_t *report);
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void BatchQueue_Init(void)
+{
+    batch_numEntries = 0;
+    batch_entryIndex = 0;
+    batch_entryBoardsDone = 0;
+    batch_totalBoards = 0;
+    batch_boardCount = 0;
+    batch_state = BATCH_IDLE;
+    batch_boardActive = false;
+}
+
+bool BatchQueue_add(const ReflowOven_parameters_t *profile, uint8_t count)
+{
+    // A new queue after a finished batch starts empty
+    if (batch_state != BATCH_IDLE || count == 0 || batch_numEntries >= BATCH_MAX_ENTRIES ||
+        (batch_totalBoards + count) > BATCH_MAX_BOARDS) {
+        return false;
+    }
+
+    batch_entries[batch_numEntries].profile = *profile;
+    batch_entries[batch_numEntries].count = count;
+    batch_numEntries++;
+    batch_totalBoards += count;
+    return true;
+}
+
+bool BatchQueue_setUnloadTemperature(float temperature)
+{
+    if (batch_state != BATCH_IDLE || temperature < 40.0f || temperature > 100.0f) {
+        return false;
+    }
+
+    batch_unloadTemperature = temperature;
+    return true;
+}
+
+bool BatchQueue_start(uint32_t currentTimeMs)
+{
+    BatchQueue_report_t report = {.type = BATCH_REPORT_START};
+
+    if (batch_state != BATCH_IDLE || batch_numEntries == 0 ||
+        ReflowOven_getCurrentPhase() < REFLOW_IDLE) {
+        return false;
+    }
+
+    batch_savedProfile = ReflowOven.ReflowParameters;
+    batch_entryIndex = 0;
+    batch_entryBoardsDone = 0;
+    batch_boardCount = 0;
+    batch_startMs = currentTimeMs;
+    batch_lastBoardMs = currentTimeMs;
+
+    if (!BatchQueue_startBoard()) {
+        ReflowOven_loadProfile(&batch_savedProfile);
+        return false;
+    }
+    report.boards = batch_totalBoards;
+    report.entries = batch_numEntries;
+    BatchQueue_queueReport(&report);
+    return true;
+}
+
+bool BatchQueue_confirm(void)
+{
+    if (batch_state != BATCH_WAIT_CONFIRM) {
+        return false;
+    }
+    return BatchQueue_startBoard();
+}
+
+void BatchQueue_abort(void)
+{
+    if (batch_state == BATCH_IDLE) {
+        return;
+    }
+
+    // Nothing left after the current board
+    batch_numEntries = batch_entryIndex + 1;
+    batch_entries[batch_entryIndex].count = batch_entryBoardsDone;
+
+    if (batch_state == BATCH_RUNNING && batch_boardActive) {
+        // The board cools down and BatchQueue_update() closes the batch
+        ReflowOven_stopProcess();
+    } else {
+        // Start still pending or waiting for the operator
+        ReflowOven_stopProcess();
+        BatchQueue_finish(batch_lastBoardMs, BATCH_REPORT_ABORT);
+    }
+}
+
+void BatchQueue_update(uint32_t currentTimeMs)
+{
+    const RunRecorder_summary_t *summary;
+    BatchQueue_report_t report = {.type = BATCH_REPORT_BOARD};
+
+    if (batch_state != BATCH_RUNNING) {
+        return;
+    }
+
+    // Wait for the board to go through its profile (start is applied on the next tick)
+    if (ReflowOven_getCurrentPhase() < REFLOW_IDLE) {
+        batch_boardActive = true;
+        return;
+    }
+    if (!batch_boardActive) {
+        return;
+    }
+
+    // Board finished: the recorder closed its run on this same tick
+    batch_boardActive = false;
+    batch_lastBoardMs = currentTimeMs;
+    summary = RunRecorder_getSummary();
+    batch_boards[batch_boardCount++] = *summary;
+
+    report.boards = batch_boardCount;
+    report.entries = batch_entryIndex;
+    report.endReason = summary->endReason;
+    report.durationS = summary->durationMs * 0.001f;
+    report.peakTemperature = summary->peakTemperature;
+    report.timeAboveLiquidusS = summary->timeAboveLiquidusS;
+    report.zoneSpreadMax = summary->zoneSpreadMax;
+    report.energyWh = summary->energyWh;
+    BatchQueue_queueReport(&report);
+
+    if (summary->endReason != RUNREC_END_COMPLETED) {
+        BatchQueue_finish(currentTimeMs, BATCH_REPORT_ABORT);
+        return;
+    }
+
+    // Move on to the next board of the queue
+    batch_entryBoardsDone++;
+    if (batch_entryBoardsDone >= batch_entries[batch_entryIndex].count) {
+        batch_entryIndex++;
+        batch_entryBoardsDone = 0;
+    }
+    if (batch_entryIndex >= batch_numEntries) {
+        BatchQueue_finish(currentTimeMs, BATCH_REPORT_END);
+        return;
+    }
+
+    batch_state = BATCH_WAIT_CONFIRM;
+    report.type = BATCH_REPORT_WAIT;
+    report.entries = batch_totalBoards;
+    report.boardsPerHour = BatchQueue_getBoardsPerHour(currentTimeMs);
+    BatchQueue_queueReport(&report);
+}
+
+BatchQueue_state_t BatchQueue_getState(void)
+{
+    return batch_state;
+}
+
+float BatchQueue_getBoardsPerHour(uint32_t currentTimeMs)
+{
+    uint32_t elapsedMs;
+
+    if (batch_boardCount == 0) {
+        return 0.0f;
+    }
+
+    // A finished batch keeps the rate it had at its last board
+    elapsedMs = ((batch_state == BATCH_IDLE) ? batch_lastBoardMs : currentTimeMs) - batch_startMs;
+    if (elapsedMs == 0) {
+        return 0.0f;
+    }
+    return batch_boardCount * 3600000.0f / elapsedMs;
+}
+
+uint8_t BatchQueue_getBoardCount(void)
+{
+    return batch_boardCount;
+}
+
+const RunRecorder_summary_t *BatchQueue_getBoardSummary(uint8_t board)
+{
+    if (board >= batch_boardCount) {
+        return NULL;
+    }
+    return &batch_boards[board];
+}
+
+bool BatchQueue_getReport(BatchQueue_report_t *report)
+{
+    if (batch_reportTail == batch_reportHead) {
+        return false;
+    }
+    *report = batch_reports[batch_reportTail % BATCH_REPORT_SLOTS];
+    batch_reportTail++;
+    return true;
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Load the profile of the next board and start it
+ *
+ * The board only cools to the unload temperature and the oven then holds it
+ * (warm standby), so the next preheat joins its ramp warm.
+ *
+ * @return bool - True if the board started
+ */
+static bool BatchQueue_startBoard(void)
+{
+    ReflowOven_parameters_t profile = batch_entries[batch_entryIndex].profile;
+
+    if (profile.CoolDownTempeture < batch_unloadTemperature) {
+        profile.CoolDownTempeture = batch_unloadTemperature;
+    }
+    profile.StandbyTempeture = batch_unloadTemperature;
+
+    if (!ReflowOven_loadProfile(&profile) || !ReflowOven_startProcess()) {
+        return false;
+    }
+    batch_boardActive = false;
+    batch_state = BATCH_RUNNING;
+    return true;
+}
+
+/**
+ * @brief Close the batch and give the oven back the operator's profile
+ *
+ * @param currentTimeMs Time of the batch end (ms)
+ * @param reason BATCH_REPORT_END or BATCH_REPORT_ABORT
+ */
+static void BatchQueue_finish(uint32_t currentTimeMs, BatchQueue_reportType_t reason)
+{
+    BatchQueue_report_t report = {.type = reason};
+
+    batch_state = BATCH_IDLE;
+    batch_lastBoardMs = currentTimeMs;
+    batch_numEntries = 0;
+    batch_totalBoards = 0;
+
+    ReflowOven_loadProfile(&batch_savedProfile);
+    // Leave the unload hold unless the operator runs warm standby anyway
+    if (ReflowOven_getCurrentPhase() == REFLOW_STANDBY && batch_savedProfile.StandbyTempeture == 0.0f) {
+        ReflowOven_stopProcess();
+    }
+
+    report.boards = batch_boardCount;
+    report.boardsPerHour = BatchQueue_getBoardsPerHour(currentTimeMs);
+    BatchQueue_queueReport(&report);
+}
+
+/**
+ * @brief Queue an event for the telemetry task
+ *
+ * Never blocks: the caller may be the control step. The slot is filled
+ * before it is published, and an event that finds the queue full is dropped.
+ *
+ * @param report Event to report
+ */
+static void BatchQueue_queueReport(const BatchQueue_report_t *report)
+{
+    if ((uint8_t)(batch_reportHead - batch_reportTail) >= BATCH_REPORT_SLOTS) {
+        return;
+    }
+    batch_reports[batch_reportHead % BATCH_REPORT_SLOTS] = *report;
+    batch_reportHead++;
+}
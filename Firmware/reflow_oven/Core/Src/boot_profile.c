@@ -0,0 +1,86 @@
+/*
+ * boot_profile.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the startup profile.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "boot_profile.h"
+#include "dwt.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static const char *const bootProfile_names[BOOT_NUM_STEPS] = {
+    [BOOT_STEP_SAFE_STATE] = "safe",
+    [BOOT_STEP_HAL] = "hal",
+    [BOOT_STEP_WATCHDOG] = "watchdog",
+    [BOOT_STEP_CLOCK] = "clock",
+    [BOOT_STEP_PERIPHERALS] = "periph",
+    [BOOT_STEP_SENSORS] = "sensors",
+    [BOOT_STEP_MODULES] = "modules",
+    [BOOT_STEP_ACTUATORS] = "actuators",
+    [BOOT_STEP_SCHEDULER] = "sched",
+    [BOOT_STEP_FIRST_SAMPLE] = "sample",
+};
+
+static volatile uint32_t bootProfile_us[BOOT_NUM_STEPS];
+static volatile uint32_t bootProfile_marked;  /* Bit per marked step, set after its time */
+static uint32_t bootProfile_elapsedUs;        /* Since main() up to the last mark */
+static uint32_t bootProfile_lastCycles;       /* DWT stamp of the last mark */
+static uint32_t bootProfile_lastMs;           /* HAL tick of the last mark */
+static uint32_t bootProfile_cyclesPerUs;      /* Core clock in force since the last mark */
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void BootProfile_Init(void)
+{
+    bootProfile_marked = 0;
+    bootProfile_elapsedUs = 0;
+    bootProfile_lastCycles = DWT_getCycles();
+    bootProfile_lastMs = HAL_GetTick();
+    bootProfile_cyclesPerUs = SystemCoreClock / 1000000u;
+}
+
+void BootProfile_mark(BootProfile_step_t step)
+{
+    uint32_t cycles = DWT_getCycles();
+    uint32_t nowMs = HAL_GetTick();
+
+    if (step >= BOOT_NUM_STEPS || (bootProfile_marked & (1u << step)) != 0) {
+        return;
+    }
+
+    // Counted at the clock of the previous mark; past the counter span, in whole ticks
+    if (nowMs - bootProfile_lastMs < BOOT_PROFILE_CYCLES_SPAN_MS) {
+        bootProfile_elapsedUs += (cycles - bootProfile_lastCycles) / bootProfile_cyclesPerUs;
+    } else {
+        bootProfile_elapsedUs += (nowMs - bootProfile_lastMs) * 1000u;
+    }
+    bootProfile_lastCycles = cycles;
+    bootProfile_lastMs = nowMs;
+    bootProfile_cyclesPerUs = SystemCoreClock / 1000000u;
+
+    bootProfile_us[step] = bootProfile_elapsedUs;
+    bootProfile_marked |= 1u << step;
+}
+
+bool BootProfile_get(BootProfile_step_t step, uint32_t *us)
+{
+    if (step >= BOOT_NUM_STEPS || (bootProfile_marked & (1u << step)) == 0) {
+        return false;
+    }
+    *us = bootProfile_us[step];
+    return true;
+}
+
+const char *BootProfile_getName(BootProfile_step_t step)
+{
+    return (step < BOOT_NUM_STEPS) ? bootProfile_names[step] : "?";
+}
@@ -0,0 +1,53 @@
+/*
+ * chamber_model.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the shared chamber model.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "chamber_model.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static float chamberModel_gain = CHAMBER_REF_GAIN;
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void ChamberModel_Init(void)
+{
+    chamberModel_gain = CHAMBER_REF_GAIN;
+}
+
+void ChamberModel_setGain(float gain)
+{
+    if (gain > 0.0f) {
+        chamberModel_gain = gain;
+    }
+}
+
+float ChamberModel_getGain(void)
+{
+    return chamberModel_gain;
+}
+
+float ChamberModel_losses(float temperature)
+{
+    return (temperature - CHAMBER_AMBIENT) / CHAMBER_TAU;
+}
+
+float ChamberModel_slope(float power, float temperature)
+{
+    return chamberModel_gain * power * 0.01f - ChamberModel_losses(temperature);
+}
+
+float ChamberModel_solveGain(float slope, float power, float temperature)
+{
+    return (slope + ChamberModel_losses(temperature)) * 100.0f / power;
+}
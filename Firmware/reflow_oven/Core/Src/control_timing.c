@@ -0,0 +1,196 @@
+/*
+ * control_timing.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the control-loop timing monitor. The
+ *              release side only sets the pending stamp or counts a miss, the
+ *              cycle side only clears the pending flag, so the ISR and the
+ *              control loop never update the same field.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <math.h>
+#include "control_timing.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static uint32_t controlTiming_periodUs;
+static uint32_t controlTiming_cyclesPerUs;
+static uint32_t controlTiming_deadlineUs;
+static uint8_t controlTiming_maxMisses;
+
+// Release side (ISR)
+static volatile bool controlTiming_pending;          /* Released, not ended yet */
+static volatile uint32_t controlTiming_releaseCycles; /* Stamp of the pending release */
+static volatile uint32_t controlTiming_missed;
+
+// Cycle side
+static uint32_t controlTiming_missedSeen;             /* Misses already counted in a row */
+static uint8_t controlTiming_inRow;                   /* Misses and overruns in a row */
+static uint32_t controlTiming_overruns;
+
+// Figures since the last reset
+static bool controlTiming_hasStamp;
+static uint32_t controlTiming_lastCycles;
+static uint32_t controlTiming_intervals;
+static float controlTiming_minDeviation;
+static float controlTiming_maxDeviation;
+static float controlTiming_sumSquares;
+static uint32_t controlTiming_latencies;
+static float controlTiming_minLatency;
+static float controlTiming_maxLatency;
+static float controlTiming_maxResponse;
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+static float ControlTiming_toUs(uint32_t cycles);
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void ControlTiming_Init(uint32_t periodUs, uint32_t cyclesPerUs)
+{
+    controlTiming_periodUs = periodUs;
+    controlTiming_cyclesPerUs = (cyclesPerUs > 0) ? cyclesPerUs : 1;
+    controlTiming_deadlineUs = CONTROLTIMING_DEADLINE_US;
+    controlTiming_maxMisses = CONTROLTIMING_MAX_MISSES;
+
+    controlTiming_pending = false;
+    controlTiming_missed = 0;
+    controlTiming_missedSeen = 0;
+    controlTiming_inRow = 0;
+    controlTiming_overruns = 0;
+    ControlTiming_reset();
+}
+
+void ControlTiming_setLimits(uint32_t deadlineUs, uint8_t maxMisses)
+{
+    controlTiming_deadlineUs = deadlineUs;
+    controlTiming_maxMisses = maxMisses;
+}
+
+void ControlTiming_release(uint32_t cycles)
+{
+    // Previous cycle still running: keep its stamp, the new release is lost
+    if (controlTiming_pending) {
+        controlTiming_missed++;
+        return;
+    }
+    controlTiming_releaseCycles = cycles;
+    controlTiming_pending = true;
+}
+
+void ControlTiming_start(uint32_t cycles)
+{
+    float deviation, latency;
+
+    if (controlTiming_hasStamp) {
+        // Unsigned difference is wrap-safe; at 100 MHz the counter wraps every 42 s
+        deviation = ControlTiming_toUs(cycles - controlTiming_lastCycles) - (float)controlTiming_periodUs;
+
+        if (controlTiming_intervals == 0 || deviation < controlTiming_minDeviation) {
+            controlTiming_minDeviation = deviation;
+        }
+        if (controlTiming_intervals == 0 || deviation > controlTiming_maxDeviation) {
+            controlTiming_maxDeviation = deviation;
+        }
+        controlTiming_sumSquares += deviation * deviation;
+        controlTiming_intervals++;
+    }
+    controlTiming_lastCycles = cycles;
+    controlTiming_hasStamp = true;
+
+    if (!controlTiming_pending) {
+        return; // Started without a release (first cycle): no latency
+    }
+    latency = ControlTiming_toUs(cycles - controlTiming_releaseCycles);
+    if (controlTiming_latencies == 0 || latency < controlTiming_minLatency) {
+        controlTiming_minLatency = latency;
+    }
+    if (latency > controlTiming_maxLatency) {
+        controlTiming_maxLatency = latency;
+    }
+    controlTiming_latencies++;
+}
+
+void ControlTiming_end(uint32_t cycles)
+{
+    uint32_t missed = controlTiming_missed;
+    uint32_t newMisses = missed - controlTiming_missedSeen;
+    bool late = false;
+    uint32_t inRow;
+    float response;
+
+    if (controlTiming_pending) {
+        response = ControlTiming_toUs(cycles - controlTiming_releaseCycles);
+        if (response > controlTiming_maxResponse) {
+            controlTiming_maxResponse = response;
+        }
+        late = response > (float)controlTiming_deadlineUs;
+        controlTiming_pending = false;
+    }
+    if (late) {
+        controlTiming_overruns++;
+    }
+
+    // Misses counted by the ISR during this cycle and a late end both add to the run
+    controlTiming_missedSeen = missed;
+    if (newMisses == 0 && !late) {
+        controlTiming_inRow = 0;
+        return;
+    }
+    inRow = controlTiming_inRow + newMisses + (late ? 1u : 0u);
+    controlTiming_inRow = (inRow > UINT8_MAX) ? UINT8_MAX : (uint8_t)inRow;
+}
+
+bool ControlTiming_isTripped(void)
+{
+    return controlTiming_maxMisses > 0 && controlTiming_inRow >= controlTiming_maxMisses;
+}
+
+void ControlTiming_get(ControlTiming_stats_t *stats)
+{
+    stats->intervals = controlTiming_intervals;
+    stats->minDeviationUs = controlTiming_minDeviation;
+    stats->maxDeviationUs = controlTiming_maxDeviation;
+    stats->rmsDeviationUs = (controlTiming_intervals > 0) ? sqrtf(controlTiming_sumSquares / controlTiming_intervals)
+                                                          : 0.0f;
+    stats->minLatencyUs = controlTiming_minLatency;
+    stats->maxLatencyUs = controlTiming_maxLatency;
+    stats->maxResponseUs = controlTiming_maxResponse;
+    stats->missed = controlTiming_missed;
+    stats->overruns = controlTiming_overruns;
+}
+
+void ControlTiming_reset(void)
+{
+    controlTiming_hasStamp = false;
+    controlTiming_intervals = 0;
+    controlTiming_minDeviation = 0.0f;
+    controlTiming_maxDeviation = 0.0f;
+    controlTiming_sumSquares = 0.0f;
+    controlTiming_latencies = 0;
+    controlTiming_minLatency = 0.0f;
+    controlTiming_maxLatency = 0.0f;
+    controlTiming_maxResponse = 0.0f;
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ ******************************************************************************/
+/**
+ * @brief Convert a cycle count to microseconds
+ *
+ * @param cycles Cycle count
+ * @return float - Microseconds
+ */
+static float ControlTiming_toUs(uint32_t cycles)
+{
+    return (float)cycles / controlTiming_cyclesPerUs;
+}
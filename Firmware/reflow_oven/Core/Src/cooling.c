@@ -0,0 +1,79 @@
+/*
+ * cooling.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the forced cooling controller.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "cooling.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static PIDController coolingPID;
+static float cooling_demand;
+static bool cooling_active;
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void Cooling_Init(float samplePeriod)
+{
+    PID_Init(&coolingPID,
+             10.0f,                // kp: % per °C above the ramp
+             0.5f,                 // ki
+             0.0f,                 // kd
+             0.5f,                 // tau
+             0.0f,                 // limMIN
+             100.0f,               // limMAX
+             0.0f,                 // limMinInt
+             100.0f,               // limMaxInt
+             samplePeriod);        // tsample
+    cooling_demand = 0.0f;
+    cooling_active = false;
+}
+
+float Cooling_update(ReflowPhases_t phase, float setpoint, float temperature, bool heaterOff)
+{
+    // Split range: cool only during cooldown and only while the heaters are saturated at zero
+    if (phase != REFLOW_COOLDOWN || !heaterOff) {
+        if (cooling_active) {
+            PID_Reset(&coolingPID);
+            cooling_active = false;
+        }
+        cooling_demand = 0.0f;
+        return cooling_demand;
+    }
+    cooling_active = true;
+
+    // Reverse acting: negate both so the error is (temperature - setpoint)
+    PID_Update(&coolingPID, -setpoint, -temperature);
+    cooling_demand = coolingPID.out;
+    return cooling_demand;
+}
+
+float Cooling_getFanDuty(void)
+{
+    if (cooling_demand >= COOLING_FAN_SPLIT) {
+        return 100.0f;
+    }
+    return cooling_demand * (100.0f / COOLING_FAN_SPLIT);
+}
+
+float Cooling_getDoorOpening(void)
+{
+    if (cooling_demand <= COOLING_FAN_SPLIT) {
+        return 0.0f;
+    }
+    return (cooling_demand - COOLING_FAN_SPLIT) * (100.0f / (100.0f - COOLING_FAN_SPLIT));
+}
+
+PIDController *Cooling_getController(void)
+{
+    return &coolingPID;
+}
@@ -0,0 +1,84 @@
+/*
+ * cpu_load.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the sleep-based CPU load metric.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "cpu_load.h"
+#include "dwt.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static uint32_t cpuLoad_cyclesPerMs;
+static uint32_t cpuLoad_windowMs;       /* Start of the window (ms) */
+static uint32_t cpuLoad_windowCycles;   /* DWT stamp at the start of the window */
+static uint32_t cpuLoad_sleepStart;     /* DWT stamp of the sleep in progress */
+static uint32_t cpuLoad_sleepCycles;    /* Cycles stamped asleep in the window */
+static uint32_t cpuLoad_wakeups;
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void CpuLoad_Init(uint32_t nowMs, uint32_t cyclesPerMs)
+{
+    cpuLoad_cyclesPerMs = cyclesPerMs;
+    cpuLoad_windowMs = nowMs;
+    cpuLoad_windowCycles = DWT_getCycles();
+    cpuLoad_sleepCycles = 0;
+    cpuLoad_wakeups = 0;
+}
+
+void CpuLoad_sleep(void)
+{
+    CpuLoad_sleepBegin();
+    __DSB();
+    __WFI();
+    CpuLoad_sleepEnd();
+}
+
+void CpuLoad_sleepBegin(void)
+{
+    cpuLoad_sleepStart = DWT_getCycles();
+}
+
+void CpuLoad_sleepEnd(void)
+{
+    cpuLoad_sleepCycles += DWT_getCycles() - cpuLoad_sleepStart;
+    cpuLoad_wakeups++;
+}
+
+void CpuLoad_update(uint32_t nowMs, CpuLoad_stats_t *stats)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t cycles, sleepCycles, wakeups, awake;
+    float window;
+
+    // Close the window atomically against a sleep ending in an interrupt
+    __disable_irq();
+    cycles = DWT_getCycles();
+    sleepCycles = cpuLoad_sleepCycles;
+    wakeups = cpuLoad_wakeups;
+    cpuLoad_sleepCycles = 0;
+    cpuLoad_wakeups = 0;
+    __set_PRIMASK(primask);
+
+    stats->windowMs = nowMs - cpuLoad_windowMs;
+    stats->wakeups = wakeups;
+    window = (float)stats->windowMs * cpuLoad_cyclesPerMs;
+    awake = (cycles - cpuLoad_windowCycles) - sleepCycles;
+    stats->loadPct = (window > 0.0f) ? 100.0f * awake / window : 0.0f;
+    if (stats->loadPct > 100.0f) {
+        stats->loadPct = 100.0f;
+    }
+    stats->idlePct = 100.0f - stats->loadPct;
+
+    cpuLoad_windowMs = nowMs;
+    cpuLoad_windowCycles = cycles;
+}
@@ -0,0 +1,56 @@
+/*
+ * double_buffer.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the double-buffered handoff.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdatomic.h>
+#include <string.h>
+#include "double_buffer.h"
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void DoubleBuffer_Init(DoubleBuffer_t *buffer, void *slotA, void *slotB, size_t size)
+{
+    buffer->slots[0] = slotA;
+    buffer->slots[1] = slotB;
+    buffer->size = size;
+    buffer->front = 0;
+    buffer->sequence = 0;
+    memcpy(slotB, slotA, size);
+}
+
+void *DoubleBuffer_back(DoubleBuffer_t *buffer)
+{
+    return buffer->slots[buffer->front ^ 1u];
+}
+
+void DoubleBuffer_publish(DoubleBuffer_t *buffer)
+{
+    // The slot must be complete before the reader can switch to it
+    atomic_thread_fence(memory_order_release);
+    buffer->front ^= 1u;
+    buffer->sequence++;
+}
+
+bool DoubleBuffer_read(DoubleBuffer_t *buffer, void *value, uint32_t *seen)
+{
+    uint32_t sequence = buffer->sequence;
+
+    if (sequence == *seen) {
+        return false;
+    }
+
+    // Read the slot only after seeing the index that published it
+    atomic_thread_fence(memory_order_acquire);
+    memcpy(value, buffer->slots[buffer->front], buffer->size);
+    *seen = sequence;
+    return true;
+}
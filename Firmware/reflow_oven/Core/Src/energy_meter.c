@@ -0,0 +1,94 @@
+/*
+ * energy_meter.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the heater energy meter.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "energy_meter.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Half-cycles fired per channel, only written by the zero-cross interrupt */
+static volatile uint32_t energy_halfCycles[ENERGY_MAX_CHANNELS];
+/* Counts already converted to energy, only touched by the control loop */
+static uint32_t energy_lastHalfCycles[ENERGY_MAX_CHANNELS];
+static float energy_channelWatts[ENERGY_MAX_CHANNELS];
+static float energy_tickWh;
+static float energy_totalWh;
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void EnergyMeter_Init(void)
+{
+    uint8_t channel;
+
+    for (channel = 0; channel < ENERGY_MAX_CHANNELS; channel++) {
+        energy_halfCycles[channel] = 0;
+        energy_lastHalfCycles[channel] = 0;
+        energy_channelWatts[channel] = 0.0f;
+    }
+    energy_tickWh = 0.0f;
+    energy_totalWh = 0.0f;
+}
+
+void EnergyMeter_setChannelPower(uint8_t channel, float watts)
+{
+    if (channel < ENERGY_MAX_CHANNELS) {
+        energy_channelWatts[channel] = watts;
+    }
+}
+
+void EnergyMeter_onHalfCycle(uint8_t firedMask)
+{
+    uint8_t channel;
+
+    for (channel = 0; channel < ENERGY_MAX_CHANNELS && firedMask != 0; channel++, firedMask >>= 1) {
+        if (firedMask & 1u) {
+            energy_halfCycles[channel]++;
+        }
+    }
+}
+
+float EnergyMeter_update(float halfCyclesPerSecond)
+{
+    float wattHalfCycles = 0.0f;
+    uint8_t channel;
+
+    for (channel = 0; channel < ENERGY_MAX_CHANNELS; channel++) {
+        // Single word read: consistent against the interrupt, the difference survives the wrap
+        uint32_t count = energy_halfCycles[channel];
+        wattHalfCycles += (count - energy_lastHalfCycles[channel]) * energy_channelWatts[channel];
+        energy_lastHalfCycles[channel] = count;
+    }
+
+    // W x half-cycles / (half-cycles/s) = J, and 3600 J per Wh
+    energy_tickWh = (halfCyclesPerSecond > 0.0f) ? wattHalfCycles / (halfCyclesPerSecond * 3600.0f) : 0.0f;
+    energy_totalWh += energy_tickWh;
+    return energy_tickWh;
+}
+
+float EnergyMeter_getTickEnergyWh(void)
+{
+    return energy_tickWh;
+}
+
+float EnergyMeter_getTotalEnergyWh(void)
+{
+    return energy_totalWh;
+}
+
+uint32_t EnergyMeter_getHalfCycles(uint8_t channel)
+{
+    if (channel >= ENERGY_MAX_CHANNELS) {
+        return 0;
+    }
+    return energy_halfCycles[channel];
+}
@@ -0,0 +1,86 @@
+/*
+ * event_queue.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the SPSC event queues.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdatomic.h>
+#include "event_queue.h"
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void EventQueue_Init(EventQueue_t *queue, EventQueue_event_t *slots, uint16_t length)
+{
+    queue->slots = slots;
+    queue->mask = length - 1;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->overflows = 0;
+    queue->highWater = 0;
+}
+
+bool EventQueue_push(EventQueue_t *queue, EventQueue_type_t type, int32_t value, uint32_t cycles)
+{
+    uint16_t head = queue->head;
+    uint16_t next = (head + 1) & queue->mask;
+    uint16_t count;
+
+    if (next == queue->tail) {
+        queue->overflows++;
+        return false;
+    }
+
+    queue->slots[head].cycles = cycles;
+    queue->slots[head].value = value;
+    queue->slots[head].type = (uint8_t)type;
+
+    // The slot must be complete before the consumer can see it
+    atomic_thread_fence(memory_order_release);
+    queue->head = next;
+
+    count = (next - queue->tail) & queue->mask;
+    if (count > queue->highWater) {
+        queue->highWater = count;
+    }
+    return true;
+}
+
+bool EventQueue_pop(EventQueue_t *queue, EventQueue_event_t *event)
+{
+    uint16_t tail = queue->tail;
+
+    if (tail == queue->head) {
+        return false;
+    }
+
+    // Read the slot only after seeing the head that published it
+    atomic_thread_fence(memory_order_acquire);
+    *event = queue->slots[tail];
+
+    // And release the slot only once it has been copied out
+    atomic_thread_fence(memory_order_release);
+    queue->tail = (tail + 1) & queue->mask;
+    return true;
+}
+
+uint16_t EventQueue_getCount(const EventQueue_t *queue)
+{
+    return (queue->head - queue->tail) & queue->mask;
+}
+
+uint32_t EventQueue_getOverflows(const EventQueue_t *queue)
+{
+    return queue->overflows;
+}
+
+uint16_t EventQueue_getHighWater(const EventQueue_t *queue)
+{
+    return queue->highWater;
+}
@@ -9,6 +9,14 @@
  */
 
 #include "gui_backend.h"
+#include "batch_queue.h"
+#include "control_isr.h"
+#include "control_timing.h"
+#include "double_buffer.h"
+#include "dwt.h"
+#include "power_linearization.h"
+#include "reflow_oven_process.h"
+#include "thermal_fault.h"
 
 /******************************************************************************
  * PAGE STRUCTURE DEFINITIONS
@@ -17,7 +25,28 @@
 ui_page_t main_page_ui;
 ui_page_t oven_settings_page_ui;
 ui_page_t pid_settings_page_ui;
-ui_page_t ui_pages_arr[3];
+ui_page_t diagnostics_page_ui;
+ui_page_t ui_pages_arr[NUM_STATES];
+
+/* Values shown on the main page */
+float batch_size = 5;      /* Boards in the next batch */
+float boards_per_hour = 0; /* Throughput of the current/last batch */
+
+/* Values shown on the diagnostics page */
+float diag_jitter_ms = 0;                                  /* Worst period deviation */
+float diag_latency_ms = 0;                                 /* Worst release -> start */
+float diag_response_ms = 0;                                /* Worst release -> end */
+float diag_missed = 0;                                     /* Missed periods */
+float diag_overruns = 0;                                   /* Deadline overruns */
+float diag_deadline_ms = CONTROLTIMING_DEADLINE_US / 1000; /* Editable deadline */
+float diag_miss_limit = CONTROLTIMING_MAX_MISSES;          /* Editable trip limit */
+
+/* PID gains edited on the PID settings page; the control step takes them
+ * through a double-buffered handoff, never half-way through an edit */
+PIDGains pid_gains_edit = {0};        /* Values the page edits (PID_Init gains) */
+static PIDGains pid_gains_slots[2];   /* Handoff storage */
+static DoubleBuffer_t pid_gains_handoff;
+static uint32_t pid_gains_seen;       /* Last handoff taken by the control step */
 
 /******************************************************************************
  * ELEMENT DEFINITIONS FOR MAIN PAGE
@@ -49,6 +78,22 @@ ui_element_t ui_main_page_elements_arr[NUM_MAIN_PAGE_BTN] = {
     [PID_SETTINGS_BTN] = {
         .x = 21, .y = 6, .width = 20, .height = 5, .selectable = true, .selected = false, .editable = false, .value_ptr = NULL, .value_min = 0, .value_max = 0, .value_step = 0.0f, .label = "PID SETTINGS",
         //.draw_func  = draw_button
+    },
+    [BATCH_SIZE_BOX] = {
+        .x = 0, .y = 12, .width = 20, .height = 5, .selectable = true, .selected = false, .editable = true, .value_ptr = &batch_size, .value_min = 1, .value_max = BATCH_MAX_BOARDS, .value_step = 1.0f, .label = "BATCH SIZE",
+        //.draw_func  = draw_value_box
+    },
+    [BATCH_BTN] = {
+        .x = 21, .y = 12, .width = 20, .height = 5, .selectable = true, .selected = false, .editable = false, .value_ptr = NULL, .value_min = 0, .value_max = 0, .value_step = 0.0f, .label = "START BATCH",
+        //.draw_func  = draw_button
+    },
+    [BOARDS_PER_HOUR_BOX] = {
+        .x = 0, .y = 18, .width = 41, .height = 5, .selectable = false, .selected = false, .editable = false, .value_ptr = &boards_per_hour, .value_min = 0, .value_max = 0, .value_step = 0.0f, .label = "BOARDS/H",
+        //.draw_func  = draw_value_box
+    },
+    [DIAGNOSTICS_BTN] = {
+        .x = 0, .y = 24, .width = 41, .height = 5, .selectable = true, .selected = false, .editable = false, .value_ptr = NULL, .value_min = 0, .value_max = 0, .value_step = 0.0f, .label = "DIAGNOSTICS",
+        //.draw_func  = draw_button
     }};
 
 /******************************************************************************
@@ -142,15 +187,15 @@ ui_element_t ui_pid_settings_page_elements_arr[NUM_PID_BOXES] = {
         .selectable = true,
         .selected = false,
         .editable = true,
-        .value_ptr = &PID.Kp, /* Pointer to Proportional gain */
-        .value_min = 0,       /* Minimum value */
-        .value_max = 100,     /* Maximum value */
-        .value_step = 0.5f,   /* Adjustment steps */
-        .label = "KP",        /* Proportional gain label */
+        .value_ptr = &pid_gains_edit.Kp, /* Pointer to Proportional gain */
+        .value_min = 0,                  /* Minimum value */
+        .value_max = 100,                /* Maximum value */
+        .value_step = 0.5f,              /* Adjustment steps */
+        .label = "KP",                   /* Proportional gain label */
         //.draw_func  = draw_value_box,
     },
     [PID_KI_BOX] = {
-        .x = 4, .y = 5, .width = 6, .height = 7, .selectable = true, .selected = false, .editable = true, .value_ptr = &PID.Ki, /* Pointer to Integral gain */
+        .x = 4, .y = 5, .width = 6, .height = 7, .selectable = true, .selected = false, .editable = true, .value_ptr = &pid_gains_edit.Ki, /* Pointer to Integral gain */
         .value_min = 0,
         .value_max = 30,
         .value_step = 0.5f,
@@ -158,13 +203,18 @@ ui_element_t ui_pid_settings_page_elements_arr[NUM_PID_BOXES] = {
         //.draw_func  = draw_value_box,
     },
     [PID_KD_BOX] = {
-        .x = 8, .y = 9, .width = 10, .height = 11, .selectable = true, .selected = false, .editable = true, .value_ptr = &PID.Kd, /* Pointer to Derivative gain */
+        .x = 8, .y = 9, .width = 10, .height = 11, .selectable = true, .selected = false, .editable = true, .value_ptr = &pid_gains_edit.Kd, /* Pointer to Derivative gain */
         .value_min = 0,
         .value_max = 30,
         .value_step = 0.5f,
         .label = "KD", /* Derivative gain label */
         //.draw_func  = draw_value_box,
     },
+    [PID_CALIBRATE_BTN] = {
+        .x = 10, .y = 11, .width = 12, .height = 13, .selectable = true, .selected = false, .editable = false, /* Not editable (action button) */
+        .label = "CALIBRATE POWER",
+        //.draw_func  = draw_button,
+    },
     [PID_RETURN_BTN] = {
         .x = 12, .y = 13, .width = 14, .height = 15, .selectable = true, .selected = false, .editable = true,
         //.value_ptr  = &PID.Kd,      /* Not needed for button */
@@ -176,6 +226,53 @@ ui_element_t ui_pid_settings_page_elements_arr[NUM_PID_BOXES] = {
     },
 };
 
+/******************************************************************************
+ * ELEMENT DEFINITIONS FOR DIAGNOSTICS PAGE
+ *****************************************************************************/
+ui_element_t ui_diagnostics_page_elements_arr[NUM_DIAG_BOXES] = {
+    [DIAG_JITTER_BOX] = {
+        .x = 0, .y = 0, .width = 20, .height = 5, .selectable = false, .editable = false, .value_ptr = &diag_jitter_ms, .label = "JITTER MS",
+        //.draw_func  = draw_value_box
+    },
+    [DIAG_LATENCY_BOX] = {
+        .x = 21, .y = 0, .width = 20, .height = 5, .selectable = false, .editable = false, .value_ptr = &diag_latency_ms, .label = "LATENCY MS",
+        //.draw_func  = draw_value_box
+    },
+    [DIAG_RESPONSE_BOX] = {
+        .x = 0, .y = 6, .width = 20, .height = 5, .selectable = false, .editable = false, .value_ptr = &diag_response_ms, .label = "RESPONSE MS",
+        //.draw_func  = draw_value_box
+    },
+    [DIAG_MISSED_BOX] = {
+        .x = 21, .y = 6, .width = 20, .height = 5, .selectable = false, .editable = false, .value_ptr = &diag_missed, .label = "MISSED",
+        //.draw_func  = draw_value_box
+    },
+    [DIAG_OVERRUNS_BOX] = {
+        .x = 0, .y = 12, .width = 20, .height = 5, .selectable = false, .editable = false, .value_ptr = &diag_overruns, .label = "OVERRUNS",
+        //.draw_func  = draw_value_box
+    },
+    [DIAG_DEADLINE_BOX] = {
+        .x = 21, .y = 12, .width = 20, .height = 5, .selectable = true, .selected = false, .editable = true, .value_ptr = &diag_deadline_ms,
+        .value_min = 10,    /* Shortest budget: the sense step alone takes several ms */
+        .value_max = 200,   /* Below the 250 ms control period */
+        .value_step = 5.0f, /* 5 ms steps */
+        .label = "DEADLINE MS",
+        //.draw_func  = draw_value_box
+    },
+    [DIAG_MISS_LIMIT_BOX] = {
+        .x = 0, .y = 18, .width = 20, .height = 5, .selectable = true, .selected = false, .editable = true, .value_ptr = &diag_miss_limit,
+        .value_min = 0,     /* 0 disables the trip */
+        .value_max = 20,    /* 5 s at 4 Hz */
+        .value_step = 1.0f,
+        .label = "MISS LIMIT",
+        //.draw_func  = draw_value_box
+    },
+    [DIAG_RETURN_BTN] = {
+        .x = 21, .y = 18, .width = 20, .height = 5, .selectable = true, .selected = false, .editable = false, /* Not editable (navigation button) */
+        .label = "RETURN TO MAIN",
+        //.draw_func  = draw_button
+    },
+};
+
 /******************************************************************************
  * STATE MACHINE & GLOBAL VARIABLES
  *****************************************************************************/
@@ -201,9 +298,13 @@ static void rotate_action(state_machine_t *sm, int8_t delta, uint8_t rotateMode)
 {
     if (rotateMode)
     {
-        /* Navigate between elements */
+        /* Navigate between elements, skipping display-only ones */
         uint8_t max = ui_pages_arr[sm->current_page].num_elements;
-        sm->current_element_idx = (sm->current_element_idx + delta + max) % max;
+        uint8_t tries = max;
+        do
+        {
+            sm->current_element_idx = (sm->current_element_idx + delta + max) % max;
+        } while (!ui_pages_arr[sm->current_page].elements[sm->current_element_idx].selectable && --tries);
     }
     else
     {
@@ -242,22 +343,56 @@ static void update_value(state_machine_t *sm, encoder_event_t ev)
  *****************************************************************************/
 
 /**
- * @brief  Handle element selection on main page
+ * @brief  Handle element selection or editing on main page
  * @param  sm: Pointer to state machine
+ * @param  ev: Encoder event type
  * @retval None
  */
-static void selectElement_mainPage(state_machine_t *sm)
+static void selectElement_mainPage(state_machine_t *sm, encoder_event_t ev)
 {
+    uint32_t lock;
+
     sm->previous_page = sm->current_page;
     switch (sm->current_element_idx)
     {
     case START_BTN: // Does the user want to star the Reflow-oven process ?
-        sm->is_process_running = true;
-        HAL_TIM_Base_Start_IT(&htim3); // Enable sampling timer ISR and in result the PID, too
+        lock = ControlIsr_lock(); // The control step must not see a half-started run
+        if (ThermalFault_get() != FAULT_NONE)
+        {
+            // Latched fault: acknowledge with STOP first
+        }
+        else if (BatchQueue_getState() == BATCH_WAIT_CONFIRM)
+        {
+            // Board swapped: go on with the batch
+            sm->is_process_running = BatchQueue_confirm();
+        }
+        else if (BatchQueue_getState() == BATCH_IDLE)
+        {
+            sm->is_process_running = ReflowOven_startProcess();
+        }
+        ControlIsr_unlock(lock);
         break;
     case STOP_BTN:
+        // Cooling down is part of the process: the control loop keeps running
+        lock = ControlIsr_lock();
+        BatchQueue_abort();
+        ReflowOven_stopProcess();
+        ThermalFault_clear(); // Operator acknowledges a latched fault
+        ControlIsr_unlock(lock);
         sm->is_process_running = false;
-        HAL_TIM_Base_Stop_IT(&htim3); // Disable
+        break;
+    case BATCH_SIZE_BOX:
+        update_value(sm, ev); /* Edit the batch size or toggle edit mode */
+        break;
+    case BATCH_BTN: // Run the current profile batch_size times
+        lock = ControlIsr_lock();
+        if (BatchQueue_getState() == BATCH_IDLE && ThermalFault_get() == FAULT_NONE)
+        {
+            BatchQueue_Init();
+            BatchQueue_add(&ReflowOven.ReflowParameters, (uint8_t)batch_size);
+            sm->is_process_running = BatchQueue_start(HAL_GetTick());
+        }
+        ControlIsr_unlock(lock);
         break;
     case OVEN_SETTINGS_BTN:
         sm->current_page = OVEN_SETTINGS_PAGE;
@@ -267,6 +402,10 @@ static void selectElement_mainPage(state_machine_t *sm)
         sm->current_page = PID_SETTINGS_PAGE;
         sm->current_element_idx = PID_KP_BOX;
         break;
+    case DIAGNOSTICS_BTN:
+        sm->current_page = DIAGNOSTICS_PAGE;
+        sm->current_element_idx = DIAG_DEADLINE_BOX;
+        break;
     default:
         break;
     }
@@ -280,6 +419,14 @@ static void selectElement_mainPage(state_machine_t *sm)
  */
 void main_page_handler(state_machine_t *sm, encoder_event_t ev)
 {
+    /* Refresh the batch throughput shown on the page */
+    float rate = BatchQueue_getBoardsPerHour(HAL_GetTick());
+    if (rate != boards_per_hour)
+    {
+        boards_per_hour = rate;
+        sm->needs_redraw = true;
+    }
+
     switch (ev)
     {
     case IDLE_EVENT:
@@ -291,7 +438,7 @@ void main_page_handler(state_machine_t *sm, encoder_event_t ev)
         rotate_action(sm, -1, rotateMode);
         break;
     case PULSE_BUTTON_EVENT:
-        selectElement_mainPage(sm);
+        selectElement_mainPage(sm, ev);
         break;
     default:
         /* Unknown event: ignore */
@@ -375,6 +522,17 @@ void oven_settings_page_handler(state_machine_t *sm, encoder_event_t ev)
  * PID SETTINGS PAGE HANDLERS
  *****************************************************************************/
 
+/**
+ * @brief  Hand the edited gains over to the control step
+ * @param  None
+ * @retval None
+ */
+static void publish_pid_gains(void)
+{
+    *(PIDGains *)DoubleBuffer_back(&pid_gains_handoff) = pid_gains_edit;
+    DoubleBuffer_publish(&pid_gains_handoff);
+}
+
 /**
  * @brief  Handle element selection or editing on PID settings page
  * @param  sm: Pointer to state machine
@@ -383,6 +541,8 @@ void oven_settings_page_handler(state_machine_t *sm, encoder_event_t ev)
  */
 static void selectElement_pidSettingsPage(state_machine_t *sm, encoder_event_t ev)
 {
+    uint32_t lock;
+
     sm->previous_page = sm->current_page;
     switch (sm->current_element_idx)
     {
@@ -395,6 +555,18 @@ static void selectElement_pidSettingsPage(state_machine_t *sm, encoder_event_t e
     case PID_KD_BOX:
         update_value(sm, ev); /* Update Kd or toggle edit mode */
         break;
+    case PID_CALIBRATE_BTN: // Open-loop power calibration, only from an idle oven
+        lock = ControlIsr_lock();
+        if (PowerLin_isCalibrating())
+        {
+            PowerLin_abortCalibration();
+        }
+        else if (ReflowOven_getCurrentPhase() == REFLOW_IDLE)
+        {
+            PowerLin_startCalibration(HAL_GetTick(), chamber_temp);
+        }
+        ControlIsr_unlock(lock);
+        break;
     case PID_RETURN_BTN:
         sm->current_page = MAIN_PAGE;
         sm->current_element_idx = START_BTN;
@@ -419,9 +591,13 @@ void pid_settings_page_handler(state_machine_t *sm, encoder_event_t ev)
         break;
     case CLOCK_WISE_EVENT:
         rotate_action(sm, +1, rotateMode); /* Navigate or edit based on mode */
+        if (!rotateMode)
+            publish_pid_gains(); /* Edited gain reaches the next control tick */
         break;
     case ANTI_CLCOK_WISE_EVENT:
         rotate_action(sm, -1, rotateMode); /* Navigate or edit based on mode */
+        if (!rotateMode)
+            publish_pid_gains(); /* Edited gain reaches the next control tick */
         break;
     case PULSE_BUTTON_EVENT:
         selectElement_pidSettingsPage(sm, ev);
@@ -432,6 +608,93 @@ void pid_settings_page_handler(state_machine_t *sm, encoder_event_t ev)
     }
 }
 
+/******************************************************************************
+ * DIAGNOSTICS PAGE HANDLERS
+ *****************************************************************************/
+
+/**
+ * @brief  Handle element selection or editing on diagnostics page
+ * @param  sm: Pointer to state machine
+ * @param  ev: Encoder event type
+ * @retval None
+ */
+static void selectElement_diagnosticsPage(state_machine_t *sm, encoder_event_t ev)
+{
+    sm->previous_page = sm->current_page;
+    switch (sm->current_element_idx)
+    {
+    case DIAG_DEADLINE_BOX:
+        update_value(sm, ev); /* Update the deadline or toggle edit mode */
+        break;
+    case DIAG_MISS_LIMIT_BOX:
+        update_value(sm, ev); /* Update the trip limit or toggle edit mode */
+        break;
+    case DIAG_RETURN_BTN:
+        sm->current_page = MAIN_PAGE;
+        sm->current_element_idx = START_BTN;
+        break;
+    default:
+        /* No extra action */
+        break;
+    }
+}
+
+/**
+ * @brief  Update a value shown on the diagnostics page
+ * @param  sm: Pointer to state machine
+ * @param  shown: Value displayed by the page
+ * @param  value: Latest value
+ * @retval None
+ */
+static void refresh_diagnostic(state_machine_t *sm, float *shown, float value)
+{
+    if (value != *shown)
+    {
+        *shown = value;
+        sm->needs_redraw = true;
+    }
+}
+
+/**
+ * @brief  Diagnostics page event handler
+ * @param  sm: Pointer to state machine
+ * @param  ev: Encoder event type
+ * @retval None
+ */
+void diagnostics_page_handler(state_machine_t *sm, encoder_event_t ev)
+{
+    ControlTiming_stats_t timing;
+
+    /* Refresh the control loop timing shown on the page */
+    ControlTiming_get(&timing);
+    refresh_diagnostic(sm, &diag_jitter_ms, ((-timing.minDeviationUs > timing.maxDeviationUs) ? -timing.minDeviationUs : timing.maxDeviationUs) / 1000.0f);
+    refresh_diagnostic(sm, &diag_latency_ms, timing.maxLatencyUs / 1000.0f);
+    refresh_diagnostic(sm, &diag_response_ms, timing.maxResponseUs / 1000.0f);
+    refresh_diagnostic(sm, &diag_missed, (float)timing.missed);
+    refresh_diagnostic(sm, &diag_overruns, (float)timing.overruns);
+
+    switch (ev)
+    {
+    case IDLE_EVENT:
+        break;
+    case CLOCK_WISE_EVENT:
+        rotate_action(sm, +1, rotateMode); /* Navigate or edit based on mode */
+        break;
+    case ANTI_CLCOK_WISE_EVENT:
+        rotate_action(sm, -1, rotateMode); /* Navigate or edit based on mode */
+        break;
+    case PULSE_BUTTON_EVENT:
+        selectElement_diagnosticsPage(sm, ev);
+        break;
+    default:
+        /* Unknown event: ignore */
+        break;
+    }
+
+    /* Edited limits take effect at once */
+    ControlTiming_setLimits((uint32_t)diag_deadline_ms * 1000u, (uint8_t)diag_miss_limit);
+}
+
 /******************************************************************************
  * ENCODER INTERFACE FUNCTIONS
  *****************************************************************************/
@@ -443,15 +706,27 @@ void pid_settings_page_handler(state_machine_t *sm, encoder_event_t ev)
  */
 void ENCODER_EVENT_UPDATE(encoder_t *encoder)
 {
+    EventQueue_event_t press;
+    bool pressed = false;
+
     /* Get current counter value and direction from Timer */
     encoder->current_cnt = __HAL_TIM_GET_COUNTER(&htim2);
     encoder->current_dir = READ_BIT(TIM2->CR1, TIM_CR1_DIR) ? 1 : 0;
 
+    /* Take one press queued by the ISR, dropping the bounces that follow a real one */
+    while (!pressed && EventQueue_pop(encoder->events, &press))
+    {
+        if (DWT_cyclesToUs(press.cycles - encoder->press_cycles) >= ENCODER_DEBOUNCE_US)
+        {
+            encoder->press_cycles = press.cycles;
+            pressed = true;
+        }
+    }
+
     /* Determine event type based on encoder state */
-    if (encoder->isr_reg & 1)
+    if (pressed)
     {
         /* Button press detected in ISR */
-        encoder->isr_reg &= ~1; /* Clear flag */
         encoder->ev = PULSE_BUTTON_EVENT;
     }
     else if (encoder->current_dir == encoder->prev_dir &&
@@ -514,10 +789,25 @@ void GUI_Init(void)
     pid_settings_page_ui.elements = ui_pid_settings_page_elements_arr;
     pid_settings_page_ui.current_element = PID_KP_BOX;
 
+    /****************
+     * DIAGNOSTICS
+     ****************/
+    /* Diagnostics page configuration */
+    diagnostics_page_ui.id = DIAGNOSTICS_PAGE;
+    diagnostics_page_ui.num_elements = NUM_DIAG_BOXES;
+    diagnostics_page_ui.elements = ui_diagnostics_page_elements_arr;
+    diagnostics_page_ui.current_element = DIAG_DEADLINE_BOX;
+
     /* Build page array for state machine */
     ui_pages_arr[MAIN_PAGE] = main_page_ui;
     ui_pages_arr[OVEN_SETTINGS_PAGE] = oven_settings_page_ui;
     ui_pages_arr[PID_SETTINGS_PAGE] = pid_settings_page_ui;
+    ui_pages_arr[DIAGNOSTICS_PAGE] = diagnostics_page_ui;
+
+    /* PID gains handoff, starting from the gains the page shows */
+    pid_gains_slots[0] = pid_gains_edit;
+    DoubleBuffer_Init(&pid_gains_handoff, &pid_gains_slots[0], &pid_gains_slots[1], sizeof(PIDGains));
+    pid_gains_seen = 0;
 
     /* Initialize state machine */
     gui_sm.current_page = MAIN_PAGE;
@@ -528,3 +818,13 @@ void GUI_Init(void)
     gui_sm.is_editing = false;
     gui_sm.is_process_running = false;
 }
+
+/**
+ * @brief  Fetch the PID gains edited on the PID settings page
+ * @param  gains: Destination for the latest published gains
+ * @retval True when the gains changed since the previous call
+ */
+bool GUI_GetPidGains(PIDGains *gains)
+{
+    return DoubleBuffer_read(&pid_gains_handoff, gains, &pid_gains_seen);
+}
@@ -0,0 +1,109 @@
+/*
+ * halfcycle_modulator.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the half-cycle sigma-delta modulator.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "halfcycle_modulator.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Energy per half-cycle in Q16 (HALFCYCLE_ONE = always ON), written by the control loop */
+static volatile uint32_t halfCycle_level[HALFCYCLE_MAX_CHANNELS];
+/* Energy owed to the load in Q16, only touched by the zero-cross interrupt */
+static uint32_t halfCycle_accumulator[HALFCYCLE_MAX_CHANNELS];
+/* Initial accumulator of each channel: 1/8, 5/8, 3/8, 7/8 of a half-cycle */
+static const uint32_t halfCycle_stagger[HALFCYCLE_MAX_CHANNELS] = {
+    HALFCYCLE_ONE / 8, 5 * HALFCYCLE_ONE / 8, 3 * HALFCYCLE_ONE / 8, 7 * HALFCYCLE_ONE / 8};
+/* Channels allowed to conduct together */
+static volatile uint8_t halfCycle_maxConcurrent = HALFCYCLE_MAX_CHANNELS;
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void HalfCycle_Init(void)
+{
+    uint8_t channel;
+
+    for (channel = 0; channel < HALFCYCLE_MAX_CHANNELS; channel++) {
+        halfCycle_level[channel] = 0;
+    }
+    halfCycle_maxConcurrent = HALFCYCLE_MAX_CHANNELS;
+    HalfCycle_flush();
+}
+
+void HalfCycle_setLevel(uint8_t channel, float power)
+{
+    if (channel >= HALFCYCLE_MAX_CHANNELS) {
+        return;
+    }
+
+    if (power <= 0.0f) {
+        halfCycle_level[channel] = 0;
+    } else if (power >= 100.0f) {
+        halfCycle_level[channel] = HALFCYCLE_ONE;
+    } else {
+        halfCycle_level[channel] = (uint32_t)(power * ((float)HALFCYCLE_ONE / 100.0f) + 0.5f);
+    }
+}
+
+void HalfCycle_setMaxConcurrent(uint8_t maxConcurrent)
+{
+    if (maxConcurrent >= 1 && maxConcurrent <= HALFCYCLE_MAX_CHANNELS) {
+        halfCycle_maxConcurrent = maxConcurrent;
+    }
+}
+
+uint8_t HalfCycle_step(uint8_t numChannels)
+{
+    uint8_t fired = 0;
+    uint8_t channel, slot;
+
+    if (numChannels > HALFCYCLE_MAX_CHANNELS) {
+        numChannels = HALFCYCLE_MAX_CHANNELS;
+    }
+
+    // First-order sigma-delta: each channel is due once a whole half-cycle of energy is owed
+    for (channel = 0; channel < numChannels; channel++) {
+        uint32_t accumulator = halfCycle_accumulator[channel] + halfCycle_level[channel];
+        halfCycle_accumulator[channel] = (accumulator > HALFCYCLE_MAX_DEBT) ? HALFCYCLE_MAX_DEBT : accumulator;
+    }
+
+    // Fire the most indebted due channels, up to the concurrency limit
+    for (slot = 0; slot < halfCycle_maxConcurrent; slot++) {
+        uint8_t best = HALFCYCLE_MAX_CHANNELS;
+        uint32_t bestDebt = HALFCYCLE_ONE - 1;
+
+        for (channel = 0; channel < numChannels; channel++) {
+            if (!(fired & (1u << channel)) && halfCycle_accumulator[channel] > bestDebt) {
+                best = channel;
+                bestDebt = halfCycle_accumulator[channel];
+            }
+        }
+        if (best == HALFCYCLE_MAX_CHANNELS) {
+            break; // Nothing else due
+        }
+        halfCycle_accumulator[best] -= HALFCYCLE_ONE;
+        fired |= (uint8_t)(1u << best);
+    }
+    return fired;
+}
+
+void HalfCycle_flush(void)
+{
+    uint8_t channel;
+
+    // Staggered starts inside one half-cycle, in bit-reversed order so the first
+    // channels in use are the furthest apart: the delivered energy stays within
+    // one half-cycle of the request and equal levels fire on different edges
+    for (channel = 0; channel < HALFCYCLE_MAX_CHANNELS; channel++) {
+        halfCycle_accumulator[channel] = halfCycle_stagger[channel];
+    }
+}
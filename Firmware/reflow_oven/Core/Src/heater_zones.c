@@ -0,0 +1,163 @@
+/*
+ * heater_zones.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the multi-zone heater controller.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "main.h"
+#include "heater_zones.h"
+#include "thermal_mass.h"
+#include "transient_detector.h"
+
+/******************************************************************************
+ * BOARD CONFIGURATION
+ ******************************************************************************/
+/*
+ * TIM1 CH2/CH3 share PA9/PA10 with USART1 and their complementary pins with
+ * the CS_1/CS_2 lines on this board, so the two elements use CH1 (PA8) and
+ * CH4 (PA11). Zone 0 is the bottom element (see the profile's zone balance).
+ */
+static const HeaterZone_config_t heaterZones_boardConfig[] = {
+    {.channel = TIM_CHANNEL_1, .probeMask = 0x03, .limMax = 100.0f, .gainScale = 1.0f, .ratedPower = 750.0f}, /* Bottom: probes 0, 1 */
+    {.channel = TIM_CHANNEL_4, .probeMask = 0x0C, .limMax = 100.0f, .gainScale = 1.0f, .ratedPower = 750.0f}, /* Top: probes 2, 3 */
+};
+
+/*
+ * Elements allowed to conduct in the same half-cycle, 0 = every zone. Only for
+ * a supply that cannot carry all elements at once: zones then share their
+ * half-cycles and a PID output no longer means % of that element's full power.
+ */
+static const uint8_t heaterZones_boardMaxConcurrent = 0;
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+HeaterZone_t HeaterZones[HEATER_MAX_ZONES];
+uint8_t HeaterZones_count;
+uint8_t HeaterZones_maxConcurrent;
+
+static ReflowPhases_t heaterZones_lastPhase = REFLOW_IDLE;
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void HeaterZones_Init(const PIDController *master)
+{
+    uint8_t zone;
+
+    HeaterZones_count = sizeof(heaterZones_boardConfig) / sizeof(heaterZones_boardConfig[0]);
+    if (HeaterZones_count > HEATER_MAX_ZONES) {
+        HeaterZones_count = HEATER_MAX_ZONES;
+    }
+    HeaterZones_maxConcurrent = HeaterZones_count;
+    if (heaterZones_boardMaxConcurrent != 0 && heaterZones_boardMaxConcurrent < HeaterZones_count) {
+        HeaterZones_maxConcurrent = heaterZones_boardMaxConcurrent;
+    }
+
+    for (zone = 0; zone < HeaterZones_count; zone++) {
+        HeaterZones[zone].config = heaterZones_boardConfig[zone];
+        PID_Init(&HeaterZones[zone].pid,
+                 master->Kp * HeaterZones[zone].config.gainScale,
+                 master->Ki * HeaterZones[zone].config.gainScale,
+                 master->Kd * HeaterZones[zone].config.gainScale,
+                 master->tau,
+                 master->limMin,
+                 HeaterZones[zone].config.limMax,
+                 master->limMinInt,
+                 master->limMaxInt,
+                 master->T);
+        HeaterZones[zone].temperature = 0.0f;
+        HeaterZones[zone].power = 0.0f;
+    }
+    heaterZones_lastPhase = REFLOW_IDLE;
+}
+
+void HeaterZones_update(const PIDController *master, const float *probeTemperature,
+                        uint8_t healthyProbes, float chamberTemperature)
+{
+    ReflowPhases_t phase = ReflowOven_getCurrentPhase();
+    bool resetControllers = false;
+    uint8_t zone, probe;
+
+    // Mirror the master PID resets to prevent integral windup across runs
+    if (phase != heaterZones_lastPhase) {
+        resetControllers = (phase == REFLOW_IDLE || phase == REFLOW_PREHEAT || phase == REFLOW_STANDBY);
+        heaterZones_lastPhase = phase;
+    }
+
+    for (zone = 0; zone < HeaterZones_count; zone++) {
+        HeaterZone_t *hz = &HeaterZones[zone];
+        float sum = 0.0f;
+        uint8_t used = 0;
+
+        // Zone temperature: its healthy probes, or the chamber if none is left
+        for (probe = 0; probe < HEATER_NUM_PROBES; probe++) {
+            if ((hz->config.probeMask & healthyProbes) & (1u << probe)) {
+                sum += probeTemperature[probe];
+                used++;
+            }
+        }
+        hz->temperature = used ? (sum / used) : chamberTemperature;
+
+        if (resetControllers) {
+            PID_Reset(&hz->pid);
+        }
+
+        // Gains follow the master (GUI) scaled for the load, limits follow the profile balance
+        PID_UpdateGains(&hz->pid,
+                        master->Kp * hz->config.gainScale * ReflowOven.gainScale,
+                        master->Ki * hz->config.gainScale * ReflowOven.gainScale,
+                        master->Kd * hz->config.gainScale * ReflowOven.gainScale);
+        if (phase < REFLOW_IDLE) {
+            hz->pid.limMax = hz->config.limMax * ReflowOven.ReflowParameters.ZoneBalance[phase][zone];
+        } else if (phase == REFLOW_STANDBY) {
+            // Warm hold heats like the start of a run
+            hz->pid.limMax = hz->config.limMax * ReflowOven.ReflowParameters.ZoneBalance[REFLOW_PREHEAT][zone];
+        } else {
+            hz->pid.limMax = 0.0f; // Heaters off while idle
+        }
+
+        if (ThermalMass_isIdentifying()) {
+            // Known power step while the process measures the load
+            PID_UpdateHoldIntegrator(&hz->pid, ReflowOven.currentSetpoint, hz->temperature);
+            hz->power = (THERMALMASS_STEP_POWER < hz->pid.limMax) ? THERMALMASS_STEP_POWER : hz->pid.limMax;
+            continue;
+        }
+        if (Transient_getState() == TRANSIENT_DOOR_OPEN) {
+            PID_UpdateHoldIntegrator(&hz->pid, ReflowOven.currentSetpoint, hz->temperature);
+        } else {
+            PID_Update(&hz->pid, ReflowOven.currentSetpoint, hz->temperature);
+        }
+        hz->power = hz->pid.out + ReflowOven.feedforward;
+        if (hz->power > hz->pid.limMax) {
+            hz->power = hz->pid.limMax;
+        }
+    }
+}
+
+float HeaterZones_getSpread(void)
+{
+    float minTemp, maxTemp;
+    uint8_t zone;
+
+    if (HeaterZones_count < 2) {
+        return 0.0f;
+    }
+
+    minTemp = maxTemp = HeaterZones[0].temperature;
+    for (zone = 1; zone < HeaterZones_count; zone++) {
+        if (HeaterZones[zone].temperature < minTemp) {
+            minTemp = HeaterZones[zone].temperature;
+        }
+        if (HeaterZones[zone].temperature > maxTemp) {
+            maxTemp = HeaterZones[zone].temperature;
+        }
+    }
+    return maxTemp - minTemp;
+}
@@ -23,19 +23,103 @@
 /* USER CODE BEGIN Includes */
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "app_rtos.h"
+#include "batch_queue.h"
+#include "boot_profile.h"
+#include "chamber_model.h"
+#include "control_isr.h"
+#include "control_timing.h"
+#include "cooling.h"
+#include "cpu_load.h"
+#include "double_buffer.h"
+#include "dwt.h"
+#include "energy_meter.h"
+#include "event_queue.h"
 #include "gui_backend.h"
+#include "halfcycle_modulator.h"
+#include "heater_zones.h"
+#include "mains_monitor.h"
 #include "max6675.h"
+#include "mem_guard.h"
 #include "pid.h"
+#include "power_linearization.h"
+#include "profiler.h"
+#include "reflow_oven_process.h"
+#include "run_recorder.h"
+#include "scheduler.h"
+#include "telemetry.h"
+#include "thermal_fault.h"
+#include "thermal_mass.h"
+#include "trace.h"
+#include "transient_detector.h"
+#include "watchdog.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
-
+// Fault detected by the control step, printed later by the telemetry task
+typedef struct
+{
+  ThermalFault_t fault;
+  uint8_t probe;
+  float temperature;
+  float observed;
+  float expected;
+} fault_report_t;
+
+#if REFLOW_CONTROL_IN_ISR
+// Fused sample handed from the acquisition task to the control step
+typedef struct
+{
+  float probes[4];
+  float chamber;
+} control_sample_t;
+#endif
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+// Control chain period: sense -> control -> actuate (4 Hz)
+#if REFLOW_USE_RTOS
+#define CONTROL_PERIOD_MS APPRTOS_CONTROL_PERIOD_MS // Paced by the acquisition task
+#else
+#define CONTROL_PERIOD_MS 250u
+#endif
+
+// Control step in PendSV: released this long after the acquisition task, which must have
+// published its sample by then (the reads take ~5 ms, the GUI may hold the loop for more)
+#define CONTROL_ISR_PHASE_MS 50u
+
+// First control release after the timebase starts: the MAX6675s start converting just
+// before, and a read ahead of the end of that conversion would abort it
+#define CONTROL_START_MS  MAX6675_CONVERSION_MS
+
+// Task timing and control jitter report interval
+#define SCHED_REPORT_MS   10000u
+
+// Boot profile printed once the first valid sample came in, or after this without one
+#define BOOT_REPORT_TIMEOUT_MS 5000u
+
+// ISR -> consumer event queues (slots, power of two)
+#define INPUT_EVENT_SLOTS 8u
+#define MAINS_EVENT_SLOTS 8u
+#define UART_EVENT_SLOTS  32u
+
+// Longest command line accepted on USART1
+#define COMMAND_LINE_SIZE 24u
+
+// Trace dump: records per $TR line (16 hex digits each) and lines per telemetry tick
+#define TRACE_LINE_RECORDS 7u
+#define TRACE_DUMP_LINES   3u
+
+// Build flavour reported with the jitter figures
+#if REFLOW_USE_RTOS
+#define BUILD_FLAVOUR "RTOS"
+#else
+#define BUILD_FLAVOUR "BARE"
+#endif
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -51,6 +135,7 @@ SPI_HandleTypeDef hspi1;
 TIM_HandleTypeDef htim1;
 TIM_HandleTypeDef htim2;
 TIM_HandleTypeDef htim3;
+TIM_HandleTypeDef htim4;
 
 UART_HandleTypeDef huart1;
 
@@ -58,16 +143,54 @@ UART_HandleTypeDef huart1;
 // GUI and OLEDscreen related
 encoder_t encoder;
 
+// Event queues: EXTI -> GUI (button presses), TIM1 -> telemetry (mains loss/return),
+// USART1 -> telemetry (command bytes)
+EventQueue_t inputEvents;
+EventQueue_t mainsEvents;
+EventQueue_t uartEvents;
+static EventQueue_event_t inputEventSlots[INPUT_EVENT_SLOTS];
+static EventQueue_event_t mainsEventSlots[MAINS_EVENT_SLOTS];
+static EventQueue_event_t uartEventSlots[UART_EVENT_SLOTS];
+static uint8_t uartRxByte;
+
+// Scheduler task whose release starts a control cycle (timing monitor)
+static uint32_t controlReleaseMask;
+
+// Scheduler task released by input interrupts (none until registered)
+static uint8_t guiTaskId = SCHEDULER_MAX_TASKS;
+
+#if REFLOW_CONTROL_IN_ISR
+// Acquisition -> control step handoff and the control step release
+static control_sample_t sampleSlots[2];
+static DoubleBuffer_t sampleHandoff;
+static uint32_t sampleSeen;
+static uint32_t controlIsrNextMs;
+static volatile uint32_t controlIsrReleaseMs;
+#endif
+
+#if TRACE_ENABLE
+// Trace dump in progress, sent a few lines per telemetry tick
+static bool traceDumping;
+static uint32_t traceDumpNext;
+static uint32_t traceDumpCount;
+#endif
+
+// Latched fault waiting to be reported
+static fault_report_t faultReport;
+static volatile bool faultReportPending;
+
 // PID controller related
 uint8_t cont = 0; // used for debugging
 PIDController PID;
-uint8_t timers_isr = 0;
 
 // Sensors
 float chamber_temp = 0;      // Celcius
 float tempReadings[4] = {0}; // Stores each sensor's temperature
 MAX6675_Driver_t tempSensors;
 
+// Actuators
+float applied_power = 0; // Highest heater duty written in the last tick (%)
+
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -79,16 +202,96 @@ static void MX_I2C1_Init(void);
 static void MX_TIM2_Init(void);
 static void MX_USART1_UART_Init(void);
 static void MX_TIM3_Init(void);
+static void MX_TIM4_Init(void);
 /* USER CODE BEGIN PFP */
 
-void chamber_sense_temperature();
-void update_randomCrossover_actuator(uint8_t);
+void chamber_sense_temperature(float *, float *);
+void update_randomCrossover_actuator(uint8_t, float);
+void fire_next_halfCycle(void);
+void update_heater_zones(uint32_t);
+void update_cooling_actuator(void);
+void record_control_tick(uint32_t, uint8_t);
+void report_mains(void);
+void report_boot(uint32_t);
+void report_power_calibration(void);
+void report_run_energy(void);
+void report_transients(void);
+void report_thermal_mass(void);
+void report_scheduler(uint32_t);
+void report_jitter(uint32_t);
+void report_cpu_load(uint32_t);
+void report_memory(uint32_t);
+void report_mains_events(uint32_t);
+void report_event_queues(uint32_t);
+void report_profile(void);
+void report_fault(void);
+void report_batch(void);
+void start_trace_dump(void);
+void report_trace(void);
+void process_commands(void);
+uint8_t probes_healthy_mask(void);
+void check_thermal_faults(uint32_t);
+void enter_safe_state(void);
+void drive_actuators_safe(void);
+void task_sense(uint32_t);
+void task_acquire(uint32_t);
+void task_control(uint32_t);
+void task_actuate(uint32_t);
+void task_logging(uint32_t);
+void task_telemetry(uint32_t);
+void task_gui(uint32_t);
+#if REFLOW_USE_RTOS
+void rtos_acquire(AppRtos_sample_t *);
+void rtos_control(const AppRtos_sample_t *);
+#endif
 
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
-
+#if REFLOW_USE_RTOS
+/*
+ * RTOS task bodies (Debug_RTOS build): the same steps as the scheduler
+ * table below, split at the queues between acquisition, control and
+ * telemetry.
+ */
+static const AppRtos_config_t rtosTasks = {
+    .acquire = rtos_acquire,
+    .control = rtos_control,
+    .logging = task_logging,
+    .telemetry = task_telemetry,
+    .gui = task_gui,
+};
+#elif REFLOW_CONTROL_IN_ISR
+/*
+ * Task table with the control step in PendSV. Acquisition runs in the
+ * background ahead of the control release and only publishes the sample;
+ * control and actuation follow CONTROL_ISR_PHASE_MS later from the TIM3
+ * interrupt. Logging picks the completed tick up in the same millisecond;
+ * the GUI is released by encoder input as in the table below.
+ */
+static const Scheduler_taskConfig_t schedulerTasks[] = {
+    {.name = "acquire", .run = task_acquire,   .periodMs = CONTROL_PERIOD_MS, .offsetMs = CONTROL_START_MS,                        .deadlineUs = 20000,  .priority = 0},
+    {.name = "logging", .run = task_logging,   .periodMs = CONTROL_PERIOD_MS, .offsetMs = CONTROL_START_MS + CONTROL_ISR_PHASE_MS, .deadlineUs = 100000, .priority = 1},
+    {.name = "telem",   .run = task_telemetry, .periodMs = CONTROL_PERIOD_MS, .offsetMs = CONTROL_START_MS + 125,                  .deadlineUs = 100000, .priority = 2},
+    {.name = "gui",     .run = task_gui,       .periodMs = 100,               .offsetMs = 5,                                       .deadlineUs = 50000,  .priority = 3},
+};
+#else
+/*
+ * Task table. The control chain is released every CONTROL_PERIOD_MS and
+ * runs in priority order, so sense, control and actuate always see the same
+ * tick. Logging and telemetry follow the chain; the GUI fills the gaps,
+ * refreshed every 100 ms and released at once by encoder input.
+ */
+static const Scheduler_taskConfig_t schedulerTasks[] = {
+    {.name = "sense",   .run = task_sense,     .periodMs = CONTROL_PERIOD_MS, .offsetMs = CONTROL_START_MS,       .deadlineUs = 20000,  .priority = 0},
+    {.name = "control", .run = task_control,   .periodMs = CONTROL_PERIOD_MS, .offsetMs = CONTROL_START_MS,       .deadlineUs = 25000,  .priority = 1},
+    {.name = "actuate", .run = task_actuate,   .periodMs = CONTROL_PERIOD_MS, .offsetMs = CONTROL_START_MS,       .deadlineUs = 30000,  .priority = 2},
+    {.name = "logging", .run = task_logging,   .periodMs = CONTROL_PERIOD_MS, .offsetMs = CONTROL_START_MS,       .deadlineUs = 100000, .priority = 3},
+    {.name = "telem",   .run = task_telemetry, .periodMs = CONTROL_PERIOD_MS, .offsetMs = CONTROL_START_MS + 125, .deadlineUs = 100000, .priority = 4},
+    {.name = "gui",     .run = task_gui,       .periodMs = 100,               .offsetMs = 5,                      .deadlineUs = 50000,  .priority = 5},
+};
+#endif
 /* USER CODE END 0 */
 
 /**
@@ -99,7 +302,15 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
-
+  bool watchdogReset;
+
+  // Heaters off before anything else, still on the reset clock; the profile starts here
+  DWT_Init();
+  BootProfile_Init();
+  drive_actuators_safe();
+  BootProfile_mark(BOOT_STEP_SAFE_STATE);
+  // Stack canary and high-water paint, while the stack is still shallow
+  MemGuard_Init();
   /* USER CODE END 1 */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -108,14 +319,19 @@ int main(void)
   HAL_Init();
 
   /* USER CODE BEGIN Init */
+  BootProfile_mark(BOOT_STEP_HAL);
 
+  // Supervise the rest of the boot too: the first control cycle is well within the timeout
+  watchdogReset = Watchdog_causedReset();
+  Watchdog_Init(WATCHDOG_TIMEOUT_MS);
+  BootProfile_mark(BOOT_STEP_WATCHDOG);
   /* USER CODE END Init */
 
   /* Configure the system clock */
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
-
+  BootProfile_mark(BOOT_STEP_CLOCK);
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
@@ -126,12 +342,32 @@ int main(void)
   MX_TIM2_Init();
   MX_USART1_UART_Init();
   MX_TIM3_Init();
+  MX_TIM4_Init();
   /* USER CODE BEGIN 2 */
+  BootProfile_mark(BOOT_STEP_PERIPHERALS);
+
+  // Release the chip selects first: the first conversions run while the rest comes up.
+  // The probes are detected by the first read of the sense task
+  MAX6675_Init(&tempSensors, &hspi1);
+  MAX6675_AddDevice(&tempSensors, 0);
+  MAX6675_AddDevice(&tempSensors, 1);
+  MAX6675_AddDevice(&tempSensors, 2);
+  MAX6675_AddDevice(&tempSensors, 3);
+  BootProfile_mark(BOOT_STEP_SENSORS);
+
+  EventQueue_Init(&inputEvents, inputEventSlots, INPUT_EVENT_SLOTS);
+  EventQueue_Init(&mainsEvents, mainsEventSlots, MAINS_EVENT_SLOTS);
+  EventQueue_Init(&uartEvents, uartEventSlots, UART_EVENT_SLOTS);
 
   encoder.prev_dir = 0;
   encoder.prev_cnt = 0;
+  encoder.events = &inputEvents;
   GUI_Init();
   HAL_TIM_Encoder_Start(&htim2, TIM_CHANNEL_ALL);
+#if !REFLOW_USE_RTOS
+  // Every encoder step (TI2 edge) wakes the GUI task instead of a fast poll
+  __HAL_TIM_ENABLE_IT(&htim2, TIM_IT_CC2);
+#endif
 
   PID_Init(&PID,
            0,      // kp
@@ -139,18 +375,89 @@ int main(void)
            0,      // kd
            0,      // tau
            0.0,    // limMIN
-           120.0,  // limMAX
+           100.0,  // limMAX: % of full power
            0,      // limMinInt
            0,      // limMaxInt
            0.100); // tsample
-  MAX6675_Init(&tempSensors, &hspi1);
-  MAX6675_AddDevice(&tempSensors, 0);
-  MAX6675_AddDevice(&tempSensors, 1);
-  MAX6675_AddDevice(&tempSensors, 2);
-  MAX6675_AddDevice(&tempSensors, 3);
 
-  // Zero-Crossover control
-  HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_1);
+  // Reflow process state machine, heater zones, run recorder and batch mode
+  Telemetry_Init(&huart1);
+  // Commands arrive one byte per interrupt
+  HAL_UART_Receive_IT(&huart1, &uartRxByte, 1);
+  if (watchdogReset)
+  {
+    Telemetry_printf("$RESET,WATCHDOG");
+  }
+  ReflowOven_Init();
+  HeaterZones_Init(&PID);
+  PowerLin_Init();
+  EnergyMeter_Init();
+  for (uint8_t zone = 0; zone < HeaterZones_count; zone++)
+  {
+    EnergyMeter_setChannelPower(zone, HeaterZones[zone].config.ratedPower);
+  }
+  RunRecorder_Init();
+  BatchQueue_Init();
+  Cooling_Init(CONTROL_PERIOD_MS / 1000.0f);
+  ThermalFault_Init();
+
+  // Zero-Crossover control: one TIM1 channel per heater zone, one update IRQ per zero cross
+  HalfCycle_Init();
+  HalfCycle_setMaxConcurrent(HeaterZones_maxConcurrent);
+#if TRACE_ENABLE
+  Trace_Init();
+#endif
+  Mains_Init(SystemCoreClock);
+  BootProfile_mark(BOOT_STEP_MODULES);
+  HAL_TIM_Base_Start_IT(&htim1);
+  for (uint8_t zone = 0; zone < HeaterZones_count; zone++)
+  {
+    HAL_TIM_PWM_Start(&htim1, HeaterZones[zone].config.channel);
+  }
+
+  // The line frequency locks in the background (~0.2 s), the telemetry task reports it;
+  // until then the energy meter counts half-cycles and the modulator follows the crossings
+
+  // Forced cooling: fan PWM and door servo
+  HAL_TIM_PWM_Start(&htim4, TIM_CHANNEL_3);
+  HAL_TIM_PWM_Start(&htim4, TIM_CHANNEL_4);
+  BootProfile_mark(BOOT_STEP_ACTUATORS);
+
+  // Control-loop jitter, measured the same way in both builds
+  ControlTiming_Init(CONTROL_PERIOD_MS * 1000u, SystemCoreClock / 1000000u);
+  // CPU load from the time spent asleep in the idle path of either build
+  CpuLoad_Init(HAL_GetTick(), SystemCoreClock / 1000u);
+
+#if REFLOW_USE_RTOS
+  // Kernel tasks on SysTick; TIM3 stays stopped. Does not return
+  BootProfile_mark(BOOT_STEP_SCHEDULER);
+  AppRtos_start(&rtosTasks);
+#else
+  // Task scheduler on the 1 ms TIM3 timebase: the control loop always runs, IDLE keeps the heater off
+  Scheduler_Init(HAL_GetTick());
+  for (uint8_t task = 0; task < sizeof(schedulerTasks) / sizeof(schedulerTasks[0]); task++)
+  {
+    int8_t id = Scheduler_addTask(&schedulerTasks[task]);
+    if (id >= 0 && schedulerTasks[task].run == task_sense)
+    {
+      controlReleaseMask = 1u << id;
+    }
+    else if (id >= 0 && schedulerTasks[task].run == task_gui)
+    {
+      guiTaskId = (uint8_t)id;
+    }
+  }
+  Scheduler_start();
+#if REFLOW_CONTROL_IN_ISR
+  // Control step in PendSV, CONTROL_ISR_PHASE_MS behind the acquisition
+  DoubleBuffer_Init(&sampleHandoff, &sampleSlots[0], &sampleSlots[1], sizeof(control_sample_t));
+  sampleSeen = 0;
+  controlIsrNextMs = Scheduler_getTime() + CONTROL_START_MS + CONTROL_ISR_PHASE_MS;
+  ControlIsr_Init();
+#endif
+  HAL_TIM_Base_Start_IT(&htim3);
+  BootProfile_mark(BOOT_STEP_SCHEDULER);
+#endif
 
   /* USER CODE END 2 */
 
@@ -162,37 +469,11 @@ int main(void)
 
     /* USER CODE BEGIN 3 */
 
-    // Check bti0 for temperature sensing / PID feedback-input update
-    if (timers_isr & 0x01)
+    // Run the highest priority released task; with none, sleep until an interrupt releases one
+    if (!Scheduler_runNext())
     {
-      timers_isr &= ~0x01;
-      // Get temperature inside oven
-      chamber_sense_temperature();
-      // Process data and update state
-      ReflowOven_operate();
-      // Act on heat elements
-      update_randomCrossover_actuator((uint8_t)PID.out);
+      Scheduler_sleep();
     }
-    else
-    {
-      // GUI PROCESS
-      ENCODER_EVENT_UPDATE(&encoder);
-      switch (gui_sm.current_page)
-      {
-      case MAIN_PAGE:
-        main_page_handler(&gui_sm, encoder.ev);
-        break;
-      case OVEN_SETTINGS_PAGE:
-        oven_settings_page_handler(&gui_sm, encoder.ev);
-        break;
-      case PID_SETTINGS_PAGE:
-        pid_settings_page_handler(&gui_sm, encoder.ev);
-        break;
-      default:
-        break;
-      }
-    }
-
   }
   /* USER CODE END 3 */
 }
@@ -328,6 +609,7 @@ static void MX_TIM1_Init(void)
   /* USER CODE END TIM1_Init 0 */
 
   TIM_ClockConfigTypeDef sClockSourceConfig = {0};
+  TIM_SlaveConfigTypeDef sSlaveConfig = {0};
   TIM_MasterConfigTypeDef sMasterConfig = {0};
   TIM_OC_InitTypeDef sConfigOC = {0};
   TIM_BreakDeadTimeConfigTypeDef sBreakDeadTimeConfig = {0};
@@ -336,9 +618,9 @@ static void MX_TIM1_Init(void)
 
   /* USER CODE END TIM1_Init 1 */
   htim1.Instance = TIM1;
-  htim1.Init.Prescaler = 0;
+  htim1.Init.Prescaler = 100 - 1;
   htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim1.Init.Period = 120 - 1;
+  htim1.Init.Period = 65535;
   htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
   htim1.Init.RepetitionCounter = 0;
   htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
@@ -346,10 +628,7 @@ static void MX_TIM1_Init(void)
   {
     Error_Handler();
   }
-  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_ETRMODE2;
-  sClockSourceConfig.ClockPolarity = TIM_CLOCKPOLARITY_NONINVERTED;
-  sClockSourceConfig.ClockPrescaler = TIM_CLOCKPRESCALER_DIV1;
-  sClockSourceConfig.ClockFilter = 15;
+  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
   if (HAL_TIM_ConfigClockSource(&htim1, &sClockSourceConfig) != HAL_OK)
   {
     Error_Handler();
@@ -358,6 +637,15 @@ static void MX_TIM1_Init(void)
   {
     Error_Handler();
   }
+  sSlaveConfig.SlaveMode = TIM_SLAVEMODE_RESET;
+  sSlaveConfig.InputTrigger = TIM_TS_ETRF;
+  sSlaveConfig.TriggerPolarity = TIM_TRIGGERPOLARITY_NONINVERTED;
+  sSlaveConfig.TriggerPrescaler = TIM_TRIGGERPRESCALER_DIV1;
+  sSlaveConfig.TriggerFilter = 15;
+  if (HAL_TIM_SlaveConfigSynchro(&htim1, &sSlaveConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
   sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
   sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
   if (HAL_TIMEx_MasterConfigSynchronization(&htim1, &sMasterConfig) != HAL_OK)
@@ -375,11 +663,15 @@ static void MX_TIM1_Init(void)
   {
     Error_Handler();
   }
+  if (HAL_TIM_PWM_ConfigChannel(&htim1, &sConfigOC, TIM_CHANNEL_4) != HAL_OK)
+  {
+    Error_Handler();
+  }
   sBreakDeadTimeConfig.OffStateRunMode = TIM_OSSR_DISABLE;
-  sBreakDeadTimeConfig.OffStateIDLEMode = TIM_OSSI_DISABLE;
+  sBreakDeadTimeConfig.OffStateIDLEMode = TIM_OSSI_ENABLE;
   sBreakDeadTimeConfig.LockLevel = TIM_LOCKLEVEL_OFF;
   sBreakDeadTimeConfig.DeadTime = 0;
-  sBreakDeadTimeConfig.BreakState = TIM_BREAK_DISABLE;
+  sBreakDeadTimeConfig.BreakState = TIM_BREAK_ENABLE;
   sBreakDeadTimeConfig.BreakPolarity = TIM_BREAKPOLARITY_HIGH;
   sBreakDeadTimeConfig.AutomaticOutput = TIM_AUTOMATICOUTPUT_DISABLE;
   if (HAL_TIMEx_ConfigBreakDeadTime(&htim1, &sBreakDeadTimeConfig) != HAL_OK)
@@ -388,6 +680,9 @@ static void MX_TIM1_Init(void)
   }
   /* USER CODE BEGIN TIM1_Init 2 */
 
+  // Break (software BG event on a fault) clears MOE: with OSSI the SSR
+  // outputs are then driven to their idle level (low) until MOE is set again
+
   /* USER CODE END TIM1_Init 2 */
   HAL_TIM_MspPostInit(&htim1);
 }
@@ -459,9 +754,9 @@ static void MX_TIM3_Init(void)
 
   /* USER CODE END TIM3_Init 1 */
   htim3.Instance = TIM3;
-  htim3.Init.Prescaler = 10000 - 1;
+  htim3.Init.Prescaler = 100 - 1;
   htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim3.Init.Period = 2500 - 1;
+  htim3.Init.Period = 1000 - 1;
   htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
   htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
   if (HAL_TIM_Base_Init(&htim3) != HAL_OK)
@@ -484,6 +779,69 @@ static void MX_TIM3_Init(void)
   /* USER CODE END TIM3_Init 2 */
 }
 
+/**
+ * @brief TIM4 Initialization Function
+ * @param None
+ * @retval None
+ */
+static void MX_TIM4_Init(void)
+{
+
+  /* USER CODE BEGIN TIM4_Init 0 */
+
+  /* USER CODE END TIM4_Init 0 */
+
+  TIM_ClockConfigTypeDef sClockSourceConfig = {0};
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
+  TIM_OC_InitTypeDef sConfigOC = {0};
+
+  /* USER CODE BEGIN TIM4_Init 1 */
+
+  /* USER CODE END TIM4_Init 1 */
+  htim4.Instance = TIM4;
+  htim4.Init.Prescaler = 100 - 1;
+  htim4.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim4.Init.Period = 20000 - 1;
+  htim4.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim4.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+  if (HAL_TIM_Base_Init(&htim4) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sClockSourceConfig.ClockSource = TIM_CLOCKSOURCE_INTERNAL;
+  if (HAL_TIM_ConfigClockSource(&htim4, &sClockSourceConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  if (HAL_TIM_PWM_Init(&htim4) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIMEx_MasterConfigSynchronization(&htim4, &sMasterConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sConfigOC.OCMode = TIM_OCMODE_PWM1;
+  sConfigOC.Pulse = 0;
+  sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+  sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+  if (HAL_TIM_PWM_ConfigChannel(&htim4, &sConfigOC, TIM_CHANNEL_3) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sConfigOC.Pulse = 1000;
+  if (HAL_TIM_PWM_ConfigChannel(&htim4, &sConfigOC, TIM_CHANNEL_4) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  /* USER CODE BEGIN TIM4_Init 2 */
+
+  /* USER CODE END TIM4_Init 2 */
+  HAL_TIM_MspPostInit(&htim4);
+}
+
 /**
  * @brief USART1 Initialization Function
  * @param None
@@ -585,14 +943,246 @@ static void MX_GPIO_Init(void)
 /* USER CODE BEGIN 4 */
 
 //
-void update_randomCrossover_actuator(uint8_t ON_semiCicles)
+void update_randomCrossover_actuator(uint8_t zone, float power)
 {
-  __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_1, ON_semiCicles);
+  PROF_BEGIN(PROF_ACTUATOR);
+  // The zero-cross interrupt spreads the ON half-cycles evenly
+  HalfCycle_setLevel(zone, power);
+  PROF_END(PROF_ACTUATOR);
 }
 
 //
-void chamber_sense_temperature()
+void fire_next_halfCycle()
 {
+  static uint32_t zeroCrosses = 0; // Since the line last came back
+  uint8_t zone, fired;
+  uint32_t cycles = DWT_getCycles();
+  bool wasPresent = Mains_isPresent();
+
+  // TIM1 is reset by every zero cross (trigger); an update without trigger
+  // is a counter overflow, i.e. no zero cross for 65 ms: mains is gone
+  if (!__HAL_TIM_GET_FLAG(&htim1, TIM_FLAG_TRIGGER))
+  {
+    if (wasPresent)
+    {
+      EventQueue_push(&mainsEvents, EVENT_MAINS_LOST, (int32_t)zeroCrosses, cycles);
+      TRACE(TRACE_MAINS_LOST, zeroCrosses);
+    }
+    Mains_onLoss();
+    HalfCycle_flush();
+    for (zone = 0; zone < HeaterZones_count; zone++)
+    {
+      __HAL_TIM_SET_COMPARE(&htim1, HeaterZones[zone].config.channel, 0);
+    }
+    return;
+  }
+  __HAL_TIM_CLEAR_FLAG(&htim1, TIM_FLAG_TRIGGER);
+  Mains_onZeroCross(cycles);
+  zeroCrosses++;
+  if (!wasPresent && Mains_isPresent())
+  {
+    EventQueue_push(&mainsEvents, EVENT_MAINS_RESTORED, 0, cycles);
+    TRACE(TRACE_MAINS_RESTORED, 0);
+    zeroCrosses = 0;
+  }
+
+  // Preloaded compare: the decision applies from the next zero cross on,
+  // a compare above any count keeps the SSR input high for the whole half-cycle
+  fired = HalfCycle_step(HeaterZones_count);
+  EnergyMeter_onHalfCycle(fired);
+  TRACE(TRACE_ZERO_CROSS, fired);
+  for (zone = 0; zone < HeaterZones_count; zone++)
+  {
+    __HAL_TIM_SET_COMPARE(&htim1, HeaterZones[zone].config.channel,
+                          (fired & (1u << zone)) ? 0xFFFF : 0);
+  }
+}
+
+//
+void update_heater_zones(uint32_t now)
+{
+  uint8_t zone;
+
+  // Only probes that answered in this tick feed the zone controllers
+  HeaterZones_update(&PID, tempReadings, probes_healthy_mask(), chamber_temp);
+
+  // A latched fault keeps every heater off until the operator acknowledges it
+  if (ThermalFault_get() != FAULT_NONE)
+  {
+    applied_power = 0.0f;
+    return;
+  }
+
+  // A reflow start takes the heaters back from the calibration
+  if (PowerLin_isCalibrating() && ReflowOven_getCurrentPhase() != REFLOW_IDLE)
+  {
+    PowerLin_abortCalibration();
+  }
+  if (PowerLin_isCalibrating())
+  {
+    float duty = PowerLin_calibrationUpdate(now, chamber_temp);
+    for (zone = 0; zone < HeaterZones_count; zone++)
+    {
+      update_randomCrossover_actuator(zone, duty);
+    }
+    applied_power = duty;
+    return;
+  }
+
+  // Requested power -> duty through the calibrated table
+  applied_power = 0.0f;
+  for (zone = 0; zone < HeaterZones_count; zone++)
+  {
+    float duty = PowerLin_apply(HeaterZones[zone].power);
+    update_randomCrossover_actuator(zone, duty);
+    if (duty > applied_power)
+    {
+      applied_power = duty;
+    }
+  }
+}
+
+//
+uint8_t probes_healthy_mask()
+{
+  uint8_t healthy = 0;
+  uint8_t sensor;
+
+  for (sensor = 0; sensor < 4; sensor++)
+  {
+    if (tempSensors.devices[sensor].is_connected)
+    {
+      healthy |= (uint8_t)(1u << sensor);
+    }
+  }
+  return healthy;
+}
+
+//
+void check_thermal_faults(uint32_t now)
+{
+  static ThermalFault_t reportedFault = FAULT_NONE;
+  ThermalFault_t fault;
+  float observed, expected;
+
+  // A control loop that keeps missing its periods is not regulating the oven any more
+  if (ControlTiming_isTripped())
+  {
+    ThermalFault_raise(FAULT_CONTROL_TIMING);
+  }
+  // An open door is not a heater fault
+  if (Transient_getState() == TRANSIENT_DOOR_OPEN)
+  {
+    ThermalFault_holdSlopeChecks();
+  }
+  fault = ThermalFault_update(now, applied_power, chamber_temp, tempReadings, probes_healthy_mask());
+  if (fault == reportedFault)
+  {
+    return;
+  }
+  reportedFault = fault;
+  if (fault == FAULT_NONE)
+  {
+    // Acknowledged by the operator: give the outputs back to the timer
+    __HAL_TIM_MOE_ENABLE(&htim1);
+    return;
+  }
+
+  enter_safe_state();
+  TRACE(TRACE_FAULT, fault);
+  // Reported by the telemetry task: the UART stays out of the control step
+  ThermalFault_getSlopes(&observed, &expected);
+  faultReport.fault = fault;
+  faultReport.probe = ThermalFault_getProbe();
+  faultReport.temperature = chamber_temp;
+  faultReport.observed = observed;
+  faultReport.expected = expected;
+  faultReportPending = true;
+}
+
+//
+void enter_safe_state()
+{
+  uint8_t zone;
+
+  // Heaters off right now in hardware: the break clears MOE, the outputs go idle (low)
+  HAL_TIM_GenerateEvent(&htim1, TIM_EVENTSOURCE_BREAK);
+
+  // And in the modulator, so nothing is owed when the outputs come back
+  for (zone = 0; zone < HeaterZones_count; zone++)
+  {
+    HalfCycle_setLevel(zone, 0.0f);
+    __HAL_TIM_SET_COMPARE(&htim1, HeaterZones[zone].config.channel, 0);
+  }
+  HalfCycle_flush();
+  applied_power = 0.0f;
+
+  // Drop whatever was driving them
+  PowerLin_abortCalibration();
+  BatchQueue_abort();
+  ReflowOven_emergencyStop();
+}
+
+//
+void drive_actuators_safe()
+{
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+  // Out of reset the SSR and fan inputs float on their pull-downs: hold them low until
+  // TIM1 (MOE off, idle low) and TIM4 take the pins over
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+  HAL_GPIO_WritePin(fire_GPIO_Port, fire_Pin | fire_top_Pin, GPIO_PIN_RESET);
+  HAL_GPIO_WritePin(fan_GPIO_Port, fan_Pin, GPIO_PIN_RESET);
+
+  GPIO_InitStruct.Pin = fire_Pin | fire_top_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+  GPIO_InitStruct.Pull = GPIO_PULLDOWN;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  HAL_GPIO_Init(fire_GPIO_Port, &GPIO_InitStruct);
+
+  GPIO_InitStruct.Pin = fan_Pin;
+  HAL_GPIO_Init(fan_GPIO_Port, &GPIO_InitStruct);
+}
+
+//
+void update_cooling_actuator()
+{
+  bool heaterOff = true;
+  float fan, door;
+  uint8_t zone;
+
+  // Split range: the fan and the door only move while no heater fires
+  for (zone = 0; zone < HeaterZones_count; zone++)
+  {
+    if (HeaterZones[zone].power != 0)
+    {
+      heaterOff = false;
+    }
+  }
+  Cooling_update(ReflowOven_getCurrentPhase(), ReflowOven.currentSetpoint, chamber_temp, heaterOff);
+  fan = Cooling_getFanDuty();
+  door = Cooling_getDoorOpening();
+
+  // A latched fault vents the chamber: a shorted SSR cannot be switched off from here
+  if (ThermalFault_get() != FAULT_NONE)
+  {
+    fan = 100.0f;
+    door = 100.0f;
+  }
+
+  // TIM4 counts microseconds over a 20 ms frame
+  __HAL_TIM_SET_COMPARE(&htim4, TIM_CHANNEL_3,
+                        (uint32_t)(fan * (COOLING_PWM_PERIOD_US / 100.0f)));
+  __HAL_TIM_SET_COMPARE(&htim4, TIM_CHANNEL_4,
+                        COOLING_DOOR_CLOSED_US +
+                            (uint32_t)(door * ((COOLING_DOOR_OPEN_US - COOLING_DOOR_CLOSED_US) / 100.0f)));
+}
+
+//
+void chamber_sense_temperature(float *probes, float *chamber)
+{
+  PROF_BEGIN(PROF_SENSE);
   // Sample chamber's temperature
   uint8_t sensor;
   for (sensor = 0; sensor < 4; sensor++)
@@ -602,31 +1192,780 @@ void chamber_sense_temperature()
     HAL_Delay(1);
   }
   // Take each measurements and compute chamber's temperature
-  chamber_temp = 0;
+  *chamber = 0;
   for (sensor = 0; sensor < 4; sensor++)
   {
-    MAX6675_GetTemperature(&tempSensors, sensor, tempReadings + sensor);
-    chamber_temp += tempReadings[sensor];
+    MAX6675_GetTemperature(&tempSensors, sensor, probes + sensor);
+    *chamber += probes[sensor];
+  }
+  *chamber /= 4; // media
+  if (probes_healthy_mask() != 0)
+  {
+    BootProfile_mark(BOOT_STEP_FIRST_SAMPLE);
+  }
+  PROF_END(PROF_SENSE);
+}
+
+//
+void record_control_tick(uint32_t now, uint8_t power)
+{
+  RunRecorder_sample_t sample;
+  uint8_t sensor;
+
+  sample.timeMs = now;
+  sample.phase = (uint8_t)ReflowOven_getCurrentPhase();
+  sample.output = power;
+  sample.setpoint = RunRecorder_quantize(ReflowOven.currentSetpoint, RUNREC_TEMP_SCALE);
+  for (sensor = 0; sensor < RUNREC_NUM_PROBES; sensor++)
+  {
+    // Raw reading of each probe, -404 °C when it faulted
+    sample.probe[sensor] = RunRecorder_quantize(tempSensors.devices[sensor].temperature, RUNREC_PROBE_SCALE);
+  }
+  sample.fused = RunRecorder_quantize(chamber_temp, RUNREC_TEMP_SCALE);
+  sample.pTerm = RunRecorder_quantize(PID.Kp * PID.prevError, RUNREC_PID_SCALE);
+  sample.iTerm = RunRecorder_quantize(PID.integrator, RUNREC_PID_SCALE);
+  sample.dTerm = RunRecorder_quantize(PID.differentiator, RUNREC_PID_SCALE);
+
+  // Closing a run erases a flash sector with the CPU stalled for up to 2 s:
+  // heaters off through MOE and a wider watchdog for the duration
+  if (RunRecorder_isRecording() && sample.phase >= REFLOW_IDLE)
+  {
+    __HAL_TIM_MOE_DISABLE_UNCONDITIONALLY(&htim1);
+    Watchdog_setTimeout(WATCHDOG_FLASH_TIMEOUT_MS);
+    RunRecorder_record(&sample);
+    Watchdog_setTimeout(WATCHDOG_TIMEOUT_MS);
+    if (ThermalFault_get() == FAULT_NONE)
+    {
+      __HAL_TIM_MOE_ENABLE(&htim1);
+    }
+    return;
+  }
+  RunRecorder_record(&sample);
+}
+
+//
+void report_mains()
+{
+  static uint8_t reportedHz = 0;
+
+  // One line when the grid is first identified and whenever it changes
+  if (!Mains_isLocked() || Mains_getNominalHz() == reportedHz)
+  {
+    return;
+  }
+  reportedHz = Mains_getNominalHz();
+  Telemetry_printf("$MAINS,%u,%.2f,%.0f", reportedHz, Mains_getFrequency(), Mains_getJitterUs());
+}
+
+//
+void report_boot(uint32_t now)
+{
+  static bool reported = false;
+  uint32_t us;
+  uint8_t step;
+
+  // Once: when the first valid sample closes the boot, or without one after the timeout
+  if (reported || (!BootProfile_get(BOOT_STEP_FIRST_SAMPLE, &us) && now < BOOT_REPORT_TIMEOUT_MS))
+  {
+    return;
+  }
+  reported = true;
+
+  // Completion time of each step since the entry to main(), boot order
+  for (step = 0; step < BOOT_NUM_STEPS; step++)
+  {
+    if (BootProfile_get((BootProfile_step_t)step, &us))
+    {
+      Telemetry_printf("$BOOT,%s,%lu", BootProfile_getName((BootProfile_step_t)step), us);
+    }
+  }
+}
+
+//
+void report_power_calibration()
+{
+  static PowerLin_calState_t reportedState = PWRLIN_CAL_IDLE;
+  PowerLin_calState_t state = PowerLin_getCalibrationState();
+  const float *table = PowerLin_getTable();
+
+  if (state == reportedState)
+  {
+    return;
+  }
+  reportedState = state;
+  if (state == PWRLIN_CAL_DONE)
+  {
+    // Duty (%) for requests 0..100 % in 10 % steps
+    Telemetry_printf("$PWRLIN,DONE,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f",
+                     table[0], table[1], table[2], table[3], table[4], table[5],
+                     table[6], table[7], table[8], table[9], table[10]);
+    if (!PowerLin_isStored())
+    {
+      // No blank flash slot: the table is saved when the next run is stored
+      Telemetry_printf("$PWRLIN,NOT_SAVED");
+    }
+  }
+  else if (state == PWRLIN_CAL_FAILED)
+  {
+    Telemetry_printf("$PWRLIN,FAILED");
+  }
+  else if (state == PWRLIN_CAL_RUNNING)
+  {
+    Telemetry_printf("$PWRLIN,START,%.1f", chamber_temp);
   }
-  chamber_temp /= 4; // media
 }
 
+//
+void report_run_energy()
+{
+  static bool wasRecording = false;
+  const RunRecorder_summary_t *summary = RunRecorder_getSummary();
+
+  // One line per finished run: total, then PREHEAT..COOLDOWN (Wh)
+  if (wasRecording && !RunRecorder_isRecording())
+  {
+    Telemetry_printf("$ENERGY,%u,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f", summary->runId, summary->energyWh,
+                     summary->phaseEnergyWh[REFLOW_PREHEAT], summary->phaseEnergyWh[REFLOW_SOAK],
+                     summary->phaseEnergyWh[REFLOW_HEATUP], summary->phaseEnergyWh[REFLOW_REFLOW],
+                     summary->phaseEnergyWh[REFLOW_COOLDOWN]);
+  }
+  wasRecording = RunRecorder_isRecording();
+}
+
+//
+void report_transients()
+{
+  static Transient_state_t reportedState = TRANSIENT_NONE;
+  static uint16_t reportedLoadChanges = 0;
+  Transient_state_t state = Transient_getState();
+
+  if (state != reportedState)
+  {
+    reportedState = state;
+    Telemetry_printf("$DOOR,%s,%.1f,%.1f", (state == TRANSIENT_DOOR_OPEN) ? "OPEN" : "CLOSED",
+                     chamber_temp, ReflowOven.currentSetpoint);
+  }
+  if (Transient_getLoadChanges() != reportedLoadChanges)
+  {
+    reportedLoadChanges = Transient_getLoadChanges();
+    Telemetry_printf("$LOAD,%u,%.2f", reportedLoadChanges, ChamberModel_getGain());
+  }
+}
+
+//
+void report_thermal_mass()
+{
+  static ThermalMass_state_t reportedState = THERMALMASS_IDLE;
+  ThermalMass_state_t state = ThermalMass_getState();
+
+  if (state == reportedState)
+  {
+    return;
+  }
+  reportedState = state;
+  // Result of the preheat identification: mass ratio, gain (°C/s), soak used (s)
+  if (state == THERMALMASS_DONE)
+  {
+    Telemetry_printf("$MASS,%.2f,%.2f,%.0f", ThermalMass_getRatio(), ChamberModel_getGain(),
+                     ReflowOven.soakTimeMs * 0.001f);
+  }
+  else if (state == THERMALMASS_FAILED)
+  {
+    Telemetry_printf("$MASS,FAILED");
+  }
+}
+
+//
+void report_scheduler(uint32_t now)
+{
+  static uint32_t lastReport = 0;
+  const Scheduler_taskConfig_t *task;
+  const Scheduler_stats_t *stats;
+
+  if (now - lastReport < SCHED_REPORT_MS)
+  {
+    return;
+  }
+  lastReport = now;
+
+  // Per task: runs, overruns, skipped releases, worst latency, response and execution (us)
+  for (uint8_t id = 0; id < Scheduler_getTaskCount(); id++)
+  {
+    task = Scheduler_getTask(id);
+    stats = Scheduler_getStats(id);
+    Telemetry_printf("$SCHED,%s,%lu,%lu,%lu,%lu,%lu,%lu", task->name, stats->runs, stats->overruns,
+                     stats->skipped, stats->maxLatencyUs, stats->maxResponseUs, stats->maxExecUs);
+  }
+}
+
+//
+void report_jitter(uint32_t now)
+{
+  static uint32_t lastReport = 0;
+  ControlTiming_stats_t jitter;
+
+  if (now - lastReport < SCHED_REPORT_MS)
+  {
+    return;
+  }
+  lastReport = now;
+
+  // Over the last interval: period deviation count, min, max, RMS, release latency min, max and
+  // worst response (us); then missed periods and deadline overruns since boot
+  ControlTiming_get(&jitter);
+  Telemetry_printf("$JITTER,%s,%lu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%lu,%lu", BUILD_FLAVOUR, jitter.intervals,
+                   jitter.minDeviationUs, jitter.maxDeviationUs, jitter.rmsDeviationUs, jitter.minLatencyUs,
+                   jitter.maxLatencyUs, jitter.maxResponseUs, jitter.missed, jitter.overruns);
+  ControlTiming_reset();
+}
+
+//
+void report_cpu_load(uint32_t now)
+{
+  static uint32_t lastReport = 0;
+  CpuLoad_stats_t load;
+
+  if (now - lastReport < SCHED_REPORT_MS)
+  {
+    return;
+  }
+  lastReport = now;
+
+  // Over the last interval: window (ms), time awake and asleep (%), wake-ups from WFI
+  CpuLoad_update(now, &load);
+  Telemetry_printf("$CPU,%s,%lu,%.1f,%.1f,%lu", BUILD_FLAVOUR, load.windowMs, load.loadPct, load.idlePct,
+                   load.wakeups);
+}
+
+//
+void report_memory(uint32_t now)
+{
+  static uint32_t lastReport = 0;
+  MemGuard_stats_t mem;
+
+  if (now - lastReport < SCHED_REPORT_MS)
+  {
+    return;
+  }
+  lastReport = now;
+
+  // Bytes: static data, heap, RAM left between heap and stack, deepest stack / its reserve, canary
+  MemGuard_getStats(&mem);
+  Telemetry_printf("$MEM,%lu,%lu,%lu,%lu,%lu,%s", mem.staticBytes, mem.heapBytes, mem.freeBytes,
+                   mem.stackPeakBytes, mem.stackReserve, mem.intact ? "OK" : "OVERFLOW");
+}
+
+//
+void report_mains_events(uint32_t now)
+{
+  EventQueue_event_t event;
+  uint32_t ageMs;
+
+  // Line drop-outs as they happen, stamped in the HAL time base
+  while (EventQueue_pop(&mainsEvents, &event))
+  {
+    ageMs = (uint32_t)(DWT_cyclesToUs(DWT_getCycles() - event.cycles) / 1000.0f);
+    if (event.type == EVENT_MAINS_LOST)
+    {
+      Telemetry_printf("$MAINSEV,LOST,%lu,%ld", now - ageMs, event.value);
+    }
+    else if (event.type == EVENT_MAINS_RESTORED)
+    {
+      Telemetry_printf("$MAINSEV,BACK,%lu", now - ageMs);
+    }
+  }
+}
+
+//
+void report_event_queues(uint32_t now)
+{
+  static uint32_t lastReport = 0;
+
+  if (now - lastReport < SCHED_REPORT_MS)
+  {
+    return;
+  }
+  lastReport = now;
+
+  // Per queue: high-water mark and events lost to a full queue
+  Telemetry_printf("$EVQ,input,%u,%lu", EventQueue_getHighWater(&inputEvents), EventQueue_getOverflows(&inputEvents));
+  Telemetry_printf("$EVQ,mains,%u,%lu", EventQueue_getHighWater(&mainsEvents), EventQueue_getOverflows(&mainsEvents));
+  Telemetry_printf("$EVQ,uart,%u,%lu", EventQueue_getHighWater(&uartEvents), EventQueue_getOverflows(&uartEvents));
+}
+
+//
+void report_profile()
+{
+#if PROF_ENABLE
+  const Profiler_stats_t *stats;
+  char line[TELEMETRY_LINE_SIZE];
+  int length;
+
+  for (uint8_t point = 0; point < PROF_NUM_POINTS; point++)
+  {
+    stats = Profiler_getStats(point);
+
+    // Runs, then min / mean / max duration (us)
+    Telemetry_printf("$PROF,%s,%lu,%.1f,%.1f,%.1f", Profiler_getName(point), stats->count,
+                     DWT_cyclesToUs(stats->minCycles),
+                     (stats->count > 0) ? DWT_cyclesToUs((uint32_t)(stats->totalCycles / stats->count)) : 0.0f,
+                     DWT_cyclesToUs(stats->maxCycles));
+
+    // Runs per log2 bucket, see profiler.h for the bounds
+    length = snprintf(line, sizeof(line), "$PROFH,%s", Profiler_getName(point));
+    for (uint8_t bucket = 0; bucket < PROF_NUM_BUCKETS && length < (int)sizeof(line); bucket++)
+    {
+      length += snprintf(line + length, sizeof(line) - length, ",%lu", stats->histogram[bucket]);
+    }
+    Telemetry_printf("%s", line);
+  }
+#else
+  Telemetry_printf("$PROF,DISABLED");
+#endif
+}
+
+//
+void report_fault()
+{
+  fault_report_t report;
+
+  if (!faultReportPending)
+  {
+    return;
+  }
+  report = faultReport;
+  faultReportPending = false;
+  Telemetry_printf("$FAULT,%u,%u,%.1f,%.2f,%.2f", report.fault, report.probe, report.temperature,
+                   report.observed, report.expected);
+}
+
+//
+void report_batch()
+{
+  BatchQueue_report_t report;
+  uint32_t lock;
+  bool pending;
+
+  // Queued by the GUI and the control step, printed here where the UART may block
+  for (;;)
+  {
+    lock = ControlIsr_lock();
+    pending = BatchQueue_getReport(&report);
+    ControlIsr_unlock(lock);
+    if (!pending)
+    {
+      return;
+    }
+    switch (report.type)
+    {
+    case BATCH_REPORT_START:
+      Telemetry_printf("$BATCH,START,%u,%u", report.boards, report.entries);
+      break;
+    case BATCH_REPORT_BOARD:
+      Telemetry_printf("$BOARD,%u,%u,%.1f,%.1f,%.1f,%.1f,%.1f,%u", report.boards, report.entries,
+                       report.durationS, report.peakTemperature, report.timeAboveLiquidusS,
+                       report.zoneSpreadMax, report.energyWh, report.endReason);
+      break;
+    case BATCH_REPORT_WAIT:
+      Telemetry_printf("$BATCH,WAIT,%u,%u,%.1f", report.boards, report.entries, report.boardsPerHour);
+      break;
+    case BATCH_REPORT_END:
+      Telemetry_printf("$BATCH,END,%u,%.1f", report.boards, report.boardsPerHour);
+      break;
+    case BATCH_REPORT_ABORT:
+      Telemetry_printf("$BATCH,ABORT,%u,%.1f", report.boards, report.boardsPerHour);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+//
+void start_trace_dump()
+{
+#if TRACE_ENABLE
+  // Frozen until the last line is out, so the dump is one consistent window
+  Trace_freeze(true);
+  traceDumpNext = 0;
+  traceDumpCount = Trace_getCount();
+  traceDumping = true;
+
+  // Header: core clock, records, events dropped while frozen, event mask; then the task names
+  Telemetry_printf("$TRACE,BEGIN,%lu,%lu,%lu,%08lx", SystemCoreClock, traceDumpCount, Trace_getDropped(),
+                   Trace_getMask());
+  for (uint8_t id = 0; id < Scheduler_getTaskCount(); id++)
+  {
+    Telemetry_printf("$TRACE,TASK,%u,%s", id, Scheduler_getTask(id)->name);
+  }
+#endif
+}
+
+//
+void report_trace()
+{
+#if TRACE_ENABLE
+  char line[TELEMETRY_LINE_SIZE];
+  const Trace_record_t *record;
+  uint8_t lines, slot;
+  int length;
+
+  if (!traceDumping)
+  {
+    return;
+  }
+
+  // A few lines per tick: the whole ring at once would hold the UART for ~1.5 s
+  for (lines = 0; lines < TRACE_DUMP_LINES && traceDumpNext < traceDumpCount; lines++)
+  {
+    // Index of the first record, then stamp and id/payload of each as 8 hex digits
+    length = snprintf(line, sizeof(line), "$TR,%lu,", traceDumpNext);
+    for (slot = 0; slot < TRACE_LINE_RECORDS && traceDumpNext < traceDumpCount; slot++, traceDumpNext++)
+    {
+      record = Trace_get(traceDumpNext);
+      length += snprintf(line + length, sizeof(line) - length, "%08lx%08lx", record->cycles, record->data);
+    }
+    Telemetry_printf("%s", line);
+  }
+  if (traceDumpNext >= traceDumpCount)
+  {
+    Telemetry_printf("$TRACE,END");
+    traceDumping = false;
+    Trace_freeze(false);
+  }
+#endif
+}
+
+//
+void process_commands()
+{
+  static char command[COMMAND_LINE_SIZE];
+  static uint8_t length = 0;
+  EventQueue_event_t event;
+
+  // Assemble lines from the received bytes; overlong lines are dropped whole
+  while (EventQueue_pop(&uartEvents, &event))
+  {
+    if (event.value != '\r' && event.value != '\n')
+    {
+      if (length < COMMAND_LINE_SIZE)
+      {
+        command[length] = (char)event.value;
+      }
+      if (length <= COMMAND_LINE_SIZE)
+      {
+        length++;
+      }
+      continue;
+    }
+    if (length == 0 || length >= COMMAND_LINE_SIZE)
+    {
+      length = 0;
+      continue;
+    }
+    command[length] = '\0';
+    length = 0;
+
+    if (strcmp(command, "PROF") == 0)
+    {
+      report_profile();
+    }
+#if PROF_ENABLE
+    else if (strcmp(command, "PROF RESET") == 0)
+    {
+      Profiler_reset();
+      Telemetry_printf("$PROF,RESET");
+    }
+#endif
+#if TRACE_ENABLE
+    else if (strcmp(command, "TRACE") == 0)
+    {
+      start_trace_dump();
+    }
+    else if (strcmp(command, "TRACE CLEAR") == 0)
+    {
+      traceDumping = false;
+      Trace_Init();
+      Telemetry_printf("$TRACE,CLEAR");
+    }
+    else if (strncmp(command, "TRACE MASK ", 11) == 0)
+    {
+      Trace_setMask(strtoul(command + 11, NULL, 16));
+      Telemetry_printf("$TRACE,MASK,%08lx", Trace_getMask());
+    }
+#endif
+    else
+    {
+      Telemetry_printf("$ERR,UNKNOWN,%s", command);
+    }
+  }
+}
+
+// TASKS
+void task_sense(uint32_t now)
+{
+  // Get temperature inside oven
+  chamber_sense_temperature(tempReadings, &chamber_temp);
+  // Fault detection first: a fault forces the safe state before anything fires
+  check_thermal_faults(now);
+}
+
+//
+void task_control(uint32_t now)
+{
+  PIDGains gains;
+
+  // Start of the control step: the jitter reference point of both builds
+  ControlTiming_start(DWT_getCycles());
+  TRACE(TRACE_CONTROL_BEGIN, now);
+  // Gains edited on the GUI take effect between two ticks, never within one
+  if (GUI_GetPidGains(&gains))
+  {
+    PID_UpdateGains(&PID, gains.Kp, gains.Ki, gains.Kd);
+  }
+  // Process data and update state
+  PROF_BEGIN(PROF_OPERATE);
+  ReflowOven_operate(&PID, chamber_temp, now);
+  PROF_END(PROF_OPERATE);
+}
+
+//
+void task_actuate(uint32_t now)
+{
+  // Run the zone controllers and act on heat elements
+  update_heater_zones(now);
+  update_cooling_actuator();
+  ControlTiming_end(DWT_getCycles());
+  TRACE(TRACE_CONTROL_END, applied_power);
+  // A stack that ran past its reserve has overwritten whatever lies below: heaters off, reset
+  if (!MemGuard_isIntact())
+  {
+    Error_Handler();
+  }
+  // Sense -> operate -> actuate went through: the loop is alive
+  Watchdog_feed();
+}
+
+//
+void task_logging(uint32_t now)
+{
+  // Keep a trace of the tick for the run recorder: the duty actually fired, not the PID request
+  record_control_tick(now, (uint8_t)applied_power);
+  RunRecorder_recordZoneSpread(HeaterZones_getSpread());
+  RunRecorder_recordEnergy(EnergyMeter_update(Mains_isLocked() ? 2.0f * Mains_getFrequency()
+                                                               : Mains_getHalfCyclesPerSecond()));
+  // Hand-off to the next board when running a batch: restarts the process under the control step
+  uint32_t lock = ControlIsr_lock();
+  BatchQueue_update(now);
+  ControlIsr_unlock(lock);
+}
+
+//
+void task_telemetry(uint32_t now)
+{
+  report_fault();
+  report_batch();
+  report_trace();
+  report_boot(now);
+  report_run_energy();
+  report_transients();
+  report_thermal_mass();
+  report_mains();
+  report_power_calibration();
+  report_scheduler(now);
+  report_jitter(now);
+  report_cpu_load(now);
+  report_memory(now);
+  report_mains_events(now);
+  report_event_queues(now);
+  process_commands();
+}
+
+//
+void task_gui(uint32_t now)
+{
+  ENCODER_EVENT_UPDATE(&encoder);
+  if (encoder.ev != IDLE_EVENT)
+  {
+    TRACE(TRACE_GUI_EVENT, ((uint32_t)gui_sm.current_page << 8) | encoder.ev);
+  }
+  switch (gui_sm.current_page)
+  {
+  case MAIN_PAGE:
+  {
+    PROF_BEGIN(PROF_GUI_MAIN);
+    main_page_handler(&gui_sm, encoder.ev);
+    PROF_END(PROF_GUI_MAIN);
+    break;
+  }
+  case OVEN_SETTINGS_PAGE:
+  {
+    PROF_BEGIN(PROF_GUI_OVEN);
+    oven_settings_page_handler(&gui_sm, encoder.ev);
+    PROF_END(PROF_GUI_OVEN);
+    break;
+  }
+  case PID_SETTINGS_PAGE:
+  {
+    PROF_BEGIN(PROF_GUI_PID);
+    pid_settings_page_handler(&gui_sm, encoder.ev);
+    PROF_END(PROF_GUI_PID);
+    break;
+  }
+  case DIAGNOSTICS_PAGE:
+  {
+    PROF_BEGIN(PROF_GUI_DIAG);
+    diagnostics_page_handler(&gui_sm, encoder.ev);
+    PROF_END(PROF_GUI_DIAG);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+#if REFLOW_CONTROL_IN_ISR
+// CONTROL STEP IN PENDSV
+void task_acquire(uint32_t now)
+{
+  control_sample_t *sample = DoubleBuffer_back(&sampleHandoff);
+
+  // Only the background blocks on the SPI reads and conversion gaps
+  chamber_sense_temperature(sample->probes, &sample->chamber);
+  DoubleBuffer_publish(&sampleHandoff);
+}
+
+//
+void control_step_isr(void)
+{
+  uint32_t now = controlIsrReleaseMs;
+  control_sample_t sample;
+  uint8_t sensor;
+
+  // No sample since the last step: skip the period, the timing monitor counts it as
+  // missed and the watchdog is not fed, as when the cooperative sense task stalls
+  if (!DoubleBuffer_read(&sampleHandoff, &sample, &sampleSeen))
+  {
+    return;
+  }
+  for (sensor = 0; sensor < 4; sensor++)
+  {
+    tempReadings[sensor] = sample.probes[sensor];
+  }
+  chamber_temp = sample.chamber;
+
+  check_thermal_faults(now);
+  task_control(now);
+  task_actuate(now);
+}
+
+//
+// Not generated in stm32f4xx_it.c: in the RTOS build the kernel port owns PendSV
+void PendSV_Handler(void)
+{
+  // Control step released by the TIM3 timebase
+  control_step_isr();
+}
+#endif
+
+#if REFLOW_USE_RTOS
+// RTOS TASKS
+void rtos_acquire(AppRtos_sample_t *sample)
+{
+  // The acquisition wake is the release of the control cycle in this build
+  ControlTiming_release(DWT_getCycles());
+  TRACE(TRACE_CONTROL_RELEASE, sample->timeMs);
+  // Only this task blocks on the SPI reads and conversion gaps
+  chamber_sense_temperature(sample->probes, &sample->chamber);
+}
+
+//
+void rtos_control(const AppRtos_sample_t *sample)
+{
+  uint8_t sensor;
+
+  // Publish the sample to the shared state the process, GUI and recorder read
+  for (sensor = 0; sensor < APPRTOS_NUM_PROBES; sensor++)
+  {
+    tempReadings[sensor] = sample->probes[sensor];
+  }
+  chamber_temp = sample->chamber;
+
+  check_thermal_faults(sample->timeMs);
+  task_control(sample->timeMs);
+  task_actuate(sample->timeMs);
+}
+#endif
+
 // ISR
 void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
   if (GPIO_Pin == encoder_pulse_Pin)
   {
-    // TODO: Add a anti-bouncing algorithm
-    encoder.isr_reg |= 0x01;
+    // Queued with its timestamp; the GUI drops the bounces
+    EventQueue_push(&inputEvents, EVENT_BUTTON_PRESS, 0, DWT_getCycles());
+    TRACE(TRACE_BUTTON, 0);
+    Scheduler_release(guiTaskId);
+  }
+}
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+  // Encoder step: the GUI reads the counter now rather than at its next refresh
+  if (htim == &htim2)
+  {
+    TRACE(TRACE_ENCODER, __HAL_TIM_GET_COUNTER(&htim2));
+    Scheduler_release(guiTaskId);
+  }
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if (huart == &huart1)
+  {
+    EventQueue_push(&uartEvents, EVENT_UART_RX, uartRxByte, DWT_getCycles());
+    TRACE(TRACE_UART_RX, uartRxByte);
+    HAL_UART_Receive_IT(&huart1, &uartRxByte, 1);
+  }
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  // Overrun or framing error ends the reception: re-arm it
+  if (huart == &huart1)
+  {
+    HAL_UART_Receive_IT(&huart1, &uartRxByte, 1);
   }
 }
 
 void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
 {
-  // ISR for periodic sample of sensors
+  // ISR for the 1 ms scheduler timebase
   if (htim == &htim3)
   {
-    timers_isr |= 0x01;
+#if REFLOW_CONTROL_IN_ISR
+    Scheduler_tick();
+    // Control step: chained to PendSV, runs as soon as no other interrupt is active
+    if ((int32_t)(Scheduler_getTime() - controlIsrNextMs) >= 0)
+    {
+      controlIsrReleaseMs = controlIsrNextMs;
+      controlIsrNextMs += CONTROL_PERIOD_MS;
+      ControlTiming_release(DWT_getCycles());
+      TRACE(TRACE_CONTROL_RELEASE, controlIsrReleaseMs);
+      ControlIsr_trigger();
+    }
+#else
+    if (Scheduler_tick() & controlReleaseMask)
+    {
+      ControlTiming_release(DWT_getCycles());
+      TRACE(TRACE_CONTROL_RELEASE, Scheduler_getTime());
+    }
+#endif
+  }
+  // ISR for every mains zero cross
+  else if (htim == &htim1)
+  {
+    fire_next_halfCycle();
   }
 }
 
@@ -640,6 +1979,8 @@ void Error_Handler(void)
 {
   /* USER CODE BEGIN Error_Handler_Debug */
   /* User can add his own implementation to report the HAL error return state */
+  // Heaters off before halting; the watchdog resets the MCU afterwards
+  TIM1->EGR = TIM_EGR_BG;
   __disable_irq();
   while (1)
   {
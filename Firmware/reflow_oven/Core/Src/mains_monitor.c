@@ -0,0 +1,182 @@
+/*
+ * mains_monitor.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the mains frequency monitor.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "mains_monitor.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static uint32_t mains_cpuHz;
+static uint32_t mains_minCycles;
+static uint32_t mains_maxCycles;
+
+/* Block in progress, only touched by the zero-cross interrupt */
+static bool mains_havePrevious;
+static uint32_t mains_previous;
+static uint32_t mains_blockCount;
+static uint32_t mains_blockCycles;
+static uint32_t mains_periodMin;
+static uint32_t mains_periodMax;
+static uint8_t mains_candidateHz;
+static uint8_t mains_candidateBlocks;
+
+/* Published results, read by the main loop */
+static volatile bool mains_present;
+static volatile bool mains_locked;
+static volatile float mains_frequency;
+static volatile float mains_jitterUs;
+static volatile uint8_t mains_nominalHz;
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+static void Mains_restartBlock(void);
+static void Mains_publishBlock(void);
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void Mains_Init(uint32_t cpuHz)
+{
+    mains_cpuHz = cpuHz;
+    mains_minCycles = (uint32_t)((uint64_t)cpuHz * MAINS_MIN_PERIOD_US / 1000000u);
+    mains_maxCycles = (uint32_t)((uint64_t)cpuHz * MAINS_MAX_PERIOD_US / 1000000u);
+
+    mains_havePrevious = false;
+    mains_candidateHz = 0;
+    mains_candidateBlocks = 0;
+    Mains_restartBlock();
+
+    mains_present = false;
+    mains_locked = false;
+    mains_frequency = 0.0f;
+    mains_jitterUs = 0.0f;
+    mains_nominalHz = MAINS_DEFAULT_HZ;
+}
+
+void Mains_onZeroCross(uint32_t cycles)
+{
+    uint32_t period;
+
+    if (!mains_havePrevious) {
+        mains_havePrevious = true;
+        mains_previous = cycles;
+        return;
+    }
+
+    // Unsigned difference stays correct across the counter wrap
+    period = cycles - mains_previous;
+    if (period < mains_minCycles) {
+        return; // Noise: keep the previous timestamp
+    }
+    mains_previous = cycles;
+    if (period > mains_maxCycles) {
+        Mains_restartBlock(); // Missed crossings: the gap says nothing about the line
+        return;
+    }
+
+    mains_present = true;
+    mains_blockCount++;
+    mains_blockCycles += period;
+    if (period < mains_periodMin) {
+        mains_periodMin = period;
+    }
+    if (period > mains_periodMax) {
+        mains_periodMax = period;
+    }
+
+    if (mains_blockCount >= MAINS_BLOCK_HALFCYCLES) {
+        Mains_publishBlock();
+        Mains_restartBlock();
+    }
+}
+
+void Mains_onLoss(void)
+{
+    mains_present = false;
+    mains_havePrevious = false;
+    Mains_restartBlock();
+}
+
+bool Mains_isPresent(void)
+{
+    return mains_present;
+}
+
+bool Mains_isLocked(void)
+{
+    return mains_locked;
+}
+
+float Mains_getFrequency(void)
+{
+    return mains_frequency;
+}
+
+uint8_t Mains_getNominalHz(void)
+{
+    return mains_nominalHz;
+}
+
+uint8_t Mains_getHalfCyclesPerSecond(void)
+{
+    return (uint8_t)(2u * mains_nominalHz);
+}
+
+float Mains_getJitterUs(void)
+{
+    return mains_jitterUs;
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ ******************************************************************************/
+static void Mains_restartBlock(void)
+{
+    mains_blockCount = 0;
+    mains_blockCycles = 0;
+    mains_periodMin = UINT32_MAX;
+    mains_periodMax = 0;
+}
+
+static void Mains_publishBlock(void)
+{
+    float frequency;
+    uint8_t nominal;
+
+    // Two crossings per line period
+    frequency = (float)mains_cpuHz * mains_blockCount / (2.0f * mains_blockCycles);
+    mains_frequency = frequency;
+    mains_jitterUs = (mains_periodMax - mains_periodMin) * (0.5e6f / mains_cpuHz);
+
+    nominal = (frequency < MAINS_SPLIT_HZ) ? 50u : 60u;
+    if (!mains_locked) {
+        // First measurement replaces the default straight away
+        mains_nominalHz = nominal;
+        mains_locked = true;
+        mains_candidateBlocks = 0;
+        return;
+    }
+
+    if (nominal == mains_nominalHz) {
+        mains_candidateBlocks = 0;
+        return;
+    }
+    if (nominal != mains_candidateHz) {
+        mains_candidateHz = nominal;
+        mains_candidateBlocks = 0;
+    }
+    if (++mains_candidateBlocks >= MAINS_CONFIRM_BLOCKS) {
+        mains_nominalHz = nominal;
+        mains_candidateBlocks = 0;
+    }
+}
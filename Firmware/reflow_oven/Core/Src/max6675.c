@@ -10,6 +10,7 @@
  */
 
 #include "max6675.h"
+#include "trace.h"
 
 /**
  * @brief Initialize the MAX6675 driver
@@ -50,6 +51,10 @@ HAL_StatusTypeDef MAX6675_Init(MAX6675_Driver_t *driver, SPI_HandleTypeDef *hspi
 /**
  * @brief Add a new MAX6675 device to the driver
  *
+ * The device is probed by its first read, once a conversion has completed:
+ * reading it right after power-up would abort the first conversion and
+ * hold the boot on four blocking SPI transfers.
+ *
  * @param driver    Pointer to driver control structure
  * @param device_id Device ID (0-3) corresponding to CS pin index
  * @return HAL_StatusTypeDef HAL_OK if successful, HAL_ERROR otherwise
@@ -77,8 +82,7 @@ HAL_StatusTypeDef MAX6675_AddDevice(MAX6675_Driver_t *driver, uint8_t device_id)
     /* Increment device count */
     driver->device_count++;
 
-    /* Validate device communication by reading temperature */
-    return MAX6675_ReadTemperature(driver, device_id);
+    return HAL_OK;
 }
 
 /**
@@ -100,6 +104,8 @@ HAL_StatusTypeDef MAX6675_ReadTemperature(MAX6675_Driver_t *driver, uint8_t devi
         return HAL_ERROR;
     }
 
+    TRACE(TRACE_SENSOR_BEGIN, device_id);
+
     /* Begin SPI communication sequence */
     HAL_GPIO_WritePin(
         driver->cs_ports[device_id],
@@ -119,6 +125,8 @@ HAL_StatusTypeDef MAX6675_ReadTemperature(MAX6675_Driver_t *driver, uint8_t devi
     if (status != HAL_OK)
     {
         driver->devices[device_id].is_connected = 0;
+        TRACE(TRACE_SENSOR_ERROR, (uint32_t)device_id << 16);
+        TRACE(TRACE_SENSOR_END, device_id);
         return status;
     }
 
@@ -149,8 +157,10 @@ HAL_StatusTypeDef MAX6675_ReadTemperature(MAX6675_Driver_t *driver, uint8_t devi
         driver->devices[device_id].temperature = -404.0;
         driver->devices[device_id].is_connected = 0;
         status = HAL_ERROR;
+        TRACE(TRACE_SENSOR_ERROR, ((uint32_t)device_id << 16) | driver->devices[device_id].raw_data);
     }
 
+    TRACE(TRACE_SENSOR_END, device_id);
     return status;
 }
 
@@ -0,0 +1,90 @@
+/*
+ * mem_guard.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the stack canary and RAM high-water marks.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stddef.h>
+#include "mem_guard.h"
+#include "main.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Linker script symbols */
+extern uint32_t _sdata;
+extern uint32_t _ebss;
+extern uint8_t _end;
+extern uint32_t _estack;
+extern uint32_t _Min_Stack_Size;
+
+/* newlib heap (sysmem.c): _sbrk(0) returns the current break */
+void *_sbrk(ptrdiff_t incr);
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/**
+ * @brief Lowest word of the reserved stack, where the canary sits
+ *
+ * @return uint32_t* - _estack - _Min_Stack_Size
+ */
+static uint32_t *MemGuard_stackLimit(void)
+{
+    return (uint32_t *)((uintptr_t)&_estack - (uintptr_t)&_Min_Stack_Size);
+}
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void MemGuard_Init(void)
+{
+    uint32_t *word = MemGuard_stackLimit();
+    uint32_t *top = (uint32_t *)(uintptr_t)((__get_MSP() - MEMGUARD_PAINT_MARGIN) & ~3u);
+    uint8_t i;
+
+    for (i = 0; i < MEMGUARD_CANARY_WORDS; i++) {
+        *word++ = MEMGUARD_CANARY;
+    }
+    while (word < top) {
+        *word++ = MEMGUARD_PAINT;
+    }
+}
+
+bool MemGuard_isIntact(void)
+{
+    const volatile uint32_t *canary = MemGuard_stackLimit();
+    uint8_t i;
+
+    for (i = 0; i < MEMGUARD_CANARY_WORDS; i++) {
+        if (canary[i] != MEMGUARD_CANARY) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MemGuard_getStats(MemGuard_stats_t *stats)
+{
+    const volatile uint32_t *word = MemGuard_stackLimit() + MEMGUARD_CANARY_WORDS;
+    const uint32_t *top = &_estack;
+    uint8_t *heapEnd = _sbrk(0);
+
+    stats->staticBytes = (uint32_t)((uintptr_t)&_ebss - (uintptr_t)&_sdata);
+    stats->heapBytes = (uint32_t)(heapEnd - &_end);
+    stats->stackReserve = (uint32_t)(uintptr_t)&_Min_Stack_Size;
+    stats->freeBytes = (uint32_t)((uintptr_t)MemGuard_stackLimit() - (uintptr_t)heapEnd);
+    stats->intact = MemGuard_isIntact();
+
+    // The paint ends at the deepest frame so far; a broken canary means deeper than the reserve
+    while (word < top && *word == MEMGUARD_PAINT) {
+        word++;
+    }
+    stats->stackPeakBytes = stats->intact ? (uint32_t)((uintptr_t)top - (uintptr_t)word) : stats->stackReserve;
+}
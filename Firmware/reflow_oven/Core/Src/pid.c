@@ -18,6 +18,7 @@
  ***************************************************************************************/
 
 // Include the header file for the PID implementation
+#include <stdbool.h>
 #include "pid.h"
 
 // Function to initialize the PID controller
@@ -72,8 +73,8 @@ void PID_Reset(PIDController *pid)
     pid->out = 0.0f;             // Reset output
 }
 
-// Function that updates the PID controller each time it is called
-float PID_Update(PIDController *pid, float setpoint, float measurement)
+// One controller step; with holdIntegrator the integrator keeps its value and only P and D react
+static float PID_Step(PIDController *pid, float setpoint, float measurement, bool holdIntegrator)
 {
     // Calculate error (difference between setpoint and measurement)
     float error = setpoint - measurement;
@@ -81,17 +82,20 @@ float PID_Update(PIDController *pid, float setpoint, float measurement)
     // Calculate proportional term (Kp * error)
     float proportional = pid->Kp * error;
 
-    // Calculate integral term (integration of error)
-    pid->integrator += 0.5f * pid->Ki * pid->T * (error + pid->prevError); // Trapezoidal integration method (average sum of errors)
-
-    // Anti-windup: Limit the integrator value to prevent excessive error accumulation
-    if (pid->integrator > pid->limMaxInt)
+    if (!holdIntegrator)
     {
-        pid->integrator = pid->limMaxInt; // Limit integrator to maximum allowed value
-    }
-    else if (pid->integrator < pid->limMinInt)
-    {
-        pid->integrator = pid->limMinInt; // Limit integrator to minimum allowed value
+        // Calculate integral term (integration of error)
+        pid->integrator += 0.5f * pid->Ki * pid->T * (error + pid->prevError); // Trapezoidal integration method (average sum of errors)
+
+        // Anti-windup: Limit the integrator value to prevent excessive error accumulation
+        if (pid->integrator > pid->limMaxInt)
+        {
+            pid->integrator = pid->limMaxInt; // Limit integrator to maximum allowed value
+        }
+        else if (pid->integrator < pid->limMinInt)
+        {
+            pid->integrator = pid->limMinInt; // Limit integrator to minimum allowed value
+        }
     }
 
     // Calculate derivative term (with low-pass filter to avoid noise)
@@ -120,6 +124,18 @@ float PID_Update(PIDController *pid, float setpoint, float measurement)
     return pid->out;
 }
 
+// Function that updates the PID controller each time it is called
+float PID_Update(PIDController *pid, float setpoint, float measurement)
+{
+    return PID_Step(pid, setpoint, measurement, false);
+}
+
+// Function that updates the PID controller with the integrator frozen
+float PID_UpdateHoldIntegrator(PIDController *pid, float setpoint, float measurement)
+{
+    return PID_Step(pid, setpoint, measurement, true);
+}
+
 // Function to update Kp, Ki, and Kd gains at runtime
 void PID_UpdateGains(PIDController *pid, float kp, float ki, float kd)
 {
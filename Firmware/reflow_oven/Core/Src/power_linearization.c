@@ -0,0 +1,322 @@
+/*
+ * power_linearization.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the heater power linearization table and
+ *              its calibration run.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stddef.h>
+#include "main.h"
+#include "power_linearization.h"
+
+/* Word of erased flash */
+#define PWRLIN_FLASH_ERASED    0xFFFFFFFFu
+
+/**
+ * @brief Table slot in flash
+ */
+typedef struct {
+    uint32_t magic;              /* PWRLIN_FLASH_MAGIC, erased while the slot is blank */
+    float table[PWRLIN_POINTS];  /* Duty (%) for requests 0, PWRLIN_STEP, ... 100 % */
+    uint32_t crc;                /* CRC-32 of the words above */
+} PowerLin_record_t;
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+/* Duty (%) for requested power 0, PWRLIN_STEP, ... 100 % */
+static float powerLin_table[PWRLIN_POINTS];
+static bool powerLin_calibrated;               /* Table comes from a calibration, not the identity */
+static bool powerLin_stored;                   /* Table in use is in flash */
+
+/* Calibration run */
+static PowerLin_calState_t powerLin_calState;
+static float powerLin_ambient;                 /* Temperature at start (°C) */
+static float powerLin_rise[PWRLIN_POINTS];     /* Steady-state rise per duty step (°C) */
+static uint8_t powerLin_stepIndex;             /* Step being held, duty = index * PWRLIN_STEP */
+static uint32_t powerLin_stepStartTime;        /* Start of the current step (ms) */
+static uint32_t powerLin_windowStartTime;      /* Start of the current settling window (ms) */
+static float powerLin_windowStartTemp;         /* Temperature at the start of the window (°C) */
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+static void PowerLin_beginStep(uint8_t step, uint32_t currentTimeMs, float temperature);
+static void PowerLin_finishCalibration(uint8_t measuredSteps);
+static const PowerLin_record_t *PowerLin_slots(void);
+static uint32_t PowerLin_crc(const PowerLin_record_t *record);
+static bool PowerLin_load(void);
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void PowerLin_Init(void)
+{
+    uint8_t i;
+
+    powerLin_calState = PWRLIN_CAL_IDLE;
+    powerLin_calibrated = PowerLin_load();
+    powerLin_stored = true;
+    if (powerLin_calibrated) {
+        return;
+    }
+    for (i = 0; i < PWRLIN_POINTS; i++) {
+        powerLin_table[i] = i * PWRLIN_STEP;
+    }
+}
+
+float PowerLin_apply(float requested)
+{
+    float position;
+    uint8_t index;
+
+    if (requested <= 0.0f) {
+        return 0.0f;
+    }
+    if (requested >= 100.0f) {
+        return powerLin_table[PWRLIN_POINTS - 1];
+    }
+
+    // Evenly spaced request axis: direct index, then interpolate
+    position = requested * (1.0f / PWRLIN_STEP);
+    index = (uint8_t)position;
+    return powerLin_table[index] + (position - index) * (powerLin_table[index + 1] - powerLin_table[index]);
+}
+
+const float *PowerLin_getTable(void)
+{
+    return powerLin_table;
+}
+
+void PowerLin_setTable(const float *table)
+{
+    uint8_t i;
+
+    for (i = 0; i < PWRLIN_POINTS; i++) {
+        powerLin_table[i] = table[i];
+    }
+}
+
+bool PowerLin_store(void)
+{
+    const PowerLin_record_t *slot = PowerLin_slots();
+    PowerLin_record_t record;
+    const uint32_t *word = (const uint32_t *)&record;
+    uint32_t address, i;
+    uint8_t index;
+
+    if (!powerLin_calibrated) {
+        return true;
+    }
+
+    // Slots fill up in order: the first blank one follows the last save
+    for (index = 0; index < PWRLIN_FLASH_SLOTS && slot[index].magic != PWRLIN_FLASH_ERASED; index++) {
+    }
+    if (index == PWRLIN_FLASH_SLOTS) {
+        powerLin_stored = false; // Kept in RAM until the recorder erases the sector again
+        return false;
+    }
+
+    record.magic = PWRLIN_FLASH_MAGIC;
+    for (i = 0; i < PWRLIN_POINTS; i++) {
+        record.table[i] = powerLin_table[i];
+    }
+    record.crc = PowerLin_crc(&record);
+
+    powerLin_stored = true;
+    address = (uint32_t)(uintptr_t)&slot[index];
+    HAL_FLASH_Unlock();
+    for (i = 0; i < sizeof(record) / 4; i++, address += 4) {
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, word[i]) != HAL_OK) {
+            powerLin_stored = false;
+            break;
+        }
+    }
+    HAL_FLASH_Lock();
+    return powerLin_stored;
+}
+
+bool PowerLin_isStored(void)
+{
+    return powerLin_stored;
+}
+
+bool PowerLin_startCalibration(uint32_t currentTimeMs, float temperature)
+{
+    if (powerLin_calState == PWRLIN_CAL_RUNNING || temperature > PWRLIN_MAX_START_TEMP) {
+        return false;
+    }
+
+    powerLin_ambient = temperature;
+    powerLin_rise[0] = 0.0f;
+    powerLin_calState = PWRLIN_CAL_RUNNING;
+    PowerLin_beginStep(1, currentTimeMs, temperature);
+    return true;
+}
+
+void PowerLin_abortCalibration(void)
+{
+    if (powerLin_calState == PWRLIN_CAL_RUNNING) {
+        powerLin_calState = PWRLIN_CAL_FAILED;
+    }
+}
+
+float PowerLin_calibrationUpdate(uint32_t currentTimeMs, float temperature)
+{
+    bool settled = false;
+
+    if (powerLin_calState != PWRLIN_CAL_RUNNING) {
+        return 0.0f;
+    }
+
+    // Too hot to go on: the steps measured so far make the table
+    if (temperature >= PWRLIN_MAX_TEMP) {
+        PowerLin_finishCalibration(powerLin_stepIndex - 1);
+        return 0.0f;
+    }
+
+    if (currentTimeMs - powerLin_windowStartTime >= PWRLIN_SETTLE_WINDOW_MS) {
+        float drift = temperature - powerLin_windowStartTemp;
+        settled = (drift < PWRLIN_SETTLE_DELTA && drift > -PWRLIN_SETTLE_DELTA);
+        powerLin_windowStartTime = currentTimeMs;
+        powerLin_windowStartTemp = temperature;
+    }
+    if (!settled && currentTimeMs - powerLin_stepStartTime < PWRLIN_STEP_TIMEOUT_MS) {
+        return powerLin_stepIndex * PWRLIN_STEP;
+    }
+
+    powerLin_rise[powerLin_stepIndex] = temperature - powerLin_ambient;
+    if (powerLin_stepIndex == PWRLIN_POINTS - 1) {
+        PowerLin_finishCalibration(powerLin_stepIndex);
+        return 0.0f;
+    }
+    PowerLin_beginStep(powerLin_stepIndex + 1, currentTimeMs, temperature);
+    return powerLin_stepIndex * PWRLIN_STEP;
+}
+
+PowerLin_calState_t PowerLin_getCalibrationState(void)
+{
+    return powerLin_calState;
+}
+
+bool PowerLin_isCalibrating(void)
+{
+    return powerLin_calState == PWRLIN_CAL_RUNNING;
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ ******************************************************************************/
+static void PowerLin_beginStep(uint8_t step, uint32_t currentTimeMs, float temperature)
+{
+    powerLin_stepIndex = step;
+    powerLin_stepStartTime = currentTimeMs;
+    powerLin_windowStartTime = currentTimeMs;
+    powerLin_windowStartTemp = temperature;
+}
+
+static void PowerLin_finishCalibration(uint8_t measuredSteps)
+{
+    float power[PWRLIN_POINTS];
+    float topDuty;
+    uint8_t i, k;
+
+    if (measuredSteps < 1 || powerLin_rise[1] < PWRLIN_MIN_RISE) {
+        powerLin_calState = PWRLIN_CAL_FAILED;
+        return;
+    }
+
+    // Delivered power of each step relative to the top step, forced strictly increasing
+    topDuty = measuredSteps * PWRLIN_STEP;
+    for (k = 1; k <= measuredSteps; k++) {
+        if (powerLin_rise[k] <= powerLin_rise[k - 1]) {
+            powerLin_rise[k] = powerLin_rise[k - 1] + 0.01f;
+        }
+    }
+    for (k = 0; k <= measuredSteps; k++) {
+        power[k] = powerLin_rise[k] / powerLin_rise[measuredSteps] * topDuty;
+    }
+
+    // Invert onto the request axis; above the measured range the curve continues at slope 1
+    k = 0;
+    for (i = 0; i < PWRLIN_POINTS; i++) {
+        float requested = i * PWRLIN_STEP;
+        float duty;
+
+        if (requested >= power[measuredSteps]) {
+            duty = topDuty + (requested - power[measuredSteps]);
+        } else {
+            while (power[k + 1] < requested) {
+                k++;
+            }
+            duty = (k + (requested - power[k]) / (power[k + 1] - power[k])) * PWRLIN_STEP;
+        }
+        powerLin_table[i] = (duty > 100.0f) ? 100.0f : duty;
+    }
+    powerLin_calState = PWRLIN_CAL_DONE;
+    powerLin_calibrated = true;
+    PowerLin_store();
+}
+
+/**
+ * @brief Table slots at the end of the recorder sector
+ *
+ * @return const PowerLin_record_t* - PWRLIN_FLASH_SLOTS slots
+ */
+static const PowerLin_record_t *PowerLin_slots(void)
+{
+    extern uint8_t _srunlog[]; /* Symbol defined in the linker script */
+
+    return (const PowerLin_record_t *)(_srunlog + PWRLIN_FLASH_OFFSET);
+}
+
+/**
+ * @brief CRC-32 (IEEE, reflected) of a slot, its crc word excluded
+ *
+ * @param record Table slot
+ * @return uint32_t - CRC
+ */
+static uint32_t PowerLin_crc(const PowerLin_record_t *record)
+{
+    const uint8_t *byte = (const uint8_t *)record;
+    uint32_t crc = 0xFFFFFFFFu;
+    uint32_t i;
+    uint8_t bit;
+
+    for (i = 0; i < offsetof(PowerLin_record_t, crc); i++) {
+        crc ^= byte[i];
+        for (bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Load the last valid table saved in flash
+ *
+ * @return bool - False when no slot holds a valid table
+ */
+static bool PowerLin_load(void)
+{
+    const PowerLin_record_t *slot = PowerLin_slots();
+    const PowerLin_record_t *last = NULL;
+    uint8_t index;
+
+    for (index = 0; index < PWRLIN_FLASH_SLOTS && slot[index].magic != PWRLIN_FLASH_ERASED; index++) {
+        if (slot[index].magic == PWRLIN_FLASH_MAGIC && slot[index].crc == PowerLin_crc(&slot[index])) {
+            last = &slot[index];
+        }
+    }
+    if (last == NULL) {
+        return false;
+    }
+    PowerLin_setTable(last->table);
+    return true;
+}
@@ -0,0 +1,105 @@
+/*
+ * profiler.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the DWT stage profiler. Compiled empty
+ *              when PROF_ENABLE is 0.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stddef.h>
+#include "profiler.h"
+
+#if PROF_ENABLE
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static Profiler_stats_t profiler_stats[PROF_NUM_POINTS];
+
+static const char *const profiler_names[PROF_NUM_POINTS] = {
+    [PROF_SENSE] = "sense",
+    [PROF_OPERATE] = "operate",
+    [PROF_ACTUATOR] = "actuator",
+    [PROF_GUI_MAIN] = "gui_main",
+    [PROF_GUI_OVEN] = "gui_oven",
+    [PROF_GUI_PID] = "gui_pid",
+    [PROF_GUI_DIAG] = "gui_diag",
+};
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+static uint8_t Profiler_bucket(uint32_t cycles);
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void Profiler_reset(void)
+{
+    uint8_t point;
+
+    for (point = 0; point < PROF_NUM_POINTS; point++) {
+        profiler_stats[point] = (Profiler_stats_t){0};
+    }
+}
+
+void Profiler_record(Profiler_point_t point, uint32_t cycles)
+{
+    Profiler_stats_t *stats;
+
+    if (point >= PROF_NUM_POINTS) {
+        return;
+    }
+    stats = &profiler_stats[point];
+
+    if (stats->count == 0 || cycles < stats->minCycles) {
+        stats->minCycles = cycles;
+    }
+    if (cycles > stats->maxCycles) {
+        stats->maxCycles = cycles;
+    }
+    stats->count++;
+    stats->totalCycles += cycles;
+    stats->histogram[Profiler_bucket(cycles)]++;
+}
+
+const Profiler_stats_t *Profiler_getStats(Profiler_point_t point)
+{
+    return (point < PROF_NUM_POINTS) ? &profiler_stats[point] : NULL;
+}
+
+const char *Profiler_getName(Profiler_point_t point)
+{
+    return (point < PROF_NUM_POINTS) ? profiler_names[point] : "?";
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ ******************************************************************************/
+/**
+ * @brief Histogram bucket of a duration
+ *
+ * @param cycles Duration (cycles)
+ * @return uint8_t - Bucket index
+ */
+static uint8_t Profiler_bucket(uint32_t cycles)
+{
+    uint32_t log2;
+
+    if (cycles < (1u << PROF_BUCKET_BASE)) {
+        return 0;
+    }
+    // Index of the highest set bit, one CLZ instruction on the M4
+    log2 = 31u - (uint32_t)__builtin_clz(cycles);
+    if (log2 - PROF_BUCKET_BASE + 1u >= PROF_NUM_BUCKETS) {
+        return PROF_NUM_BUCKETS - 1u;
+    }
+    return (uint8_t)(log2 - PROF_BUCKET_BASE + 1u);
+}
+
+#endif /* PROF_ENABLE */
@@ -11,7 +11,11 @@
 /******************************************************************************
  * INCLUDES
  ******************************************************************************/
+#include "chamber_model.h"
 #include "reflow_oven_process.h"
+#include "thermal_mass.h"
+#include "trace.h"
+#include "transient_detector.h"
 
 // Maximum safe temperature (°C) - emergency stop if exceeded
 #define MAX_SAFE_TEMPERATURE   250.0f
@@ -22,6 +26,17 @@
 // Milliseconds to seconds conversion
 #define MS_TO_S                0.001f
 
+// Temperature the reference profile starts from (°C)
+#define AMBIENT_TEMPERATURE    25.0f
+
+// Longest soak the paste allows (s), also the limit of a heavy load's soak extension
+#define MAX_SOAK_TIME          180.0f
+
+// Load scaling limits: controller gain scale and soak extension for the identified mass
+#define MIN_LOAD_GAIN_SCALE    0.75f
+#define MAX_LOAD_GAIN_SCALE    2.0f
+#define MAX_LOAD_SOAK_SCALE    2.0f
+
 // SYSTEM DEFINITIONS
 ReflowOven_t ReflowOven;
 
@@ -30,6 +45,9 @@ ReflowOven_t ReflowOven;
  ******************************************************************************/
 static void ReflowOven_transitionToPhase(ReflowPhases_t newPhase, float currentTemperature, uint32_t currentTimeMs);
 static float ReflowOven_calculateSetpoint(float currentTemperature, uint32_t elapsedTimeMs);
+static void ReflowOven_applyThermalMass(void);
+static float ReflowOven_feedforward(float rampRate);
+static void ReflowOven_updateController(PIDController *PID, float currentTemperature);
 
 /******************************************************************************
  * FUNCTION DEFINITIONS
@@ -58,22 +76,40 @@ void ReflowOven_Init(void)
     ReflowOven.ReflowParameters.ReflowTime = 30.0f;           // seconds
     ReflowOven.ReflowParameters.CoolDownRate = 1.0f;          // °C/s
     ReflowOven.ReflowParameters.CoolDownTempeture = 50.0f;    // °C
+    ReflowOven.ReflowParameters.StandbyTempeture = 0.0f;      // °C, standby off
+
+    // Zone balance: every zone at full power except a bottom-heavy soak
+    // (zone 0 is the bottom element) to bring the board up from below
+    for (uint8_t phase = 0; phase < REFLOW_IDLE; phase++) {
+        for (uint8_t zone = 0; zone < REFLOW_MAX_ZONES; zone++) {
+            ReflowOven.ReflowParameters.ZoneBalance[phase][zone] = 1.0f;
+        }
+    }
+    ReflowOven.ReflowParameters.ZoneBalance[REFLOW_SOAK][1] = 0.7f;
 
     // Set the initial phase to idle and initialize other control variables
     ReflowOven.currentPhase = REFLOW_IDLE;
     ReflowOven.NextPhase = REFLOW_IDLE;
     ReflowOven.phaseStartTime = 0;
-    ReflowOven.currentSetpoint = 25.0f;  // Room temperature default
+    ReflowOven.currentSetpoint = AMBIENT_TEMPERATURE;  // Room temperature default
     ReflowOven.emergencyStop = false;
-    ReflowOven.temperatureAtPhaseStart = 25.0f;
+    ReflowOven.temperatureAtPhaseStart = AMBIENT_TEMPERATURE;
+    ReflowOven.entryOffsetMs = 0;
+    ReflowOven.lastOperateTime = 0;
+    ReflowOven.gainScale = 1.0f;
+    ReflowOven.feedforward = 0.0f;
+    ReflowOven.soakTimeMs = (uint32_t)(ReflowOven.ReflowParameters.SoakTime * 1000);
+    ChamberModel_Init();
+    Transient_Init();
+    ThermalMass_Init();
 }
 
 bool ReflowOven_modifyParameters(ReflowParameters_enum parameterUpdate, float newParameterValue)
 {
     bool success = true;
 
-    // Only allow parameter modification when in IDLE state
-    if (ReflowOven.currentPhase != REFLOW_IDLE) {
+    // Only allow parameter modification between runs (IDLE or STANDBY)
+    if (ReflowOven.currentPhase < REFLOW_IDLE) {
         return false;
     }
 
@@ -96,7 +132,7 @@ bool ReflowOven_modifyParameters(ReflowParameters_enum parameterUpdate, float ne
             break;
 
         case PARAM_SoakTime:
-            if (newParameterValue >= 30.0f && newParameterValue <= 180.0f) {
+            if (newParameterValue >= 30.0f && newParameterValue <= MAX_SOAK_TIME) {
                 ReflowOven.ReflowParameters.SoakTime = newParameterValue;
             } else {
                 success = false;
@@ -143,6 +179,17 @@ bool ReflowOven_modifyParameters(ReflowParameters_enum parameterUpdate, float ne
             }
             break;
 
+        case PARAM_StandbyTempeture:
+            // Keep the hold well below soak so preheat always has a ramp to follow
+            if (newParameterValue == 0.0f ||
+                (newParameterValue >= 40.0f && newParameterValue <= 120.0f &&
+                 newParameterValue < ReflowOven.ReflowParameters.SoakTempeture)) {
+                ReflowOven.ReflowParameters.StandbyTempeture = newParameterValue;
+            } else {
+                success = false;
+            }
+            break;
+
         default:
             success = false;
             break;
@@ -151,10 +198,36 @@ bool ReflowOven_modifyParameters(ReflowParameters_enum parameterUpdate, float ne
     return success;
 }
 
+bool ReflowOven_setZoneBalance(ReflowPhases_t phase, uint8_t zone, float share)
+{
+    // Only allow profile modification between runs (IDLE or STANDBY)
+    if (ReflowOven.currentPhase < REFLOW_IDLE) {
+        return false;
+    }
+
+    if (phase >= REFLOW_IDLE || zone >= REFLOW_MAX_ZONES || share < 0.0f || share > 1.0f) {
+        return false;
+    }
+
+    ReflowOven.ReflowParameters.ZoneBalance[phase][zone] = share;
+    return true;
+}
+
+bool ReflowOven_loadProfile(const ReflowOven_parameters_t *profile)
+{
+    // Only allow profile modification between runs (IDLE or STANDBY)
+    if (ReflowOven.currentPhase < REFLOW_IDLE) {
+        return false;
+    }
+
+    ReflowOven.ReflowParameters = *profile;
+    return true;
+}
+
 bool ReflowOven_startProcess(void)
 {
-    // Only allow starting from IDLE state
-    if (ReflowOven.currentPhase != REFLOW_IDLE) {
+    // Only allow starting from IDLE or STANDBY state
+    if (ReflowOven.currentPhase < REFLOW_IDLE) {
         return false;
     }
 
@@ -166,11 +239,24 @@ bool ReflowOven_startProcess(void)
 void ReflowOven_stopProcess(void)
 {
     // Force transition to cooldown regardless of current state
-    if (ReflowOven.currentPhase != REFLOW_IDLE) {
+    if (ReflowOven.currentPhase < REFLOW_IDLE) {
         ReflowOven.NextPhase = REFLOW_COOLDOWN;
+    } else {
+        // Stopping from standby switches the warm hold off
+        ReflowOven.NextPhase = REFLOW_IDLE;
     }
 }
 
+void ReflowOven_emergencyStop(void)
+{
+    // Already idle: nothing to stop, and the flag would leak into the next run
+    if (ReflowOven.currentPhase == REFLOW_IDLE) {
+        return;
+    }
+    ReflowOven.emergencyStop = true;
+    ReflowOven.NextPhase = REFLOW_IDLE;
+}
+
 void ReflowOven_operate(PIDController *PID, float currentTemperature, uint32_t currentTimeMs)
 {
     uint32_t elapsedTimeMs;
@@ -187,17 +273,30 @@ void ReflowOven_operate(PIDController *PID, float currentTemperature, uint32_t c
         ReflowOven_transitionToPhase(ReflowOven.NextPhase, currentTemperature, currentTimeMs);
     }
 
+    // Door open: the profile clock stands still, so the phase times stay those of the profile
+    if (Transient_update(ReflowOven.currentPhase, currentTemperature, PID->out, currentTimeMs) == TRANSIENT_DOOR_OPEN) {
+        ReflowOven.phaseStartTime += currentTimeMs - ReflowOven.lastOperateTime;
+        ThermalMass_abort(); // The step response would measure the door, not the load
+    }
+    ReflowOven.lastOperateTime = currentTimeMs;
+
     // Calculate elapsed time in current phase
     elapsedTimeMs = currentTimeMs - ReflowOven.phaseStartTime;
 
-    // Safety timeout - prevent getting stuck in any phase
-    if ((elapsedTimeMs > (MAX_PHASE_DURATION * 1000)) && (ReflowOven.currentPhase != REFLOW_IDLE)) {
+    // Safety timeout - prevent getting stuck in any phase (standby holds indefinitely)
+    if ((elapsedTimeMs > (MAX_PHASE_DURATION * 1000)) && (ReflowOven.currentPhase < REFLOW_IDLE)) {
         ReflowOven.NextPhase = REFLOW_COOLDOWN;
     }
 
     // Process current phase
     switch (ReflowOven.currentPhase) {
         case REFLOW_PREHEAT:
+            // Identification window at the start of preheat, then scale the run for the load
+            if (ThermalMass_isIdentifying() &&
+                ThermalMass_update(currentTemperature, currentTimeMs) != THERMALMASS_IDENTIFYING) {
+                ReflowOven_applyThermalMass();
+            }
+
             // Calculate target temperature based on ramp rate
             targetSetpoint = ReflowOven.temperatureAtPhaseStart +
                              (ReflowOven.ReflowParameters.Pre_HeatUpRate * elapsedTimeMs * MS_TO_S);
@@ -209,6 +308,8 @@ void ReflowOven_operate(PIDController *PID, float currentTemperature, uint32_t c
 
             // Update PID setpoint
             ReflowOven.currentSetpoint = targetSetpoint;
+            ReflowOven.feedforward = ReflowOven_feedforward(
+                (targetSetpoint < ReflowOven.ReflowParameters.SoakTempeture) ? ReflowOven.ReflowParameters.Pre_HeatUpRate : 0.0f);
 
             // Check if preheat phase is complete
             if (currentTemperature >= ReflowOven.ReflowParameters.SoakTempeture) {
@@ -219,9 +320,10 @@ void ReflowOven_operate(PIDController *PID, float currentTemperature, uint32_t c
         case REFLOW_SOAK:
             // Maintain constant soak temperature
             ReflowOven.currentSetpoint = ReflowOven.ReflowParameters.SoakTempeture;
+            ReflowOven.feedforward = ReflowOven_feedforward(0.0f);
 
-            // Check if soak time has elapsed
-            if (elapsedTimeMs >= (uint32_t)(ReflowOven.ReflowParameters.SoakTime * 1000)) {
+            // Check if soak time (extended for a heavy load) has elapsed
+            if (elapsedTimeMs >= ReflowOven.soakTimeMs) {
                 ReflowOven.NextPhase = REFLOW_HEATUP;
             }
             break;
@@ -238,6 +340,8 @@ void ReflowOven_operate(PIDController *PID, float currentTemperature, uint32_t c
 
             // Update PID setpoint
             ReflowOven.currentSetpoint = targetSetpoint;
+            ReflowOven.feedforward = ReflowOven_feedforward(
+                (targetSetpoint < ReflowOven.ReflowParameters.ReflowTempeture) ? ReflowOven.ReflowParameters.HeatUpRate : 0.0f);
 
             // Check if heat-up phase is complete
             if (currentTemperature >= ReflowOven.ReflowParameters.ReflowTempeture) {
@@ -248,6 +352,7 @@ void ReflowOven_operate(PIDController *PID, float currentTemperature, uint32_t c
         case REFLOW_REFLOW:
             // Maintain constant reflow temperature
             ReflowOven.currentSetpoint = ReflowOven.ReflowParameters.ReflowTempeture;
+            ReflowOven.feedforward = ReflowOven_feedforward(0.0f);
 
             // Check if reflow time has elapsed
             if (elapsedTimeMs >= (uint32_t)(ReflowOven.ReflowParameters.ReflowTime * 1000)) {
@@ -267,16 +372,24 @@ void ReflowOven_operate(PIDController *PID, float currentTemperature, uint32_t c
 
             // Update PID setpoint
             ReflowOven.currentSetpoint = targetSetpoint;
+            ReflowOven.feedforward = 0.0f;
 
-            // Check if cooldown is complete
+            // Check if cooldown is complete: hold warm for the next board if standby is on
             if (currentTemperature <= ReflowOven.ReflowParameters.CoolDownTempeture) {
-                ReflowOven.NextPhase = REFLOW_IDLE;
+                ReflowOven.NextPhase = (ReflowOven.ReflowParameters.StandbyTempeture > 0.0f)
+                                           ? REFLOW_STANDBY
+                                           : REFLOW_IDLE;
             }
             break;
 
         case REFLOW_IDLE:
             // In idle state, maintain a safe room temperature
-            ReflowOven.currentSetpoint = 25.0f;
+            ReflowOven.currentSetpoint = AMBIENT_TEMPERATURE;
+            break;
+
+        case REFLOW_STANDBY:
+            // Hold the warm temperature until the next start
+            ReflowOven.currentSetpoint = ReflowOven.ReflowParameters.StandbyTempeture;
             break;
 
         default:
@@ -286,7 +399,7 @@ void ReflowOven_operate(PIDController *PID, float currentTemperature, uint32_t c
     }
 
     // Update PID controller with current setpoint
-    PID_Update(PID, ReflowOven.currentSetpoint, currentTemperature);
+    ReflowOven_updateController(PID, currentTemperature);
 }
 
 ReflowPhases_t ReflowOven_getCurrentPhase(void)
@@ -299,6 +412,22 @@ uint32_t ReflowOven_getPhaseElapsedTime(uint32_t currentTimeMs)
     return (currentTimeMs - ReflowOven.phaseStartTime) / 1000; // Return in seconds
 }
 
+uint32_t ReflowOven_getEntryOffset(float startTemperature)
+{
+    float offsetS;
+
+    if (startTemperature <= AMBIENT_TEMPERATURE) {
+        return 0;
+    }
+
+    // Cap at the soak point: above it the ramp has nothing left to follow
+    if (startTemperature > ReflowOven.ReflowParameters.SoakTempeture) {
+        startTemperature = ReflowOven.ReflowParameters.SoakTempeture;
+    }
+    offsetS = (startTemperature - AMBIENT_TEMPERATURE) / ReflowOven.ReflowParameters.Pre_HeatUpRate;
+    return (uint32_t)(offsetS * 1000.0f);
+}
+
 /******************************************************************************
  * PRIVATE FUNCTION IMPLEMENTATIONS
  ******************************************************************************/
@@ -315,12 +444,35 @@ static void ReflowOven_transitionToPhase(ReflowPhases_t newPhase, float currentT
     // Record current state before transition
     ReflowOven.temperatureAtPhaseStart = currentTemperature;
     ReflowOven.phaseStartTime = currentTimeMs;
+    ReflowOven.entryOffsetMs = 0;
+
+    // A warm preheat joins the reference ramp (from ambient) where it crosses
+    // the current temperature, so elapsed time is profile time
+    if (newPhase == REFLOW_PREHEAT && currentTemperature > AMBIENT_TEMPERATURE) {
+        ReflowOven.entryOffsetMs = ReflowOven_getEntryOffset(currentTemperature);
+        ReflowOven.temperatureAtPhaseStart = AMBIENT_TEMPERATURE;
+        ReflowOven.phaseStartTime = currentTimeMs - ReflowOven.entryOffsetMs;
+    }
 
     // Update phase
+    TRACE(TRACE_PHASE, ((uint32_t)ReflowOven.currentPhase << 8) | newPhase);
     ReflowOven.currentPhase = newPhase;
 
+    // Every preheat identifies the load afresh; until then the run is scaled for the reference load
+    ReflowOven.feedforward = 0.0f;
+    if (newPhase == REFLOW_PREHEAT) {
+        ReflowOven.gainScale = 1.0f;
+        ReflowOven.soakTimeMs = (uint32_t)(ReflowOven.ReflowParameters.SoakTime * 1000);
+        ThermalMass_start(currentTimeMs);
+    } else {
+        ThermalMass_abort();
+    }
+    if (newPhase == REFLOW_IDLE || newPhase == REFLOW_STANDBY) {
+        ReflowOven.gainScale = 1.0f;
+    }
+
     // Reset PID controller when entering new phase to prevent integral windup
-    if (newPhase == REFLOW_IDLE || newPhase == REFLOW_PREHEAT) {
+    if (newPhase == REFLOW_IDLE || newPhase == REFLOW_PREHEAT || newPhase == REFLOW_STANDBY) {
         PID_Reset(&PID);
     }
 
@@ -347,13 +499,112 @@ static void ReflowOven_transitionToPhase(ReflowPhases_t newPhase, float currentT
             break;
 
         case REFLOW_IDLE:
-            ReflowOven.currentSetpoint = 25.0f; // Room temperature
-            ReflowOven.emergencyStop = false;   // Clear emergency flag
+            ReflowOven.currentSetpoint = AMBIENT_TEMPERATURE; // Room temperature
+            ReflowOven.emergencyStop = false;                 // Clear emergency flag
+            break;
+
+        case REFLOW_STANDBY:
+            ReflowOven.currentSetpoint = ReflowOven.ReflowParameters.StandbyTempeture;
             break;
 
         default:
             // Failsafe default
-            ReflowOven.currentSetpoint = 25.0f;
+            ReflowOven.currentSetpoint = AMBIENT_TEMPERATURE;
             break;
     }
 }
+
+/**
+ * @brief Scale the rest of the run for the identified thermal mass
+ *
+ * A heavier load has a proportionally smaller plant gain, so the controller
+ * gains grow with the mass ratio; the soak only ever gets longer (the paste
+ * needs its minimum activation time) and never beyond MAX_SOAK_TIME.
+ */
+static void ReflowOven_applyThermalMass(void)
+{
+    float ratio = ThermalMass_getRatio();
+    float soakScale = ratio;
+    float soakTime;
+
+    ReflowOven.gainScale = ratio;
+    if (ReflowOven.gainScale < MIN_LOAD_GAIN_SCALE) {
+        ReflowOven.gainScale = MIN_LOAD_GAIN_SCALE;
+    } else if (ReflowOven.gainScale > MAX_LOAD_GAIN_SCALE) {
+        ReflowOven.gainScale = MAX_LOAD_GAIN_SCALE;
+    }
+
+    if (soakScale < 1.0f) {
+        soakScale = 1.0f;
+    } else if (soakScale > MAX_LOAD_SOAK_SCALE) {
+        soakScale = MAX_LOAD_SOAK_SCALE;
+    }
+    soakTime = ReflowOven.ReflowParameters.SoakTime * soakScale;
+    if (soakTime > MAX_SOAK_TIME) {
+        soakTime = MAX_SOAK_TIME;
+    }
+    ReflowOven.soakTimeMs = (uint32_t)(soakTime * 1000);
+}
+
+/**
+ * @brief Power the chamber model needs to follow the setpoint
+ *
+ * Inverts the chamber model (see chamber_model.h) for the ramp rate plus
+ * the losses at the setpoint. Zero while no identification succeeded in this
+ * run: the reference gain may be far off and the PID would have to fight it.
+ *
+ * @param rampRate Setpoint slope (°C/s), 0 on a hold
+ * @return float - Feedforward power (%)
+ */
+static float ReflowOven_feedforward(float rampRate)
+{
+    float losses = ChamberModel_losses(ReflowOven.currentSetpoint);
+    float power;
+
+    if (ThermalMass_getState() != THERMALMASS_DONE) {
+        return 0.0f;
+    }
+    if (losses < 0.0f) {
+        losses = 0.0f;
+    }
+    power = (rampRate + losses) * 100.0f / ChamberModel_getGain();
+    return (power > 100.0f) ? 100.0f : power;
+}
+
+/**
+ * @brief Run the master PID for this cycle
+ *
+ * Open loop at the identification step while the load is measured. Otherwise
+ * the PID runs with its gains scaled for the load (the GUI keeps the nominal
+ * ones), holds its integrator while the door is open and gets the model
+ * feedforward added to its output.
+ *
+ * @param PID Pointer to PID controller instance
+ * @param currentTemperature Current measured temperature in degrees Celsius
+ */
+static void ReflowOven_updateController(PIDController *PID, float currentTemperature)
+{
+    PIDGains gains;
+
+    if (ThermalMass_isIdentifying()) {
+        PID_UpdateHoldIntegrator(PID, ReflowOven.currentSetpoint, currentTemperature);
+        PID->out = (THERMALMASS_STEP_POWER < PID->limMax) ? THERMALMASS_STEP_POWER : PID->limMax;
+        return;
+    }
+
+    gains = PID_GetGains(PID);
+    PID_UpdateGains(PID, gains.Kp * ReflowOven.gainScale, gains.Ki * ReflowOven.gainScale,
+                    gains.Kd * ReflowOven.gainScale);
+    // No integration against an open door
+    if (Transient_getState() == TRANSIENT_DOOR_OPEN) {
+        PID_UpdateHoldIntegrator(PID, ReflowOven.currentSetpoint, currentTemperature);
+    } else {
+        PID_Update(PID, ReflowOven.currentSetpoint, currentTemperature);
+    }
+    PID_UpdateGains(PID, gains.Kp, gains.Ki, gains.Kd);
+
+    PID->out += ReflowOven.feedforward;
+    if (PID->out > PID->limMax) {
+        PID->out = PID->limMax;
+    }
+}
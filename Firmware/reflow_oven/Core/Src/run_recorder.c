@@ -0,0 +1,631 @@
+/*
+ * run_recorder.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the reflow run recorder. Samples are stored
+ *              as deltas against the previous tick using three record types:
+ *
+ *              KEY    - absolute sample, always the first record of a block
+ *              NIBBLE - same period and phase, every other delta in [-8, 7]
+ *              VAR    - change mask followed by zigzag varint deltas
+ *
+ *              Unused bytes at the end of a block are zero (end marker), so
+ *              each block decodes on its own and the oldest one can be dropped
+ *              when the ring wraps.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <string.h>
+#include "chamber_model.h"
+#include "main.h"
+#include "run_recorder.h"
+#include "thermal_mass.h"
+#include "transient_detector.h"
+
+/* Flash sector reserved for the recorder (see RUNLOG in STM32F411CEUX_FLASH.ld) */
+#define RUNREC_FLASH_SECTOR    FLASH_SECTOR_7
+
+/* Record tags */
+#define RUNREC_TAG_END         0x00u
+#define RUNREC_TAG_NIBBLE      0x01u
+#define RUNREC_TAG_VAR         0x02u
+#define RUNREC_TAG_KEY         0x03u
+
+/* Largest encoded record: tag + 16 bit mask + one 5 byte varint per field */
+#define RUNREC_MAX_RECORD      (3u + 5u * RUNREC_NUM_FIELDS)
+
+/**
+ * @brief Field order used by the delta coder
+ *
+ * Fields from RUNREC_F_OUTPUT onwards are the ones packed by NIBBLE records.
+ */
+typedef enum {
+    RUNREC_F_DT,       /* Time since previous tick (ms) */
+    RUNREC_F_PHASE,
+    RUNREC_F_OUTPUT,
+    RUNREC_F_SETPOINT,
+    RUNREC_F_PROBE0,
+    RUNREC_F_PROBE1,
+    RUNREC_F_PROBE2,
+    RUNREC_F_PROBE3,
+    RUNREC_F_FUSED,
+    RUNREC_F_P,
+    RUNREC_F_I,
+    RUNREC_F_D,
+    RUNREC_NUM_FIELDS
+} RunRecorder_field_t;
+
+/******************************************************************************
+ * PRIVATE VARIABLES
+ ******************************************************************************/
+bool RunRecorder_saveTrace = true;
+
+static uint8_t runrec_ring[RUNREC_NUM_BLOCKS][RUNREC_BLOCK_SIZE] __attribute__((aligned(4)));
+static uint16_t runrec_head;      /* Block being written */
+static uint16_t runrec_tail;      /* Oldest block */
+static uint16_t runrec_used;      /* Blocks in use */
+static uint16_t runrec_writePos;  /* Write offset inside the head block */
+
+static int32_t runrec_prev[RUNREC_NUM_FIELDS];
+static uint32_t runrec_prevTimeMs;
+
+static bool runrec_active;
+static uint32_t runrec_runCounter;
+static uint32_t runrec_reflowEnterMs;
+static bool runrec_reflowCompleted;
+static bool runrec_emergency;
+static bool runrec_doorOpen;
+static uint16_t runrec_loadChangesAtStart;
+static uint8_t runrec_lastPhase;
+static uint32_t runrec_zoneSpreadTicks;
+
+static RunRecorder_summary_t runrec_summary;
+static RunRecorder_flashHeader_t runrec_header;
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+static void RunRecorder_toFields(const RunRecorder_sample_t *sample, uint32_t prevTimeMs, int32_t *fields);
+static void RunRecorder_fromFields(const int32_t *fields, uint32_t prevTimeMs, RunRecorder_sample_t *sample);
+static uint16_t RunRecorder_encodeKey(const RunRecorder_sample_t *sample, const int32_t *fields, uint8_t *out);
+static uint16_t RunRecorder_encodeDelta(const int32_t *fields, uint8_t *out);
+static void RunRecorder_append(const RunRecorder_sample_t *sample);
+static void RunRecorder_openBlock(void);
+static void RunRecorder_begin(const RunRecorder_sample_t *sample);
+static void RunRecorder_updateSummary(const RunRecorder_sample_t *sample, uint32_t dtMs);
+static void RunRecorder_finish(void);
+static void RunRecorder_writeFlash(void);
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void RunRecorder_Init(void)
+{
+    runrec_head = 0;
+    runrec_tail = 0;
+    runrec_used = 0;
+    runrec_writePos = 0;
+    runrec_active = false;
+    memset(&runrec_summary, 0, sizeof(runrec_summary));
+}
+
+void RunRecorder_record(const RunRecorder_sample_t *sample)
+{
+    uint32_t dtMs;
+
+    if (!runrec_active) {
+        // Runs start on the first tick that leaves IDLE or STANDBY
+        if (sample->phase >= REFLOW_IDLE) {
+            return;
+        }
+        RunRecorder_begin(sample);
+    }
+
+    dtMs = sample->timeMs - runrec_prevTimeMs;
+    RunRecorder_append(sample);
+    RunRecorder_updateSummary(sample, dtMs);
+
+    // The first IDLE or STANDBY tick closes the run
+    if (sample->phase >= REFLOW_IDLE) {
+        RunRecorder_finish();
+    }
+}
+
+void RunRecorder_recordZoneSpread(float spread)
+{
+    if (!runrec_active || (runrec_lastPhase != REFLOW_SOAK && runrec_lastPhase != REFLOW_REFLOW)) {
+        return;
+    }
+
+    // Running mean, so the summary is valid at any time during the run
+    runrec_zoneSpreadTicks++;
+    runrec_summary.zoneSpreadMean += (spread - runrec_summary.zoneSpreadMean) / runrec_zoneSpreadTicks;
+    if (spread > runrec_summary.zoneSpreadMax) {
+        runrec_summary.zoneSpreadMax = spread;
+    }
+}
+
+void RunRecorder_recordEnergy(float energyWh)
+{
+    if (!runrec_active || runrec_lastPhase >= REFLOW_IDLE) {
+        return;
+    }
+
+    runrec_summary.energyWh += energyWh;
+    runrec_summary.phaseEnergyWh[runrec_lastPhase] += energyWh;
+}
+
+bool RunRecorder_isRecording(void)
+{
+    return runrec_active;
+}
+
+const RunRecorder_summary_t *RunRecorder_getSummary(void)
+{
+    return &runrec_summary;
+}
+
+const uint8_t *RunRecorder_getBlock(uint16_t index)
+{
+    if (index >= runrec_used) {
+        return NULL;
+    }
+    return runrec_ring[(runrec_tail + index) % RUNREC_NUM_BLOCKS];
+}
+
+uint16_t RunRecorder_getBlockCount(void)
+{
+    return runrec_used;
+}
+
+uint32_t RunRecorder_decodeBlock(const uint8_t *block, RunRecorder_sampleCallback_t callback, void *context)
+{
+    RunRecorder_sample_t sample;
+    int32_t fields[RUNREC_NUM_FIELDS];
+    uint32_t timeMs = 0;
+    uint32_t count = 0;
+    uint16_t pos = 0;
+    uint8_t i;
+
+    // A block must start with a keyframe
+    if (block == NULL || block[0] != RUNREC_TAG_KEY) {
+        return 0;
+    }
+
+    while (pos < RUNREC_BLOCK_SIZE) {
+        uint8_t tag = block[pos++];
+
+        if (tag == RUNREC_TAG_KEY) {
+            if (pos + 4u + 2u * RUNREC_NUM_FIELDS > RUNREC_BLOCK_SIZE) {
+                break;
+            }
+            timeMs = (uint32_t)block[pos] | ((uint32_t)block[pos + 1] << 8) |
+                     ((uint32_t)block[pos + 2] << 16) | ((uint32_t)block[pos + 3] << 24);
+            pos += 4;
+            for (i = 0; i < RUNREC_NUM_FIELDS; i++) {
+                fields[i] = (int16_t)(block[pos] | (block[pos + 1] << 8));
+                pos += 2;
+            }
+            // Keyframes carry an absolute time: rebase the period on it
+            timeMs -= (uint32_t)fields[RUNREC_F_DT];
+        } else if (tag == RUNREC_TAG_NIBBLE) {
+            if (pos + 5u > RUNREC_BLOCK_SIZE) {
+                break;
+            }
+            for (i = RUNREC_F_OUTPUT; i < RUNREC_NUM_FIELDS; i++) {
+                uint8_t nibble = (block[pos + (i - RUNREC_F_OUTPUT) / 2] >> (((i - RUNREC_F_OUTPUT) & 1) * 4)) & 0x0F;
+                fields[i] += (nibble & 0x08) ? (int32_t)nibble - 16 : (int32_t)nibble;
+            }
+            pos += 5;
+        } else if (tag == RUNREC_TAG_VAR) {
+            uint16_t mask;
+            if (pos + 2u > RUNREC_BLOCK_SIZE) {
+                break;
+            }
+            mask = (uint16_t)(block[pos] | (block[pos + 1] << 8));
+            pos += 2;
+            for (i = 0; i < RUNREC_NUM_FIELDS; i++) {
+                uint32_t zigzag = 0;
+                uint8_t shift = 0;
+                uint8_t byte;
+
+                if (!(mask & (1u << i))) {
+                    continue;
+                }
+                do {
+                    if (pos >= RUNREC_BLOCK_SIZE) {
+                        return count;
+                    }
+                    byte = block[pos++];
+                    zigzag |= (uint32_t)(byte & 0x7F) << shift;
+                    shift += 7;
+                } while (byte & 0x80);
+                fields[i] += (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+            }
+        } else {
+            // RUNREC_TAG_END or garbage: nothing else in this block
+            break;
+        }
+
+        RunRecorder_fromFields(fields, timeMs, &sample);
+        timeMs = sample.timeMs;
+        count++;
+        if (callback != NULL) {
+            callback(&sample, context);
+        }
+    }
+
+    return count;
+}
+
+int16_t RunRecorder_quantize(float value, float scale)
+{
+    float scaled = value * scale;
+
+    // Round half away from zero and saturate to the int16 range
+    scaled += (scaled >= 0.0f) ? 0.5f : -0.5f;
+    if (scaled > 32767.0f) {
+        return INT16_MAX;
+    }
+    if (scaled < -32768.0f) {
+        return INT16_MIN;
+    }
+    return (int16_t)scaled;
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Flatten a sample into the coder's field vector
+ *
+ * @param sample Sample to convert
+ * @param prevTimeMs Time of the previous sample
+ * @param fields Output vector of RUNREC_NUM_FIELDS values
+ */
+static void RunRecorder_toFields(const RunRecorder_sample_t *sample, uint32_t prevTimeMs, int32_t *fields)
+{
+    uint8_t i;
+
+    fields[RUNREC_F_DT] = (int32_t)(sample->timeMs - prevTimeMs);
+    fields[RUNREC_F_PHASE] = sample->phase;
+    fields[RUNREC_F_OUTPUT] = sample->output;
+    fields[RUNREC_F_SETPOINT] = sample->setpoint;
+    for (i = 0; i < RUNREC_NUM_PROBES; i++) {
+        fields[RUNREC_F_PROBE0 + i] = sample->probe[i];
+    }
+    fields[RUNREC_F_FUSED] = sample->fused;
+    fields[RUNREC_F_P] = sample->pTerm;
+    fields[RUNREC_F_I] = sample->iTerm;
+    fields[RUNREC_F_D] = sample->dTerm;
+}
+
+/**
+ * @brief Rebuild a sample from the coder's field vector
+ *
+ * @param fields Vector of RUNREC_NUM_FIELDS values
+ * @param prevTimeMs Time of the previous sample
+ * @param sample Output sample
+ */
+static void RunRecorder_fromFields(const int32_t *fields, uint32_t prevTimeMs, RunRecorder_sample_t *sample)
+{
+    uint8_t i;
+
+    sample->timeMs = prevTimeMs + (uint32_t)fields[RUNREC_F_DT];
+    sample->phase = (uint8_t)fields[RUNREC_F_PHASE];
+    sample->output = (uint8_t)fields[RUNREC_F_OUTPUT];
+    sample->setpoint = (int16_t)fields[RUNREC_F_SETPOINT];
+    for (i = 0; i < RUNREC_NUM_PROBES; i++) {
+        sample->probe[i] = (int16_t)fields[RUNREC_F_PROBE0 + i];
+    }
+    sample->fused = (int16_t)fields[RUNREC_F_FUSED];
+    sample->pTerm = (int16_t)fields[RUNREC_F_P];
+    sample->iTerm = (int16_t)fields[RUNREC_F_I];
+    sample->dTerm = (int16_t)fields[RUNREC_F_D];
+}
+
+/**
+ * @brief Encode an absolute (KEY) record
+ *
+ * @param sample Sample to encode
+ * @param fields Field vector of the sample
+ * @param out Output buffer of at least RUNREC_MAX_RECORD bytes
+ * @return uint16_t - Encoded length in bytes
+ */
+static uint16_t RunRecorder_encodeKey(const RunRecorder_sample_t *sample, const int32_t *fields, uint8_t *out)
+{
+    uint16_t len = 0;
+    uint8_t i;
+
+    out[len++] = RUNREC_TAG_KEY;
+    out[len++] = (uint8_t)(sample->timeMs);
+    out[len++] = (uint8_t)(sample->timeMs >> 8);
+    out[len++] = (uint8_t)(sample->timeMs >> 16);
+    out[len++] = (uint8_t)(sample->timeMs >> 24);
+    for (i = 0; i < RUNREC_NUM_FIELDS; i++) {
+        out[len++] = (uint8_t)(fields[i]);
+        out[len++] = (uint8_t)(fields[i] >> 8);
+    }
+    return len;
+}
+
+/**
+ * @brief Encode a sample as a delta (NIBBLE or VAR) record
+ *
+ * @param fields Field vector of the sample
+ * @param out Output buffer of at least RUNREC_MAX_RECORD bytes
+ * @return uint16_t - Encoded length in bytes
+ */
+static uint16_t RunRecorder_encodeDelta(const int32_t *fields, uint8_t *out)
+{
+    int32_t delta[RUNREC_NUM_FIELDS];
+    bool nibble;
+    uint16_t mask = 0;
+    uint16_t len = 0;
+    uint8_t i;
+
+    nibble = (fields[RUNREC_F_DT] == runrec_prev[RUNREC_F_DT]) &&
+             (fields[RUNREC_F_PHASE] == runrec_prev[RUNREC_F_PHASE]);
+    for (i = 0; i < RUNREC_NUM_FIELDS; i++) {
+        delta[i] = fields[i] - runrec_prev[i];
+        if (delta[i] != 0) {
+            mask |= (uint16_t)(1u << i);
+        }
+        if (i >= RUNREC_F_OUTPUT && (delta[i] < -8 || delta[i] > 7)) {
+            nibble = false;
+        }
+    }
+
+    if (nibble) {
+        // Steady-state tick: ten signed nibbles in five bytes
+        out[len++] = RUNREC_TAG_NIBBLE;
+        memset(&out[len], 0, 5);
+        for (i = RUNREC_F_OUTPUT; i < RUNREC_NUM_FIELDS; i++) {
+            out[len + (i - RUNREC_F_OUTPUT) / 2] |= (uint8_t)((delta[i] & 0x0F) << (((i - RUNREC_F_OUTPUT) & 1) * 4));
+        }
+        return len + 5;
+    }
+
+    out[len++] = RUNREC_TAG_VAR;
+    out[len++] = (uint8_t)mask;
+    out[len++] = (uint8_t)(mask >> 8);
+    for (i = 0; i < RUNREC_NUM_FIELDS; i++) {
+        uint32_t zigzag;
+
+        if (delta[i] == 0) {
+            continue;
+        }
+        zigzag = ((uint32_t)delta[i] << 1) ^ (uint32_t)(delta[i] >> 31);
+        while (zigzag >= 0x80) {
+            out[len++] = (uint8_t)(zigzag | 0x80);
+            zigzag >>= 7;
+        }
+        out[len++] = (uint8_t)zigzag;
+    }
+    return len;
+}
+
+/**
+ * @brief Append a sample to the ring, opening a new block when needed
+ *
+ * @param sample Sample to append
+ */
+static void RunRecorder_append(const RunRecorder_sample_t *sample)
+{
+    int32_t fields[RUNREC_NUM_FIELDS];
+    uint8_t record[RUNREC_MAX_RECORD];
+    uint16_t len;
+
+    RunRecorder_toFields(sample, runrec_prevTimeMs, fields);
+
+    if (runrec_writePos == 0) {
+        len = RunRecorder_encodeKey(sample, fields, record);
+    } else {
+        len = RunRecorder_encodeDelta(fields, record);
+        if (runrec_writePos + len > RUNREC_BLOCK_SIZE) {
+            // Does not fit: start a new block with a keyframe
+            RunRecorder_openBlock();
+            len = RunRecorder_encodeKey(sample, fields, record);
+        }
+    }
+
+    memcpy(&runrec_ring[runrec_head][runrec_writePos], record, len);
+    runrec_writePos += len;
+
+    memcpy(runrec_prev, fields, sizeof(runrec_prev));
+    runrec_prevTimeMs = sample->timeMs;
+}
+
+/**
+ * @brief Move the head to the next block, dropping the oldest one if the ring is full
+ */
+static void RunRecorder_openBlock(void)
+{
+    runrec_head = (runrec_head + 1) % RUNREC_NUM_BLOCKS;
+    if (runrec_used == RUNREC_NUM_BLOCKS) {
+        runrec_tail = (runrec_tail + 1) % RUNREC_NUM_BLOCKS;
+        runrec_summary.droppedBlocks++;
+    } else {
+        runrec_used++;
+    }
+    memset(runrec_ring[runrec_head], 0, RUNREC_BLOCK_SIZE);
+    runrec_writePos = 0;
+}
+
+/**
+ * @brief Start recording a new run
+ *
+ * @param sample First (active phase) sample of the run
+ */
+static void RunRecorder_begin(const RunRecorder_sample_t *sample)
+{
+    runrec_head = 0;
+    runrec_tail = 0;
+    runrec_used = 1;
+    runrec_writePos = 0;
+    memset(runrec_ring[0], 0, RUNREC_BLOCK_SIZE);
+    runrec_prevTimeMs = sample->timeMs;
+
+    memset(&runrec_summary, 0, sizeof(runrec_summary));
+    runrec_summary.runId = ++runrec_runCounter;
+    runrec_summary.startTimeMs = sample->timeMs;
+    runrec_summary.peakTemperature = sample->fused / RUNREC_TEMP_SCALE;
+    runrec_summary.entryOffsetMs = ReflowOven.entryOffsetMs;
+
+    // Keep what is needed to replay the run
+    runrec_header.profile = ReflowOven.ReflowParameters;
+    runrec_header.pid = PID;
+    memcpy(runrec_header.powerTable, PowerLin_getTable(), sizeof(runrec_header.powerTable));
+
+    runrec_reflowEnterMs = 0;
+    runrec_reflowCompleted = false;
+    runrec_emergency = false;
+    runrec_lastPhase = sample->phase;
+    runrec_zoneSpreadTicks = 0;
+    runrec_doorOpen = false;
+    runrec_loadChangesAtStart = Transient_getLoadChanges();
+    runrec_active = true;
+}
+
+/**
+ * @brief Fold a sample into the run summary
+ *
+ * @param sample Recorded sample
+ * @param dtMs Time since previous sample (ms)
+ */
+static void RunRecorder_updateSummary(const RunRecorder_sample_t *sample, uint32_t dtMs)
+{
+    float fused = sample->fused / RUNREC_TEMP_SCALE;
+    int16_t probeMin = INT16_MAX;
+    int16_t probeMax = INT16_MIN;
+    uint8_t i;
+
+    runrec_summary.samples++;
+    runrec_summary.durationMs = sample->timeMs - runrec_summary.startTimeMs;
+    if (sample->phase < REFLOW_IDLE) {
+        runrec_summary.phaseDurationMs[sample->phase] += dtMs;
+    }
+
+    if (fused > runrec_summary.peakTemperature) {
+        runrec_summary.peakTemperature = fused;
+    }
+    if (fused >= RUNREC_LIQUIDUS_TEMP) {
+        runrec_summary.timeAboveLiquidusS += dtMs * 0.001f;
+    }
+
+    for (i = 0; i < RUNREC_NUM_PROBES; i++) {
+        if (sample->probe[i] == RUNREC_PROBE_FAULT) {
+            runrec_summary.probeFaults |= (uint8_t)(1u << i);
+            continue;
+        }
+        if (sample->probe[i] < probeMin) {
+            probeMin = sample->probe[i];
+        }
+        if (sample->probe[i] > probeMax) {
+            probeMax = sample->probe[i];
+        }
+    }
+    if (probeMax >= probeMin && (probeMax - probeMin) / RUNREC_PROBE_SCALE > runrec_summary.maxProbeSpread) {
+        runrec_summary.maxProbeSpread = (probeMax - probeMin) / RUNREC_PROBE_SCALE;
+    }
+
+    // Door openings and load changes seen by the transient detector
+    if (Transient_getState() == TRANSIENT_DOOR_OPEN) {
+        runrec_summary.doorOpenMs += dtMs;
+        if (!runrec_doorOpen && runrec_summary.doorOpenings < UINT8_MAX) {
+            runrec_summary.doorOpenings++;
+        }
+        runrec_doorOpen = true;
+    } else {
+        runrec_doorOpen = false;
+    }
+    runrec_summary.loadChanges = (uint8_t)(Transient_getLoadChanges() - runrec_loadChangesAtStart);
+
+    // Load identified at preheat start and what the process made of it
+    runrec_summary.massRatio = ThermalMass_getRatio();
+    runrec_summary.massGain = ChamberModel_getGain();
+    runrec_summary.soakTimeMs = ReflowOven.soakTimeMs;
+
+    // Track how the run ends
+    if (ReflowOven.emergencyStop) {
+        runrec_emergency = true;
+    }
+    if (sample->phase != runrec_lastPhase) {
+        if (sample->phase == REFLOW_REFLOW) {
+            runrec_reflowEnterMs = sample->timeMs;
+        } else if (runrec_lastPhase == REFLOW_REFLOW && sample->phase == REFLOW_COOLDOWN) {
+            runrec_reflowCompleted = (sample->timeMs - runrec_reflowEnterMs) >=
+                                     (uint32_t)(runrec_header.profile.ReflowTime * 1000);
+        }
+        runrec_lastPhase = sample->phase;
+    }
+}
+
+/**
+ * @brief Close the current run and persist it
+ */
+static void RunRecorder_finish(void)
+{
+    if (runrec_emergency) {
+        runrec_summary.endReason = RUNREC_END_EMERGENCY;
+    } else if (runrec_reflowCompleted) {
+        runrec_summary.endReason = RUNREC_END_COMPLETED;
+    } else {
+        runrec_summary.endReason = RUNREC_END_ABORTED;
+    }
+    runrec_active = false;
+
+    RunRecorder_writeFlash();
+}
+
+/**
+ * @brief Write the summary (and the trace if enabled) to the recorder flash sector
+ *
+ * Runs once per run from the control loop while the oven is idle; erasing
+ * the 128 KB sector takes one to two seconds. The last kilobyte of the
+ * sector holds the power linearization table (PWRLIN_FLASH_OFFSET), written
+ * back once the run is stored.
+ */
+static void RunRecorder_writeFlash(void)
+{
+    extern uint8_t _srunlog[]; /* Symbol defined in the linker script */
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t sectorError = 0;
+    uint32_t address = (uint32_t)(uintptr_t)_srunlog;
+    const uint32_t *word;
+    uint32_t i;
+    uint16_t block;
+
+    runrec_header.magic = RUNREC_FLASH_MAGIC;
+    runrec_header.version = RUNREC_FLASH_VERSION;
+    runrec_header.blockSize = RUNREC_BLOCK_SIZE;
+    runrec_header.numBlocks = RunRecorder_saveTrace ? runrec_used : 0;
+    runrec_header.headerSize = sizeof(RunRecorder_flashHeader_t);
+    runrec_header.summary = runrec_summary;
+
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Sector = RUNREC_FLASH_SECTOR;
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+    HAL_FLASH_Unlock();
+    if (HAL_FLASHEx_Erase(&erase, &sectorError) == HAL_OK) {
+        word = (const uint32_t *)&runrec_header;
+        for (i = 0; i < sizeof(RunRecorder_flashHeader_t) / 4; i++, address += 4) {
+            HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, word[i]);
+        }
+        for (block = 0; block < runrec_header.numBlocks; block++) {
+            word = (const uint32_t *)RunRecorder_getBlock(block);
+            for (i = 0; i < RUNREC_BLOCK_SIZE / 4; i++, address += 4) {
+                HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, word[i]);
+            }
+        }
+    }
+    HAL_FLASH_Lock();
+    PowerLin_store();
+}
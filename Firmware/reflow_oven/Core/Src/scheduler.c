@@ -0,0 +1,227 @@
+/*
+ * scheduler.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the cooperative task scheduler.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stddef.h>
+#include "scheduler.h"
+#include "cpu_load.h"
+#include "dwt.h"
+#include "trace.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ******************************************************************************/
+typedef struct {
+    Scheduler_taskConfig_t config;
+    Scheduler_stats_t stats;
+    uint32_t nextReleaseMs;           /* Scheduler time of the next release */
+    volatile bool pending;            /* Released, not run yet */
+    volatile uint32_t releaseMs;      /* Scheduler time of the pending release */
+    volatile uint32_t releaseCycles;  /* DWT stamp of the pending release */
+} Scheduler_task_t;
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static Scheduler_task_t scheduler_tasks[SCHEDULER_MAX_TASKS];
+static uint8_t scheduler_taskCount;
+static volatile uint32_t scheduler_timeMs;
+static volatile bool scheduler_running;
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void Scheduler_Init(uint32_t nowMs)
+{
+    scheduler_running = false;
+    scheduler_taskCount = 0;
+    scheduler_timeMs = nowMs;
+}
+
+int8_t Scheduler_addTask(const Scheduler_taskConfig_t *config)
+{
+    Scheduler_task_t *task;
+
+    if (scheduler_running || scheduler_taskCount >= SCHEDULER_MAX_TASKS ||
+        config->run == NULL || config->periodMs == 0) {
+        return -1;
+    }
+
+    task = &scheduler_tasks[scheduler_taskCount];
+    task->config = *config;
+    task->pending = false;
+    task->stats = (Scheduler_stats_t){0};
+    return (int8_t)scheduler_taskCount++;
+}
+
+void Scheduler_start(void)
+{
+    uint8_t id;
+
+    for (id = 0; id < scheduler_taskCount; id++) {
+        scheduler_tasks[id].nextReleaseMs = scheduler_timeMs + scheduler_tasks[id].config.offsetMs;
+    }
+    scheduler_running = true;
+}
+
+uint32_t Scheduler_tick(void)
+{
+    uint32_t now = ++scheduler_timeMs;
+    uint32_t cycles = DWT_getCycles();
+    uint32_t due = 0;
+    uint8_t id;
+
+    if (!scheduler_running) {
+        return 0;
+    }
+
+    for (id = 0; id < scheduler_taskCount; id++) {
+        Scheduler_task_t *task = &scheduler_tasks[id];
+
+        if ((int32_t)(now - task->nextReleaseMs) < 0) {
+            continue;
+        }
+        task->nextReleaseMs += task->config.periodMs;
+        due |= 1u << id;
+
+        // Still waiting from the last period: keep the older release, count the lost one
+        if (task->pending) {
+            task->stats.skipped++;
+            continue;
+        }
+        task->releaseMs = now;
+        task->releaseCycles = cycles;
+        task->pending = true;
+    }
+    return due;
+}
+
+void Scheduler_release(uint8_t id)
+{
+    Scheduler_task_t *task;
+    uint32_t primask;
+
+    if (!scheduler_running || id >= scheduler_taskCount) {
+        return;
+    }
+    task = &scheduler_tasks[id];
+
+    // Already waiting: the run it is waiting for serves this event too
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (!task->pending) {
+        task->releaseMs = scheduler_timeMs;
+        task->releaseCycles = DWT_getCycles();
+        task->pending = true;
+    }
+    __set_PRIMASK(primask);
+}
+
+bool Scheduler_runNext(void)
+{
+    Scheduler_task_t *task = NULL;
+    uint32_t releaseMs, releaseCycles, startCycles, endCycles;
+    uint32_t latencyUs, responseUs, execUs;
+    uint32_t primask;
+    uint8_t id;
+
+    // Highest priority (lowest number) released task, registration order on ties
+    for (id = 0; id < scheduler_taskCount; id++) {
+        if (scheduler_tasks[id].pending &&
+            (task == NULL || scheduler_tasks[id].config.priority < task->config.priority)) {
+            task = &scheduler_tasks[id];
+        }
+    }
+    if (task == NULL) {
+        return false;
+    }
+
+    // Take the release atomically against the timebase ISR
+    primask = __get_PRIMASK();
+    __disable_irq();
+    releaseMs = task->releaseMs;
+    releaseCycles = task->releaseCycles;
+    task->pending = false;
+    __set_PRIMASK(primask);
+
+    TRACE(TRACE_TASK_BEGIN, task - scheduler_tasks);
+    startCycles = DWT_getCycles();
+    task->config.run(releaseMs);
+    endCycles = DWT_getCycles();
+    TRACE(TRACE_TASK_END, task - scheduler_tasks);
+
+    latencyUs = (uint32_t)DWT_cyclesToUs(startCycles - releaseCycles);
+    responseUs = (uint32_t)DWT_cyclesToUs(endCycles - releaseCycles);
+    execUs = (uint32_t)DWT_cyclesToUs(endCycles - startCycles);
+
+    task->stats.runs++;
+    if (responseUs > task->config.deadlineUs) {
+        task->stats.overruns++;
+    }
+    if (latencyUs > task->stats.maxLatencyUs) {
+        task->stats.maxLatencyUs = latencyUs;
+    }
+    if (responseUs > task->stats.maxResponseUs) {
+        task->stats.maxResponseUs = responseUs;
+    }
+    if (execUs > task->stats.maxExecUs) {
+        task->stats.maxExecUs = execUs;
+    }
+    return true;
+}
+
+void Scheduler_sleep(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint8_t id;
+
+    // A release between the last check and the WFI must not be slept through:
+    // decide with interrupts masked, the pending one still ends the WFI
+    __disable_irq();
+    for (id = 0; id < scheduler_taskCount; id++) {
+        if (scheduler_tasks[id].pending) {
+            break;
+        }
+    }
+    if (id == scheduler_taskCount) {
+        CpuLoad_sleep();
+    }
+    __set_PRIMASK(primask);
+}
+
+uint32_t Scheduler_getTime(void)
+{
+    return scheduler_timeMs;
+}
+
+uint8_t Scheduler_getTaskCount(void)
+{
+    return scheduler_taskCount;
+}
+
+const Scheduler_taskConfig_t *Scheduler_getTask(uint8_t id)
+{
+    return (id < scheduler_taskCount) ? &scheduler_tasks[id].config : NULL;
+}
+
+const Scheduler_stats_t *Scheduler_getStats(uint8_t id)
+{
+    return (id < scheduler_taskCount) ? &scheduler_tasks[id].stats : NULL;
+}
+
+void Scheduler_resetStats(void)
+{
+    uint8_t id;
+
+    for (id = 0; id < scheduler_taskCount; id++) {
+        scheduler_tasks[id].stats = (Scheduler_stats_t){0};
+    }
+}
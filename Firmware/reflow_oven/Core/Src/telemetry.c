@@ -0,0 +1,54 @@
+/*
+ * telemetry.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the USART1 telemetry lines.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdarg.h>
+#include <stdio.h>
+#include "telemetry.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static UART_HandleTypeDef *telemetry_huart = NULL;
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void Telemetry_Init(UART_HandleTypeDef *huart)
+{
+    telemetry_huart = huart;
+}
+
+void Telemetry_printf(const char *format, ...)
+{
+    char line[TELEMETRY_LINE_SIZE];
+    va_list args;
+    int length;
+
+    if (telemetry_huart == NULL) {
+        return;
+    }
+
+    // Leave room for the terminator
+    va_start(args, format);
+    length = vsnprintf(line, sizeof(line) - 2, format, args);
+    va_end(args);
+    if (length < 0) {
+        return;
+    }
+    if (length > (int)sizeof(line) - 3) {
+        length = sizeof(line) - 3;
+    }
+    line[length++] = '\r';
+    line[length++] = '\n';
+
+    HAL_UART_Transmit(telemetry_huart, (uint8_t *)line, (uint16_t)length, TELEMETRY_TX_TIMEOUT_MS);
+}
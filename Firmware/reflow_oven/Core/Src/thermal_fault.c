@@ -0,0 +1,233 @@
+/*
+ * thermal_fault.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the heater and probe fault detector.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stddef.h>
+#include "chamber_model.h"
+#include "thermal_fault.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static ThermalFault_t fault_latched;
+static uint8_t fault_probe;
+
+/* Slope window */
+static bool fault_windowOpen;
+static uint32_t fault_windowStartTime;
+static float fault_windowStartTemp;
+static float fault_windowPowerSum;
+static uint32_t fault_windowTicks;
+static uint32_t fault_lastOnTime;     /* Last tick with a non-zero command (ms) */
+static float fault_observedSlope;
+static float fault_expectedSlope;
+
+/* Persistence counters */
+static uint8_t fault_uncommandedWindows;
+static uint8_t fault_noRiseWindows;
+static uint8_t fault_probeTicks[FAULT_NUM_PROBES];
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+static void ThermalFault_checkSlope(uint32_t currentTimeMs, float temperature);
+static void ThermalFault_checkProbes(const float *probes, uint8_t healthyMask);
+static void ThermalFault_restart(void);
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void ThermalFault_Init(void)
+{
+    fault_latched = FAULT_NONE;
+    fault_probe = 0;
+    fault_observedSlope = 0.0f;
+    fault_expectedSlope = 0.0f;
+    ThermalFault_restart();
+}
+
+ThermalFault_t ThermalFault_update(uint32_t currentTimeMs, float power, float temperature,
+                                   const float *probes, uint8_t healthyMask)
+{
+    if (fault_latched != FAULT_NONE) {
+        return fault_latched;
+    }
+
+    if (!fault_windowOpen) {
+        // Unknown history: treat the heaters as just switched off
+        fault_windowOpen = true;
+        fault_windowStartTime = currentTimeMs;
+        fault_windowStartTemp = temperature;
+        fault_windowPowerSum = 0.0f;
+        fault_windowTicks = 0;
+        fault_lastOnTime = currentTimeMs;
+    } else {
+        fault_windowPowerSum += power;
+        fault_windowTicks++;
+        if (currentTimeMs - fault_windowStartTime >= FAULT_WINDOW_MS) {
+            ThermalFault_checkSlope(currentTimeMs, temperature);
+        }
+    }
+    if (power > 0.0f) {
+        fault_lastOnTime = currentTimeMs;
+    }
+
+    ThermalFault_checkProbes(probes, healthyMask);
+    return fault_latched;
+}
+
+ThermalFault_t ThermalFault_get(void)
+{
+    return fault_latched;
+}
+
+uint8_t ThermalFault_getProbe(void)
+{
+    return fault_probe;
+}
+
+void ThermalFault_getSlopes(float *observed, float *expected)
+{
+    if (observed != NULL) {
+        *observed = fault_observedSlope;
+    }
+    if (expected != NULL) {
+        *expected = fault_expectedSlope;
+    }
+}
+
+void ThermalFault_holdSlopeChecks(void)
+{
+    fault_windowOpen = false;
+    fault_uncommandedWindows = 0;
+    fault_noRiseWindows = 0;
+}
+
+void ThermalFault_raise(ThermalFault_t fault)
+{
+    if (fault_latched == FAULT_NONE) {
+        fault_latched = fault;
+    }
+}
+
+void ThermalFault_clear(void)
+{
+    fault_latched = FAULT_NONE;
+    ThermalFault_restart();
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ ******************************************************************************/
+/**
+ * @brief Close the slope window: compare observed and modelled slope
+ *
+ * @param currentTimeMs Current system time (ms)
+ * @param temperature Fused chamber temperature (°C)
+ */
+static void ThermalFault_checkSlope(uint32_t currentTimeMs, float temperature)
+{
+    float windowS = (currentTimeMs - fault_windowStartTime) * 0.001f;
+    float meanPower = fault_windowPowerSum / fault_windowTicks;
+    float meanTemp = 0.5f * (temperature + fault_windowStartTemp);
+
+    fault_observedSlope = (temperature - fault_windowStartTemp) / windowS;
+    fault_expectedSlope = ChamberModel_slope(meanPower, meanTemp);
+
+    // Stuck-on SSR: rising although nothing has been fired for a while
+    if (currentTimeMs - fault_lastOnTime >= FAULT_OFF_SETTLE_MS &&
+        fault_observedSlope > FAULT_UNCOMMANDED_SLOPE) {
+        if (++fault_uncommandedWindows >= FAULT_UNCOMMANDED_WINDOWS) {
+            fault_latched = FAULT_UNCOMMANDED_HEATING;
+        }
+    } else {
+        fault_uncommandedWindows = 0;
+    }
+
+    // Dead element: full command, clear expected rise, almost nothing observed
+    if (meanPower >= FAULT_FULL_POWER && fault_expectedSlope >= FAULT_MIN_EXPECTED_SLOPE &&
+        fault_observedSlope < FAULT_NO_RISE_RATIO * fault_expectedSlope) {
+        if (++fault_noRiseWindows >= FAULT_NO_RISE_WINDOWS && fault_latched == FAULT_NONE) {
+            fault_latched = FAULT_NO_RISE;
+        }
+    } else {
+        fault_noRiseWindows = 0;
+    }
+
+    // Next window starts where this one ended
+    fault_windowStartTime = currentTimeMs;
+    fault_windowStartTemp = temperature;
+    fault_windowPowerSum = 0.0f;
+    fault_windowTicks = 0;
+}
+
+/**
+ * @brief Compare every healthy probe with the median of the healthy probes
+ *
+ * @param probes Reading of each probe (°C)
+ * @param healthyMask Bit per probe that answered in this tick
+ */
+static void ThermalFault_checkProbes(const float *probes, uint8_t healthyMask)
+{
+    float sorted[FAULT_NUM_PROBES];
+    float median, deviation;
+    uint8_t count = 0;
+    uint8_t i, j;
+
+    // Insertion sort of the healthy readings
+    for (i = 0; i < FAULT_NUM_PROBES; i++) {
+        if (!(healthyMask & (1u << i))) {
+            continue;
+        }
+        for (j = count; j > 0 && sorted[j - 1] > probes[i]; j--) {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = probes[i];
+        count++;
+    }
+
+    // Two probes cannot tell which one is wrong
+    if (count < 3) {
+        for (i = 0; i < FAULT_NUM_PROBES; i++) {
+            fault_probeTicks[i] = 0;
+        }
+        return;
+    }
+    median = (count & 1) ? sorted[count / 2] : 0.5f * (sorted[count / 2 - 1] + sorted[count / 2]);
+
+    for (i = 0; i < FAULT_NUM_PROBES; i++) {
+        deviation = probes[i] - median;
+        if ((healthyMask & (1u << i)) &&
+            (deviation > FAULT_PROBE_MAX_DEVIATION || deviation < -FAULT_PROBE_MAX_DEVIATION)) {
+            if (++fault_probeTicks[i] >= FAULT_PROBE_TICKS && fault_latched == FAULT_NONE) {
+                fault_latched = FAULT_PROBE_DIVERGENCE;
+                fault_probe = i;
+            }
+        } else {
+            fault_probeTicks[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Drop the slope window and the persistence counters
+ */
+static void ThermalFault_restart(void)
+{
+    uint8_t i;
+
+    fault_windowOpen = false;
+    fault_uncommandedWindows = 0;
+    fault_noRiseWindows = 0;
+    for (i = 0; i < FAULT_NUM_PROBES; i++) {
+        fault_probeTicks[i] = 0;
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ * thermal_mass.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the preheat thermal mass identification.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "thermal_mass.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static ThermalMass_state_t thermalMass_state;
+static float thermalMass_ratio;
+
+static uint32_t thermalMass_startTime;
+static bool thermalMass_measuring;       /* Lag passed, slope measurement running */
+static uint32_t thermalMass_measureTime; /* Start of the slope measurement (ms) */
+static float thermalMass_measureTemp;
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+static void ThermalMass_estimate(float temperature, uint32_t currentTimeMs);
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void ThermalMass_Init(void)
+{
+    thermalMass_state = THERMALMASS_IDLE;
+    thermalMass_ratio = 1.0f;
+    thermalMass_measuring = false;
+}
+
+void ThermalMass_start(uint32_t currentTimeMs)
+{
+    // Every run is identified afresh: the reference load until the window closes
+    thermalMass_state = THERMALMASS_IDENTIFYING;
+    thermalMass_ratio = 1.0f;
+    ChamberModel_setGain(CHAMBER_REF_GAIN);
+    thermalMass_startTime = currentTimeMs;
+    thermalMass_measuring = false;
+}
+
+ThermalMass_state_t ThermalMass_update(float temperature, uint32_t currentTimeMs)
+{
+    uint32_t elapsedMs = currentTimeMs - thermalMass_startTime;
+
+    if (thermalMass_state != THERMALMASS_IDENTIFYING) {
+        return thermalMass_state;
+    }
+
+    // The elements take a while to glow: measure only the settled part of the response
+    if (!thermalMass_measuring && elapsedMs >= THERMALMASS_LAG_MS) {
+        thermalMass_measuring = true;
+        thermalMass_measureTime = currentTimeMs;
+        thermalMass_measureTemp = temperature;
+    }
+    if (elapsedMs >= THERMALMASS_WINDOW_MS) {
+        ThermalMass_estimate(temperature, currentTimeMs);
+    }
+    return thermalMass_state;
+}
+
+void ThermalMass_abort(void)
+{
+    if (thermalMass_state == THERMALMASS_IDENTIFYING) {
+        thermalMass_state = THERMALMASS_FAILED;
+    }
+}
+
+ThermalMass_state_t ThermalMass_getState(void)
+{
+    return thermalMass_state;
+}
+
+bool ThermalMass_isIdentifying(void)
+{
+    return thermalMass_state == THERMALMASS_IDENTIFYING;
+}
+
+float ThermalMass_getRatio(void)
+{
+    return thermalMass_ratio;
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ ******************************************************************************/
+/**
+ * @brief Close the window and solve the model for the heating gain
+ *
+ * @param temperature Fused chamber temperature (°C)
+ * @param currentTimeMs Current system time (ms)
+ */
+static void ThermalMass_estimate(float temperature, uint32_t currentTimeMs)
+{
+    float rise = temperature - thermalMass_measureTemp;
+    float meanTemp = 0.5f * (temperature + thermalMass_measureTemp);
+    float slope, gain, ratio;
+
+    if (!thermalMass_measuring || currentTimeMs == thermalMass_measureTime || rise < THERMALMASS_MIN_RISE) {
+        thermalMass_state = THERMALMASS_FAILED;
+        return;
+    }
+
+    slope = rise * 1000.0f / (currentTimeMs - thermalMass_measureTime);
+    gain = ChamberModel_solveGain(slope, THERMALMASS_STEP_POWER, meanTemp);
+
+    ratio = CHAMBER_REF_GAIN / gain;
+    if (ratio < THERMALMASS_MIN_RATIO) {
+        ratio = THERMALMASS_MIN_RATIO;
+    } else if (ratio > THERMALMASS_MAX_RATIO) {
+        ratio = THERMALMASS_MAX_RATIO;
+    }
+
+    ChamberModel_setGain(CHAMBER_REF_GAIN / ratio);
+    thermalMass_ratio = ratio;
+    thermalMass_state = THERMALMASS_DONE;
+}
@@ -0,0 +1,98 @@
+/*
+ * trace.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the event trace ring. Compiled empty when
+ *              TRACE_ENABLE is 0.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdatomic.h>
+#include <stddef.h>
+#include "trace.h"
+
+#if TRACE_ENABLE
+#include "dwt.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static Trace_record_t trace_ring[TRACE_RECORDS];
+static atomic_uint trace_head;          /* Records ever claimed; slot = head % TRACE_RECORDS */
+static volatile uint32_t trace_mask;
+static volatile bool trace_frozen;
+static volatile uint32_t trace_dropped;
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void Trace_Init(void)
+{
+    trace_frozen = true;
+    atomic_store(&trace_head, 0u);
+    trace_dropped = 0;
+    trace_mask = ~(1u << TRACE_ZERO_CROSS);
+    trace_frozen = false;
+}
+
+void Trace_record(Trace_event_t event, uint32_t payload)
+{
+    Trace_record_t *record;
+
+    if (!(trace_mask & (1u << event))) {
+        return;
+    }
+    if (trace_frozen) {
+        trace_dropped++;
+        return;
+    }
+
+    // LDREX/STREX claim: a preempting ISR gets the next slot, never this one
+    record = &trace_ring[atomic_fetch_add_explicit(&trace_head, 1u, memory_order_relaxed) & (TRACE_RECORDS - 1)];
+    record->cycles = DWT_getCycles();
+    record->data = ((uint32_t)event << 24) | (payload & TRACE_PAYLOAD_MASK);
+}
+
+void Trace_setMask(uint32_t mask)
+{
+    trace_mask = mask;
+}
+
+uint32_t Trace_getMask(void)
+{
+    return trace_mask;
+}
+
+void Trace_freeze(bool frozen)
+{
+    trace_frozen = frozen;
+}
+
+uint32_t Trace_getCount(void)
+{
+    uint32_t head = atomic_load(&trace_head);
+
+    return (head < TRACE_RECORDS) ? head : TRACE_RECORDS;
+}
+
+const Trace_record_t *Trace_get(uint32_t index)
+{
+    uint32_t head = atomic_load(&trace_head);
+    uint32_t count = (head < TRACE_RECORDS) ? head : TRACE_RECORDS;
+
+    if (index >= count) {
+        return NULL;
+    }
+    return &trace_ring[(head - count + index) & (TRACE_RECORDS - 1)];
+}
+
+uint32_t Trace_getDropped(void)
+{
+    return trace_dropped;
+}
+
+#endif /* TRACE_ENABLE */
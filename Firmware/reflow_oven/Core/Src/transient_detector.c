@@ -0,0 +1,199 @@
+/*
+ * transient_detector.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the door-open and load-change detector.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "transient_detector.h"
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+static Transient_state_t transient_state;
+
+/* Last TRANSIENT_SLOPE_TICKS + 1 samples, for the one second slope */
+static float transient_temps[TRANSIENT_SLOPE_TICKS + 1];
+static uint32_t transient_times[TRANSIENT_SLOPE_TICKS + 1];
+static uint8_t transient_head;
+static uint8_t transient_filled;
+static uint8_t transient_ticks;          /* Persistence of the pending door transition */
+static uint32_t transient_doorOpenTime;  /* When the door opened (ms) */
+
+/* Gain tracking */
+static uint8_t transient_relearn;        /* Windows left with the fast filter */
+static uint8_t transient_loadWindows;
+static uint16_t transient_loadChanges;
+static bool transient_windowOpen;
+static uint32_t transient_windowStartTime;
+static float transient_windowStartTemp;
+static float transient_windowPowerSum;
+static uint32_t transient_windowTicks;
+
+/******************************************************************************
+ * PRIVATE FUNCTION PROTOTYPES
+ ******************************************************************************/
+static float Transient_slope(void);
+static void Transient_updateGain(float temperature, uint32_t currentTimeMs);
+static void Transient_restartWindow(void);
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void Transient_Init(void)
+{
+    transient_state = TRANSIENT_NONE;
+    transient_head = 0;
+    transient_filled = 0;
+    transient_ticks = 0;
+    transient_relearn = TRANSIENT_RELEARN_WINDOWS;
+    transient_loadWindows = 0;
+    transient_loadChanges = 0;
+    Transient_restartWindow();
+}
+
+Transient_state_t Transient_update(ReflowPhases_t phase, float temperature, float power, uint32_t currentTimeMs)
+{
+    float slope;
+
+    transient_head = (uint8_t)((transient_head + 1) % (TRANSIENT_SLOPE_TICKS + 1));
+    transient_temps[transient_head] = temperature;
+    transient_times[transient_head] = currentTimeMs;
+    if (transient_filled < TRANSIENT_SLOPE_TICKS + 1) {
+        transient_filled++;
+    }
+
+    // Only heating phases: cooldown opens the door on purpose, idle has nothing to protect
+    if (phase >= REFLOW_COOLDOWN || transient_filled <= TRANSIENT_SLOPE_TICKS) {
+        transient_state = TRANSIENT_NONE;
+        transient_ticks = 0;
+        Transient_restartWindow();
+        return transient_state;
+    }
+    slope = Transient_slope();
+
+    if (transient_state == TRANSIENT_NONE) {
+        transient_ticks = (slope < TRANSIENT_DOOR_SLOPE) ? transient_ticks + 1 : 0;
+        if (transient_ticks >= TRANSIENT_DOOR_TICKS) {
+            transient_state = TRANSIENT_DOOR_OPEN;
+            transient_doorOpenTime = currentTimeMs;
+            transient_ticks = 0;
+            Transient_restartWindow();
+            return transient_state;
+        }
+        Transient_updateGain(temperature, currentTimeMs);
+        transient_windowPowerSum += power;
+        transient_windowTicks++;
+    } else {
+        // Closed once the chamber stops falling, or give the clock back after too long
+        transient_ticks = (slope > TRANSIENT_CLOSE_SLOPE) ? transient_ticks + 1 : 0;
+        if (transient_ticks >= TRANSIENT_CLOSE_TICKS ||
+            currentTimeMs - transient_doorOpenTime >= TRANSIENT_MAX_PAUSE_MS) {
+            transient_state = TRANSIENT_NONE;
+            transient_ticks = 0;
+            transient_relearn = TRANSIENT_RELEARN_WINDOWS; // The load may have been swapped
+            Transient_restartWindow();
+        }
+    }
+    return transient_state;
+}
+
+Transient_state_t Transient_getState(void)
+{
+    return transient_state;
+}
+
+uint16_t Transient_getLoadChanges(void)
+{
+    return transient_loadChanges;
+}
+
+/******************************************************************************
+ * PRIVATE FUNCTION IMPLEMENTATIONS
+ ******************************************************************************/
+/**
+ * @brief Slope over the last TRANSIENT_SLOPE_TICKS ticks
+ *
+ * @return float - Temperature slope (°C/s)
+ */
+static float Transient_slope(void)
+{
+    uint8_t oldest = (uint8_t)((transient_head + 1) % (TRANSIENT_SLOPE_TICKS + 1));
+    uint32_t dtMs = transient_times[transient_head] - transient_times[oldest];
+
+    if (dtMs == 0) {
+        return 0.0f;
+    }
+    return (transient_temps[transient_head] - transient_temps[oldest]) * 1000.0f / dtMs;
+}
+
+/**
+ * @brief Close the gain window when due and fold it into the estimate
+ *
+ * @param temperature Fused chamber temperature (°C)
+ * @param currentTimeMs Current system time (ms)
+ */
+static void Transient_updateGain(float temperature, uint32_t currentTimeMs)
+{
+    float meanPower, meanTemp, slope, gain, modelGain, error;
+
+    if (!transient_windowOpen) {
+        transient_windowOpen = true;
+        transient_windowStartTime = currentTimeMs;
+        transient_windowStartTemp = temperature;
+        transient_windowPowerSum = 0.0f;
+        transient_windowTicks = 0;
+        return;
+    }
+    if (currentTimeMs - transient_windowStartTime < TRANSIENT_WINDOW_MS || transient_windowTicks == 0) {
+        return;
+    }
+
+    meanPower = transient_windowPowerSum / transient_windowTicks;
+    meanTemp = 0.5f * (temperature + transient_windowStartTemp);
+    slope = (temperature - transient_windowStartTemp) * 1000.0f / (currentTimeMs - transient_windowStartTime);
+    Transient_restartWindow();
+    if (meanPower < TRANSIENT_MIN_POWER) {
+        return; // Too little power: the slope is mostly losses
+    }
+
+    gain = ChamberModel_solveGain(slope, meanPower, meanTemp);
+    if (gain <= 0.0f) {
+        return;
+    }
+    modelGain = ChamberModel_getGain();
+
+    if (transient_relearn > 0) {
+        transient_relearn--;
+        ChamberModel_setGain(modelGain + TRANSIENT_FAST_ALPHA * (gain - modelGain));
+        transient_loadWindows = 0;
+        return;
+    }
+
+    // A heavy panel (or a removed one) moves the gain far from the model's and keeps it there
+    error = (gain - modelGain) / modelGain;
+    if (error > TRANSIENT_LOAD_RATIO || error < -TRANSIENT_LOAD_RATIO) {
+        if (++transient_loadWindows >= TRANSIENT_LOAD_WINDOWS) {
+            transient_loadChanges++;
+            transient_loadWindows = 0;
+            transient_relearn = TRANSIENT_RELEARN_WINDOWS;
+            ChamberModel_setGain(gain);
+        }
+        return;
+    }
+    transient_loadWindows = 0;
+    ChamberModel_setGain(modelGain + TRANSIENT_SLOW_ALPHA * (gain - modelGain));
+}
+
+/**
+ * @brief Drop the current gain window
+ */
+static void Transient_restartWindow(void)
+{
+    transient_windowOpen = false;
+}
@@ -0,0 +1,65 @@
+/*
+ * watchdog.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Implementation of the IWDG control loop watchdog.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include "watchdog.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ******************************************************************************/
+#define WATCHDOG_KEY_RELOAD 0xAAAAu
+#define WATCHDOG_KEY_ACCESS 0x5555u /* Unlocks PR and RLR */
+#define WATCHDOG_KEY_START  0xCCCCu
+#define WATCHDOG_PRESCALER  IWDG_PR_PR_1 /* LSI / 32: 1 count per ms */
+#define WATCHDOG_MAX_RELOAD 0x0FFFu
+
+/******************************************************************************
+ * FUNCTION DEFINITIONS
+ ******************************************************************************/
+void Watchdog_Init(uint32_t timeoutMs)
+{
+    // Keep the counter still while a debugger holds the core
+    DBGMCU->APB1FZ |= DBGMCU_APB1_FZ_DBG_IWDG_STOP;
+
+    IWDG->KR = WATCHDOG_KEY_START;
+    IWDG->KR = WATCHDOG_KEY_ACCESS;
+    IWDG->PR = WATCHDOG_PRESCALER;
+    Watchdog_setTimeout(timeoutMs);
+}
+
+void Watchdog_setTimeout(uint32_t timeoutMs)
+{
+    if (timeoutMs > WATCHDOG_MAX_RELOAD) {
+        timeoutMs = WATCHDOG_MAX_RELOAD;
+    }
+
+    // A new reload value only applies once the previous update has reached the LSI domain
+    while (IWDG->SR & (IWDG_SR_PVU | IWDG_SR_RVU)) {
+    }
+    IWDG->KR = WATCHDOG_KEY_ACCESS;
+    IWDG->RLR = timeoutMs;
+    while (IWDG->SR & IWDG_SR_RVU) {
+    }
+    IWDG->KR = WATCHDOG_KEY_RELOAD;
+}
+
+void Watchdog_feed(void)
+{
+    IWDG->KR = WATCHDOG_KEY_RELOAD;
+}
+
+bool Watchdog_causedReset(void)
+{
+    bool watchdog = (RCC->CSR & RCC_CSR_IWDGRSTF) != 0;
+
+    RCC->CSR |= RCC_CSR_RMVF;
+    return watchdog;
+}
@@ -0,0 +1,104 @@
+/*
+ * pid_check.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Host check of the PID integrator hold (pid.c, unmodified).
+ *              While the integrator is held (door open, thermal mass
+ *              identification) a constant error must not move the output:
+ *              it stays P + held integrator + D within the output limits,
+ *              and the integrator picks up from the same value once the
+ *              hold ends.
+ *
+ * Usage: pid_check
+ *        The exit status is 1 when a check fails.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "pid.h"
+
+#define CHECK_TOLERANCE 1e-4f
+
+static int check_failures;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/**
+ * @brief Compare a value against its expectation and report it
+ *
+ * @param what Description of the check
+ * @param value Value obtained
+ * @param expected Value expected
+ */
+static void check_equal(const char *what, float value, float expected)
+{
+    bool pass = fabsf(value - expected) <= CHECK_TOLERANCE;
+
+    printf("%-4s %-46s %10.4f (expected %.4f)\n", pass ? "ok" : "FAIL", what, value, expected);
+    if (!pass) {
+        check_failures++;
+    }
+}
+
+/**
+ * @brief Integral-only controller: 1 %/(°C s), 1 s steps, output 0..100 %
+ *
+ * @param pid Controller to initialize
+ * @param integrator Integrator value to start from (%)
+ */
+static void check_initController(PIDController *pid, float integrator)
+{
+    PID_Init(pid, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 100.0f, 0.0f, 100.0f, 1.0f);
+    pid->integrator = integrator;
+}
+
+/******************************************************************************
+ * ENTRY POINT
+ ******************************************************************************/
+int main(void)
+{
+    PIDController pid;
+    uint8_t tick;
+
+    // A 10 °C error held for 5 ticks: the output stays on the held integrator
+    check_initController(&pid, 20.0f);
+    for (tick = 0; tick < 5; tick++) {
+        PID_UpdateHoldIntegrator(&pid, 110.0f, 100.0f);
+    }
+    check_equal("held: integrator after 5 ticks", pid.integrator, 20.0f);
+    check_equal("held: output after 5 ticks", pid.out, 20.0f);
+
+    // Same error without the hold integrates 10 % per tick (trapezoid, first tick 5 %)
+    check_initController(&pid, 20.0f);
+    for (tick = 0; tick < 5; tick++) {
+        PID_Update(&pid, 110.0f, 100.0f);
+    }
+    check_equal("free: output after 5 ticks", pid.out, 65.0f);
+
+    // P keeps reacting during the hold, within the output limits
+    check_initController(&pid, 20.0f);
+    pid.Kp = 2.0f;
+    check_equal("held: P + integrator", PID_UpdateHoldIntegrator(&pid, 110.0f, 100.0f), 40.0f);
+    check_equal("held: output clamped to limMax", PID_UpdateHoldIntegrator(&pid, 200.0f, 100.0f), 100.0f);
+    check_equal("held: integrator kept under saturation", pid.integrator, 20.0f);
+
+    // After the hold the integrator resumes from the held value
+    pid.Kp = 0.0f;
+    PID_Update(&pid, 110.0f, 100.0f);
+    check_equal("resumed: integrator", pid.integrator, 20.0f + 0.5f * (10.0f + 100.0f));
+
+    if (check_failures != 0) {
+        printf("%d check(s) FAILED\n", check_failures);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
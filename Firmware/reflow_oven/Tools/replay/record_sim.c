@@ -0,0 +1,185 @@
+/*
+ * record_sim.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Records a reflow run against a simulated oven, through the
+ *              same control code and recorder as the firmware, and writes
+ *              the recorder flash dump that replay reads. The dump in
+ *              replay/fixtures is produced by this tool; "make check" replays
+ *              it, so a change to the controller that alters its behaviour
+ *              shows up as a divergence until the fixture is regenerated on
+ *              purpose ("make fixture").
+ *
+ *              The oven is two zones (bottom: probes 0, 1; top: probes 2, 3),
+ *              each a first-order chamber model heated through an element
+ *              lag and coupled to the other zone. The door is opened at
+ *              cooldown. Probe readings carry a fixed offset and the MAX6675
+ *              quarter-degree resolution; nothing is random, so the dump is
+ *              the same on every host.
+ *
+ * Usage: record_sim out.bin
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "heater_zones.h"
+#include "pid.h"
+#include "power_linearization.h"
+#include "reflow_oven_process.h"
+#include "run_recorder.h"
+
+/* Simulated oven */
+#define SIM_PERIOD_MS      250u    /* Control period of the firmware (ms) */
+#define SIM_START_MS       5000u   /* HAL tick when START is pressed (ms) */
+#define SIM_MAX_MS         1200000u /* Give up on a run longer than this (ms) */
+#define SIM_AMBIENT        25.0f   /* Room and initial oven temperature (°C) */
+#define SIM_GAIN           1.2f    /* Slope at full power from ambient (°C/s), a bit heavier than the reference load */
+#define SIM_TAU            600.0f  /* Losses with the door closed (s) */
+#define SIM_DOOR_TAU       90.0f   /* Losses with the door open during cooldown (s) */
+#define SIM_ELEMENT_TAU    15.0f   /* Element lag (s) */
+#define SIM_COUPLING       0.02f   /* Exchange between the two zones (1/s) */
+#define SIM_NUM_ZONES      2u
+
+/* Controller instance used by reflow_oven_process.c */
+PIDController PID;
+
+/* Fixed probe offsets (°C): the probes of a zone never read exactly alike */
+static const float sim_probeOffset[RUNREC_NUM_PROBES] = {0.5f, -0.5f, 0.75f, -0.75f};
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/**
+ * @brief Advance the oven by one control period
+ *
+ * @param zoneTemp Air temperature of each zone (°C), updated
+ * @param element Element output of each zone (%), updated
+ * @param duty Duty fired on each zone during the period (%)
+ * @param doorOpen True once the door was opened for cooldown
+ */
+static void sim_step(float *zoneTemp, float *element, const float *duty, bool doorOpen)
+{
+    float dt = SIM_PERIOD_MS * 0.001f;
+    float tau = doorOpen ? SIM_DOOR_TAU : SIM_TAU;
+    float slope[SIM_NUM_ZONES];
+    uint8_t zone;
+
+    for (zone = 0; zone < SIM_NUM_ZONES; zone++) {
+        element[zone] += (duty[zone] - element[zone]) * dt / SIM_ELEMENT_TAU;
+        slope[zone] = SIM_GAIN * element[zone] * 0.01f - (zoneTemp[zone] - SIM_AMBIENT) / tau +
+                      SIM_COUPLING * (zoneTemp[SIM_NUM_ZONES - 1 - zone] - zoneTemp[zone]);
+    }
+    for (zone = 0; zone < SIM_NUM_ZONES; zone++) {
+        zoneTemp[zone] += slope[zone] * dt;
+    }
+}
+
+/**
+ * @brief One control tick, as task_sense, task_control, task_actuate and task_logging run it
+ *
+ * @param now HAL tick (ms)
+ * @param zoneTemp Air temperature of each zone (°C)
+ * @param duty Duty written to each zone's modulator (%), output
+ */
+static void sim_controlTick(uint32_t now, const float *zoneTemp, float *duty)
+{
+    RunRecorder_sample_t sample;
+    float probes[RUNREC_NUM_PROBES], chamber = 0.0f, applied = 0.0f;
+    uint8_t probe, zone;
+
+    // MAX6675: quarter-degree readings; the chamber is their mean
+    for (probe = 0; probe < RUNREC_NUM_PROBES; probe++) {
+        probes[probe] = RunRecorder_quantize(zoneTemp[probe / 2] + sim_probeOffset[probe], RUNREC_PROBE_SCALE) /
+                        RUNREC_PROBE_SCALE;
+        chamber += probes[probe];
+    }
+    chamber /= RUNREC_NUM_PROBES;
+
+    ReflowOven_operate(&PID, chamber, now);
+
+    HeaterZones_update(&PID, probes, 0x0F, chamber);
+    for (zone = 0; zone < HeaterZones_count; zone++) {
+        duty[zone] = PowerLin_apply(HeaterZones[zone].power);
+        if (duty[zone] > applied) {
+            applied = duty[zone];
+        }
+    }
+
+    sample.timeMs = now;
+    sample.phase = (uint8_t)ReflowOven_getCurrentPhase();
+    sample.output = (uint8_t)applied;
+    sample.setpoint = RunRecorder_quantize(ReflowOven.currentSetpoint, RUNREC_TEMP_SCALE);
+    for (probe = 0; probe < RUNREC_NUM_PROBES; probe++) {
+        sample.probe[probe] = RunRecorder_quantize(probes[probe], RUNREC_PROBE_SCALE);
+    }
+    sample.fused = RunRecorder_quantize(chamber, RUNREC_TEMP_SCALE);
+    sample.pTerm = RunRecorder_quantize(PID.Kp * PID.prevError, RUNREC_PID_SCALE);
+    sample.iTerm = RunRecorder_quantize(PID.integrator, RUNREC_PID_SCALE);
+    sample.dTerm = RunRecorder_quantize(PID.differentiator, RUNREC_PID_SCALE);
+    RunRecorder_record(&sample);
+}
+
+/******************************************************************************
+ * ENTRY POINT
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    extern uint8_t _srunlog[]; /* Recorder sector image (stubs/hal_stubs.c) */
+    const RunRecorder_flashHeader_t *header = (const RunRecorder_flashHeader_t *)_srunlog;
+    float zoneTemp[SIM_NUM_ZONES] = {SIM_AMBIENT, SIM_AMBIENT};
+    float element[SIM_NUM_ZONES] = {0.0f, 0.0f};
+    float duty[HEATER_MAX_ZONES] = {0.0f};
+    uint32_t now = SIM_START_MS;
+    size_t size;
+    FILE *out;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s out.bin\n", argv[0]);
+        return 2;
+    }
+
+    // Boot as main() does, with gains set on the PID page
+    PID_Init(&PID, 4.0f, 0.03f, 20.0f, 2.0f, 0.0f, 100.0f, 0.0f, 60.0f, SIM_PERIOD_MS * 0.001f);
+    ReflowOven_Init();
+    HeaterZones_Init(&PID);
+    PowerLin_Init();
+    RunRecorder_Init();
+    RunRecorder_saveTrace = true;
+
+    // START, then run until the recorder closes the run on the first IDLE tick
+    ReflowOven_startProcess();
+    do {
+        sim_controlTick(now, zoneTemp, duty);
+        sim_step(zoneTemp, element, duty, ReflowOven_getCurrentPhase() == REFLOW_COOLDOWN);
+        now += SIM_PERIOD_MS;
+    } while (ReflowOven_getCurrentPhase() < REFLOW_IDLE && now - SIM_START_MS < SIM_MAX_MS);
+
+    if (RunRecorder_isRecording() || header->magic != RUNREC_FLASH_MAGIC) {
+        fprintf(stderr, "record_sim: the run did not end within %u s\n", SIM_MAX_MS / 1000u);
+        return 1;
+    }
+
+    // Header and trace blocks only: the rest of the sector is not read by replay
+    size = header->headerSize + (size_t)header->numBlocks * header->blockSize;
+    out = fopen(argv[1], "wb");
+    if (out == NULL) {
+        perror(argv[1]);
+        return 2;
+    }
+    if (fwrite(_srunlog, size, 1, out) != 1) {
+        perror(argv[1]);
+        fclose(out);
+        return 2;
+    }
+    fclose(out);
+
+    printf("run: %u ticks, %.1f s, peak %.1f C, mass %.2f, end reason %u, %u blocks (%zu bytes)\n",
+           header->summary.samples, header->summary.durationMs * 0.001, header->summary.peakTemperature,
+           header->summary.massRatio, header->summary.endReason, header->numBlocks, size);
+    return 0;
+}
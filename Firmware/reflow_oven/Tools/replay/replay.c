@@ -0,0 +1,355 @@
+/*
+ * replay.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Deterministic host replay of a recorded reflow run through the
+ *              unmodified control code (reflow_oven_process.c, pid.c,
+ *              heater_zones.c and power_linearization.c).
+ *
+ *              The input is a dump of the recorder flash sector, e.g.
+ *                  st-flash read run.bin 0x08060000 0x20000
+ *              Every recorded tick feeds its fused temperature and timestamp
+ *              into ReflowOven_operate(), its probe readings into the zone
+ *              controllers, and the produced phase, setpoint, PID terms and
+ *              heater duty (through the recorded linearization table) are
+ *              diffed against the recording. The exit status is non-zero when they diverge, so
+ *              the tool can gate controller changes against production traces.
+ *
+ * Usage: replay [-n repeat] [-t tolerance] [-o out.csv] [-q] run.bin
+ *        -n  replay the run this many times (throughput measurement)
+ *        -t  accepted heater duty difference in % (default 1, covers
+ *            FMA rounding differences between the M4 FPU and the host)
+ *        -o  write recorded vs replayed values per tick as CSV
+ *        -q  only print the verdict
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "heater_zones.h"
+#include "pid.h"
+#include "power_linearization.h"
+#include "reflow_oven_process.h"
+#include "run_recorder.h"
+
+/* Accepted setpoint difference (1/16 °C) and PID term difference (1/16 %) */
+#define REPLAY_SETPOINT_TOLERANCE 1
+#define REPLAY_TERM_TOLERANCE     2
+
+/**
+ * @brief Fields compared by the replay
+ */
+typedef enum {
+    REPLAY_PHASE,
+    REPLAY_SETPOINT,
+    REPLAY_OUTPUT,
+    REPLAY_P,
+    REPLAY_I,
+    REPLAY_D,
+    REPLAY_NUM_FIELDS
+} Replay_field_t;
+
+/**
+ * @brief Divergence statistics of one replay
+ */
+typedef struct {
+    uint32_t mismatches[REPLAY_NUM_FIELDS]; /* Ticks outside tolerance */
+    int32_t maxError[REPLAY_NUM_FIELDS];    /* Largest absolute difference */
+    int32_t firstMismatch;                  /* Tick index of the first mismatch, -1 if none */
+} Replay_stats_t;
+
+/**
+ * @brief Growable sample array filled by the block decoder
+ */
+typedef struct {
+    RunRecorder_sample_t *samples;
+    uint32_t count;
+    uint32_t capacity;
+} Replay_trace_t;
+
+/* Controller instance used by reflow_oven_process.c */
+PIDController PID;
+
+static const char *const replay_fieldNames[REPLAY_NUM_FIELDS] = {
+    "phase", "setpoint", "output", "p-term", "i-term", "d-term"};
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/**
+ * @brief Heater duty of a tick, as update_heater_zones() computes it
+ *
+ * @param sample Recorded tick, supplies the probe readings
+ * @return float - Highest zone duty written to the modulator (%)
+ */
+static float replay_heaterDuty(const RunRecorder_sample_t *sample)
+{
+    float probes[RUNREC_NUM_PROBES], duty, applied = 0.0f;
+    uint8_t healthy = 0, probe, zone;
+
+    for (probe = 0; probe < RUNREC_NUM_PROBES; probe++) {
+        probes[probe] = sample->probe[probe] / RUNREC_PROBE_SCALE;
+        if (sample->probe[probe] != RUNREC_PROBE_FAULT) {
+            healthy |= (uint8_t)(1u << probe);
+        }
+    }
+    HeaterZones_update(&PID, probes, healthy, sample->fused / RUNREC_TEMP_SCALE);
+    for (zone = 0; zone < HeaterZones_count; zone++) {
+        duty = PowerLin_apply(HeaterZones[zone].power);
+        if (duty > applied) {
+            applied = duty;
+        }
+    }
+    return applied;
+}
+
+/**
+ * @brief Decoder callback: append a sample to the trace
+ */
+static void replay_collect(const RunRecorder_sample_t *sample, void *context)
+{
+    Replay_trace_t *trace = context;
+
+    if (trace->count == trace->capacity) {
+        trace->capacity = trace->capacity ? trace->capacity * 2 : 1024;
+        trace->samples = realloc(trace->samples, trace->capacity * sizeof(RunRecorder_sample_t));
+        if (trace->samples == NULL) {
+            fprintf(stderr, "replay: out of memory\n");
+            exit(2);
+        }
+    }
+    trace->samples[trace->count++] = *sample;
+}
+
+/**
+ * @brief Compare one replayed value against the recording
+ */
+static void replay_compare(Replay_stats_t *stats, Replay_field_t field, uint32_t tick,
+                           int32_t recorded, int32_t replayed, int32_t tolerance)
+{
+    int32_t error = abs(replayed - recorded);
+
+    if (error > stats->maxError[field]) {
+        stats->maxError[field] = error;
+    }
+    if (error > tolerance) {
+        stats->mismatches[field]++;
+        if (stats->firstMismatch < 0) {
+            stats->firstMismatch = (int32_t)tick;
+        }
+    }
+}
+
+/**
+ * @brief Run the recorded trace through the control code once
+ *
+ * @param header Recorder header holding the profile and PID configuration
+ * @param trace Recorded samples, first one being the IDLE -> PREHEAT tick
+ * @param tolerance Accepted actuator difference (%)
+ * @param csv Optional CSV output (NULL to skip)
+ * @param stats Divergence statistics
+ */
+static void replay_run(const RunRecorder_flashHeader_t *header, const Replay_trace_t *trace,
+                       int32_t tolerance, FILE *csv, Replay_stats_t *stats)
+{
+    uint32_t tick;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->firstMismatch = -1;
+
+    // Same state the oven had when START was pressed
+    ReflowOven_Init();
+    ReflowOven.ReflowParameters = header->profile;
+    PID = header->pid;
+    PID_Reset(&PID);
+    HeaterZones_Init(&PID);
+    PowerLin_setTable(header->powerTable);
+    ReflowOven_startProcess();
+
+    for (tick = 0; tick < trace->count; tick++) {
+        const RunRecorder_sample_t *sample = &trace->samples[tick];
+        int32_t setpoint, output, pTerm, iTerm, dTerm;
+
+        ReflowOven_operate(&PID, sample->fused / RUNREC_TEMP_SCALE, sample->timeMs);
+
+        setpoint = RunRecorder_quantize(ReflowOven.currentSetpoint, RUNREC_TEMP_SCALE);
+        output = (uint8_t)replay_heaterDuty(sample);
+        pTerm = RunRecorder_quantize(PID.Kp * PID.prevError, RUNREC_PID_SCALE);
+        iTerm = RunRecorder_quantize(PID.integrator, RUNREC_PID_SCALE);
+        dTerm = RunRecorder_quantize(PID.differentiator, RUNREC_PID_SCALE);
+
+        replay_compare(stats, REPLAY_PHASE, tick, sample->phase, ReflowOven.currentPhase, 0);
+        replay_compare(stats, REPLAY_SETPOINT, tick, sample->setpoint, setpoint, REPLAY_SETPOINT_TOLERANCE);
+        replay_compare(stats, REPLAY_OUTPUT, tick, sample->output, output, tolerance);
+        replay_compare(stats, REPLAY_P, tick, sample->pTerm, pTerm, REPLAY_TERM_TOLERANCE);
+        replay_compare(stats, REPLAY_I, tick, sample->iTerm, iTerm, REPLAY_TERM_TOLERANCE);
+        replay_compare(stats, REPLAY_D, tick, sample->dTerm, dTerm, REPLAY_TERM_TOLERANCE);
+
+        if (csv != NULL) {
+            fprintf(csv, "%u,%u,%u,%u,%.4f,%.4f,%.4f,%u,%u\n",
+                    tick, sample->timeMs, sample->phase, ReflowOven.currentPhase,
+                    sample->fused / RUNREC_TEMP_SCALE,
+                    sample->setpoint / RUNREC_TEMP_SCALE, setpoint / RUNREC_TEMP_SCALE,
+                    sample->output, (unsigned)output);
+        }
+    }
+}
+
+/**
+ * @brief Load and validate a recorder flash dump
+ *
+ * @param path Dump file
+ * @param header Output header
+ * @param trace Output samples
+ * @return int - 0 on success
+ */
+static int replay_load(const char *path, RunRecorder_flashHeader_t *header, Replay_trace_t *trace)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t block[RUNREC_BLOCK_SIZE];
+    uint16_t index;
+
+    if (file == NULL) {
+        perror(path);
+        return -1;
+    }
+    if (fread(header, sizeof(*header), 1, file) != 1 || header->magic != RUNREC_FLASH_MAGIC) {
+        fprintf(stderr, "%s: not a run recorder dump\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header->version != RUNREC_FLASH_VERSION || header->blockSize != RUNREC_BLOCK_SIZE ||
+        header->headerSize != sizeof(*header)) {
+        fprintf(stderr, "%s: recorder format v%u/%u bytes, this tool expects v%u/%u bytes\n", path,
+                header->version, header->blockSize, RUNREC_FLASH_VERSION, RUNREC_BLOCK_SIZE);
+        fclose(file);
+        return -1;
+    }
+    if (header->numBlocks == 0) {
+        fprintf(stderr, "%s: summary only, the run was stored without its trace\n", path);
+        fclose(file);
+        return -1;
+    }
+    if (header->summary.droppedBlocks != 0) {
+        fprintf(stderr, "%s: trace lost its first %u blocks, cannot replay from the start\n", path,
+                header->summary.droppedBlocks);
+        fclose(file);
+        return -1;
+    }
+
+    for (index = 0; index < header->numBlocks; index++) {
+        if (fread(block, sizeof(block), 1, file) != 1) {
+            fprintf(stderr, "%s: truncated at block %u\n", path, index);
+            fclose(file);
+            return -1;
+        }
+        RunRecorder_decodeBlock(block, replay_collect, trace);
+    }
+    fclose(file);
+
+    if (trace->count == 0 || trace->samples[0].phase != REFLOW_PREHEAT) {
+        fprintf(stderr, "%s: trace does not start at PREHEAT\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * ENTRY POINT
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    RunRecorder_flashHeader_t header;
+    Replay_trace_t trace = {0};
+    Replay_stats_t stats;
+    struct timespec start, end;
+    FILE *csv = NULL;
+    long repeat = 1;
+    int32_t tolerance = 1;
+    bool quiet = false;
+    double wallS, runS;
+    uint32_t total = 0;
+    long i;
+    int opt;
+    uint8_t field;
+
+    while ((opt = getopt(argc, argv, "n:t:o:q")) != -1) {
+        switch (opt) {
+            case 'n':
+                repeat = strtol(optarg, NULL, 0);
+                break;
+            case 't':
+                tolerance = (int32_t)strtol(optarg, NULL, 0);
+                break;
+            case 'o':
+                csv = fopen(optarg, "w");
+                if (csv == NULL) {
+                    perror(optarg);
+                    return 2;
+                }
+                fprintf(csv, "tick,time_ms,phase_rec,phase_rep,temp,setpoint_rec,setpoint_rep,out_rec,out_rep\n");
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n repeat] [-t tolerance] [-o out.csv] [-q] run.bin\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind >= argc || repeat < 1) {
+        fprintf(stderr, "usage: %s [-n repeat] [-t tolerance] [-o out.csv] [-q] run.bin\n", argv[0]);
+        return 2;
+    }
+    if (replay_load(argv[optind], &header, &trace) != 0) {
+        return 2;
+    }
+
+    // First pass produces the CSV, the rest only measure throughput
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < repeat; i++) {
+        replay_run(&header, &trace, tolerance, (i == 0) ? csv : NULL, &stats);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (csv != NULL) {
+        fclose(csv);
+    }
+
+    wallS = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+    runS = (trace.samples[trace.count - 1].timeMs - trace.samples[0].timeMs) * 0.001 * repeat;
+
+    if (!quiet) {
+        printf("run %u: %u ticks, %.1f s, entry offset %.1f s, peak %.1f C, %.1f Wh, end reason %u\n",
+               header.summary.runId, trace.count, header.summary.durationMs * 0.001,
+               header.summary.entryOffsetMs * 0.001, header.summary.peakTemperature,
+               header.summary.energyWh, header.summary.endReason);
+        printf("  door open %u x, %.1f s, load changes %u\n", header.summary.doorOpenings,
+               header.summary.doorOpenMs * 0.001, header.summary.loadChanges);
+        printf("  thermal mass %.2f x reference (gain %.2f C/s), soak %.1f s\n", header.summary.massRatio,
+               header.summary.massGain, header.summary.soakTimeMs * 0.001);
+        for (field = 0; field < REPLAY_NUM_FIELDS; field++) {
+            printf("  %-9s mismatches %6u  max error %d\n", replay_fieldNames[field],
+                   stats.mismatches[field], stats.maxError[field]);
+        }
+        printf("  replayed %ld x in %.3f s (%.0fx real time)\n", repeat, wallS, wallS > 0 ? runS / wallS : 0.0);
+    }
+
+    for (field = 0; field < REPLAY_NUM_FIELDS; field++) {
+        total += stats.mismatches[field];
+    }
+    if (total != 0) {
+        printf("DIVERGED at tick %d (t = %u ms)\n", stats.firstMismatch, trace.samples[stats.firstMismatch].timeMs);
+        free(trace.samples);
+        return 1;
+    }
+    printf("MATCH\n");
+    free(trace.samples);
+    return 0;
+}
@@ -0,0 +1,557 @@
+/*
+ * stack_budget.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Worst-case main stack budget of a firmware build, checked
+ *              against the RAM the linker left for it.
+ *
+ *              Frame sizes come from the compiler's -fstack-usage output
+ *              (one .su file per object), the call graph from the objdump
+ *              listing of the image (bl / b.w to a function symbol; tail
+ *              calls are counted as calls). The worst chain from the reset
+ *              handler is the thread stack; every interrupt priority level
+ *              adds its worst handler chain plus the exception frame, since
+ *              only a higher level can preempt a lower one.
+ *
+ *              The budget must fit _Min_Stack_Size, where the firmware keeps
+ *              its stack canary (mem_guard.h); _estack - _end - _Min_Heap_Size
+ *              from the map is the most it could ever be given.
+ *
+ *              Not seen by the tool, so passed on the command line:
+ *              - calls through function pointers (-e caller=callee,...)
+ *              - interrupt priorities (-l prio=handler,...); handlers not
+ *                listed are the fault and unused vectors, which never return
+ *              Functions without .su data (newlib, assembly) count with the
+ *              frame given by -u.
+ *
+ * Usage: stack_budget [-e caller=callee,...] [-l prio=handler,...]
+ *                     [-r root] [-u bytes] [-v] image.list image.map file.su...
+ *        -e  add call edges the listing cannot show (repeatable)
+ *        -l  handlers preempting at the same priority (repeatable)
+ *        -r  also report the chain of this function, e.g. an RTOS task
+ *            entry whose stack is not the main stack (repeatable)
+ *        -u  frame assumed for functions without .su data (default 0)
+ *        -v  print the worst chain of every handler
+ *        The exit status is 1 when the budget exceeds _Min_Stack_Size.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_FUNCS      4096
+#define MAX_NAME       96
+#define MAX_LEVELS     16
+#define MAX_ROOTS      16
+#define MAX_HANDLERS   16
+#define LINE_SIZE      1024
+
+/* Exception entry: 8 core + 18 FPU words (lazy stacking reserves them), plus alignment padding */
+#define EXCEPTION_FRAME 108
+
+/**
+ * @brief Function of the image
+ */
+typedef struct {
+    char name[MAX_NAME];
+    int32_t frame;         /* Bytes from .su, -1 when unknown */
+    bool dynamic;          /* Unbounded dynamic allocation (alloca, VLA) */
+    int *callees;
+    int numCallees;
+    int capCallees;
+    int indirect;          /* blx through a register, not resolved by -e */
+    int state;             /* Search: 0 new, 1 on the current chain, 2 done */
+    int32_t depth;         /* Worst stack from entry, own frame included */
+    int next;              /* Callee on the worst chain, -1 at a leaf */
+    bool recursive;        /* A cycle was cut below this function */
+    bool uncertain;        /* Unknown frame or unresolved indirect call on the worst chain */
+} Stack_func_t;
+
+/**
+ * @brief Handlers sharing a preemption priority
+ */
+typedef struct {
+    int priority;
+    const char *handlers[MAX_HANDLERS];
+    int numHandlers;
+} Stack_level_t;
+
+static Stack_func_t stack_funcs[MAX_FUNCS];
+static int stack_numFuncs;
+static int32_t stack_unknownFrame;
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/**
+ * @brief Find a function, adding it when new
+ *
+ * @param name Symbol name
+ * @return int - Function index, -1 when the table is full
+ */
+static int stack_lookup(const char *name)
+{
+    int i;
+
+    for (i = 0; i < stack_numFuncs; i++) {
+        if (strcmp(stack_funcs[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (stack_numFuncs == MAX_FUNCS) {
+        fprintf(stderr, "more than %d functions\n", MAX_FUNCS);
+        return -1;
+    }
+    snprintf(stack_funcs[i].name, MAX_NAME, "%s", name);
+    stack_funcs[i].frame = -1;
+    stack_funcs[i].next = -1;
+    return stack_numFuncs++;
+}
+
+/**
+ * @brief Find a function without adding it
+ *
+ * @param name Symbol name
+ * @return int - Function index, -1 when not in the image
+ */
+static int stack_find(const char *name)
+{
+    int i;
+
+    for (i = 0; i < stack_numFuncs; i++) {
+        if (strcmp(stack_funcs[i].name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Add a call edge once
+ *
+ * @param caller Caller index
+ * @param callee Callee index
+ */
+static void stack_addCall(int caller, int callee)
+{
+    Stack_func_t *func = &stack_funcs[caller];
+    int i;
+
+    for (i = 0; i < func->numCallees; i++) {
+        if (func->callees[i] == callee) {
+            return;
+        }
+    }
+    if (func->numCallees == func->capCallees) {
+        func->capCallees = func->capCallees ? 2 * func->capCallees : 8;
+        func->callees = realloc(func->callees, func->capCallees * sizeof(int));
+    }
+    func->callees[func->numCallees++] = callee;
+}
+
+/**
+ * @brief Read the frame sizes of one .su file
+ *
+ * Lines look like "../Core/Src/main.c:77:5:main\t136\tstatic".
+ *
+ * @param path .su file
+ * @return bool - False when it cannot be read
+ */
+static bool stack_readSu(const char *path)
+{
+    char line[LINE_SIZE], *tab, *name, qualifier[64];
+    long bytes;
+    FILE *file = fopen(path, "r");
+    int index;
+
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        tab = strchr(line, '\t');
+        if (tab == NULL || sscanf(tab, "\t%ld\t%63s", &bytes, qualifier) != 2) {
+            continue;
+        }
+        *tab = '\0';
+        name = strrchr(line, ':');
+        name = (name != NULL) ? name + 1 : line;
+        if ((index = stack_lookup(name)) < 0) {
+            break;
+        }
+        // Same static name in two files: keep the larger frame
+        if (bytes > stack_funcs[index].frame) {
+            stack_funcs[index].frame = (int32_t)bytes;
+        }
+        if (strncmp(qualifier, "dynamic", 7) == 0 && strstr(qualifier, "bounded") == NULL) {
+            stack_funcs[index].dynamic = true;
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief Read the call graph from the objdump listing
+ *
+ * Function headers look like "08000ae8 <NMI_Handler>:", instructions like
+ * " 80001f8:\tf000 f806 \tbl\t8000208 <__udivmoddi4>".
+ *
+ * @param path Listing (objdump -d or -S)
+ * @return bool - False when it cannot be read
+ */
+static bool stack_readListing(const char *path)
+{
+    char line[LINE_SIZE], target[MAX_NAME];
+    char *fields[4], *cursor, *open, *close;
+    FILE *file = fopen(path, "r");
+    int current = -1, callee, count;
+    size_t length;
+
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+
+        // Function header
+        if (isxdigit((unsigned char)line[0]) && (open = strstr(line, " <")) != NULL &&
+            (length = strlen(line)) > 2 && strcmp(line + length - 2, ">:") == 0) {
+            line[length - 2] = '\0';
+            current = stack_lookup(open + 2);
+            continue;
+        }
+
+        // Instruction: address, encoding, mnemonic, operands separated by tabs
+        cursor = line;
+        while (*cursor == ' ') {
+            cursor++;
+        }
+        if (current < 0 || !isxdigit((unsigned char)*cursor) || strstr(cursor, ":\t") == NULL) {
+            continue;
+        }
+        for (count = 0; count < 4 && cursor != NULL; count++) {
+            fields[count] = cursor;
+            cursor = strchr(cursor, '\t');
+            if (cursor != NULL) {
+                *cursor++ = '\0';
+            }
+        }
+        if (count < 3 || fields[2][0] != 'b') {
+            continue;
+        }
+        if (strcmp(fields[2], "blx") == 0 && count == 4 && fields[3][0] == 'r') {
+            stack_funcs[current].indirect++;
+            continue;
+        }
+
+        // bl/b.w/b<cond> to the start of another function; "<f+0x12>" is a branch within one
+        if (count < 4 || (open = strchr(fields[3], '<')) == NULL || (close = strchr(open, '>')) == NULL ||
+            memchr(open, '+', close - open) != NULL || close - open - 1 >= MAX_NAME) {
+            continue;
+        }
+        memcpy(target, open + 1, close - open - 1);
+        target[close - open - 1] = '\0';
+        if (strcmp(target, stack_funcs[current].name) != 0 && (callee = stack_lookup(target)) >= 0) {
+            stack_addCall(current, callee);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief Read the RAM layout from the linker map
+ *
+ * @param path Map file
+ * @param estack _estack
+ * @param end _end (start of the heap)
+ * @param heapSize _Min_Heap_Size
+ * @param stackSize _Min_Stack_Size
+ * @return bool - False when a symbol is missing
+ */
+static bool stack_readMap(const char *path, unsigned long *estack, unsigned long *end, unsigned long *heapSize,
+                          unsigned long *stackSize)
+{
+    static const char *const keys[4] = {" _estack = ", "(_end = .)", " _Min_Heap_Size = ", " _Min_Stack_Size = "};
+    unsigned long *values[4] = {estack, end, heapSize, stackSize};
+    bool found[4] = {false};
+    char line[LINE_SIZE];
+    FILE *file = fopen(path, "r");
+    int key;
+
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        for (key = 0; key < 4; key++) {
+            if (!found[key] && strstr(line, keys[key]) != NULL && sscanf(line, " 0x%lx", values[key]) == 1) {
+                found[key] = true;
+            }
+        }
+    }
+    fclose(file);
+    for (key = 0; key < 4; key++) {
+        if (!found[key]) {
+            fprintf(stderr, "%s: no%s in the map\n", path, keys[key]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Worst stack from the entry of a function (depth-first, memoised)
+ *
+ * A call back into a function already on the chain (recursion) is cut and
+ * flagged: the figure is then a lower bound.
+ *
+ * @param index Function index
+ * @return int32_t - Bytes
+ */
+static int32_t stack_depth(int index)
+{
+    Stack_func_t *func = &stack_funcs[index];
+    int32_t deepest = 0, depth;
+    int i, callee;
+
+    if (func->state == 2) {
+        return func->depth;
+    }
+    if (func->state == 1) {
+        func->recursive = true;
+        return 0;
+    }
+    func->state = 1;
+    func->next = -1;
+    for (i = 0; i < func->numCallees; i++) {
+        callee = func->callees[i];
+        depth = stack_depth(callee);
+        if (stack_funcs[callee].recursive) {
+            func->recursive = true;
+        }
+        if (func->next < 0 || depth > deepest) {
+            deepest = depth;
+            func->next = callee;
+        }
+    }
+    func->depth = ((func->frame >= 0) ? func->frame : stack_unknownFrame) + deepest;
+    func->uncertain = func->frame < 0 || func->dynamic || func->indirect > 0 ||
+                      (func->next >= 0 && stack_funcs[func->next].uncertain);
+    func->state = 2;
+    return func->depth;
+}
+
+/**
+ * @brief Print the worst chain below a function
+ *
+ * @param index Function index
+ */
+static void stack_printChain(int index)
+{
+    const Stack_func_t *func;
+    int hops = 0;
+
+    printf("        ");
+    for (; index >= 0 && hops < 64; index = func->next, hops++) {
+        func = &stack_funcs[index];
+        if (func->frame >= 0) {
+            printf("%s%s(%d%s)", hops ? " > " : "", func->name, func->frame, func->dynamic ? "+dyn" : "");
+        } else {
+            printf("%s%s(?)", hops ? " > " : "", func->name);
+        }
+        if (func->indirect > 0) {
+            printf("[%d indirect]", func->indirect);
+        }
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Parse "key=a,b,c" into a key and a list
+ *
+ * @param arg Argument, modified
+ * @param items Names found after the '='
+ * @param maxItems Capacity of items
+ * @return int - Number of names, -1 without '='
+ */
+static int stack_splitList(char *arg, char **items, int maxItems)
+{
+    char *equal = strchr(arg, '='), *item;
+    int count = 0;
+
+    if (equal == NULL) {
+        return -1;
+    }
+    *equal = '\0';
+    for (item = strtok(equal + 1, ","); item != NULL && count < maxItems; item = strtok(NULL, ",")) {
+        items[count++] = item;
+    }
+    return count;
+}
+
+/******************************************************************************
+ * ENTRY POINT
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    char *edges[64], *items[MAX_HANDLERS];
+    const char *roots[MAX_ROOTS];
+    Stack_level_t levels[MAX_LEVELS];
+    int numEdges = 0, numLevels = 0, numRoots = 0;
+    unsigned long estack, end, heapSize, stackSize, available;
+    int32_t threadDepth, total, depth, worst;
+    int opt, i, j, count, thread, handler, worstHandler, caller, callee;
+    bool verbose = false, uncertain, recursive;
+
+    while ((opt = getopt(argc, argv, "e:l:r:u:v")) != -1) {
+        switch (opt) {
+            case 'e':
+                if (numEdges < 64) {
+                    edges[numEdges++] = optarg;
+                }
+                break;
+            case 'l':
+                if (numLevels == MAX_LEVELS || (count = stack_splitList(optarg, items, MAX_HANDLERS)) < 0) {
+                    fprintf(stderr, "bad level %s\n", optarg);
+                    return 2;
+                }
+                levels[numLevels].priority = atoi(optarg);
+                levels[numLevels].numHandlers = count;
+                memcpy(levels[numLevels].handlers, items, count * sizeof(char *));
+                numLevels++;
+                break;
+            case 'r':
+                if (numRoots < MAX_ROOTS) {
+                    roots[numRoots++] = optarg;
+                }
+                break;
+            case 'u':
+                stack_unknownFrame = atoi(optarg);
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            default:
+                fprintf(stderr,
+                        "usage: %s [-e caller=callee,...] [-l prio=handler,...] [-r root] [-u bytes] [-v] "
+                        "image.list image.map file.su...\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+    if (argc - optind < 3) {
+        fprintf(stderr, "need the listing, the map and at least one .su file\n");
+        return 2;
+    }
+
+    // Frames first, then the graph: every function of the listing gets an entry
+    for (i = optind + 2; i < argc; i++) {
+        if (!stack_readSu(argv[i])) {
+            return 2;
+        }
+    }
+    if (!stack_readListing(argv[optind]) ||
+        !stack_readMap(argv[optind + 1], &estack, &end, &heapSize, &stackSize)) {
+        return 2;
+    }
+    for (i = 0; i < numEdges; i++) {
+        count = stack_splitList(edges[i], items, MAX_HANDLERS);
+        if (count < 0 || (caller = stack_find(edges[i])) < 0) {
+            fprintf(stderr, "edge %s: no such caller in the image\n", edges[i]);
+            continue;
+        }
+        for (j = 0; j < count; j++) {
+            if ((callee = stack_find(items[j])) < 0) {
+                fprintf(stderr, "edge %s: no callee %s in the image\n", edges[i], items[j]);
+                continue;
+            }
+            stack_addCall(caller, callee);
+        }
+        // The pointer calls of this caller are now resolved
+        stack_funcs[caller].indirect = 0;
+    }
+
+    // Thread: from the reset vector when present (startup code, then main)
+    thread = stack_find("Reset_Handler");
+    if (thread < 0) {
+        thread = stack_find("main");
+    }
+    if (thread < 0) {
+        fprintf(stderr, "neither Reset_Handler nor main in the listing\n");
+        return 2;
+    }
+    threadDepth = stack_depth(thread);
+    uncertain = stack_funcs[thread].uncertain;
+    recursive = stack_funcs[thread].recursive;
+    total = threadDepth;
+    printf("thread            %-28s %6d B\n", stack_funcs[thread].name, threadDepth);
+    stack_printChain(thread);
+
+    // One handler per priority level can be active at a time
+    for (i = 0; i < numLevels; i++) {
+        worst = -1;
+        worstHandler = -1;
+        for (j = 0; j < levels[i].numHandlers; j++) {
+            if ((handler = stack_find(levels[i].handlers[j])) < 0) {
+                fprintf(stderr, "level %d: %s not in the image\n", levels[i].priority, levels[i].handlers[j]);
+                continue;
+            }
+            depth = stack_depth(handler);
+            if (verbose) {
+                printf("  prio %-2d         %-28s %6d B\n", levels[i].priority, stack_funcs[handler].name, depth);
+                stack_printChain(handler);
+            }
+            if (depth > worst) {
+                worst = depth;
+                worstHandler = handler;
+            }
+        }
+        if (worstHandler < 0) {
+            continue;
+        }
+        total += worst + EXCEPTION_FRAME;
+        uncertain |= stack_funcs[worstHandler].uncertain;
+        recursive |= stack_funcs[worstHandler].recursive;
+        printf("prio %-2d           %-28s %6d B + %d B frame\n", levels[i].priority, stack_funcs[worstHandler].name,
+               worst, EXCEPTION_FRAME);
+        if (!verbose) {
+            stack_printChain(worstHandler);
+        }
+    }
+
+    // Other stacks (RTOS tasks): reported, not added to the main stack
+    for (i = 0; i < numRoots; i++) {
+        if ((handler = stack_find(roots[i])) < 0) {
+            fprintf(stderr, "root %s not in the image\n", roots[i]);
+            continue;
+        }
+        printf("own stack         %-28s %6d B\n", roots[i], stack_depth(handler));
+        stack_printChain(handler);
+    }
+
+    available = estack - end - heapSize;
+    printf("\nworst case main stack                          %6d B\n", total);
+    printf("reserved  (_Min_Stack_Size)                    %6lu B  %s\n", stackSize,
+           (unsigned long)total <= stackSize ? "OK" : "OVER");
+    printf("available (_estack - _end - _Min_Heap_Size)    %6lu B  %s\n", available,
+           (unsigned long)total <= available ? "OK" : "OVER");
+    if (uncertain) {
+        printf("note: unknown frames (charged %d B) or pointer calls on the worst chains\n", stack_unknownFrame);
+    }
+    if (recursive) {
+        printf("note: recursion cut on the worst chains, the figure is a lower bound\n");
+    }
+    return ((unsigned long)total <= stackSize) ? 0 : 1;
+}
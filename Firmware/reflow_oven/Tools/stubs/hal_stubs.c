@@ -0,0 +1,64 @@
+/*
+ * hal_stubs.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Host implementation of the HAL calls declared in stubs/main.h.
+ *              The flash calls act on an image of the recorder sector that
+ *              stands in for _srunlog: erase sets it to 0xFF and programming
+ *              can only clear bits, as on the STM32. Writes outside the
+ *              image are refused.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "main.h"
+
+#define STUB_RUNLOG_SIZE 0x20000u /* Recorder flash sector (FLASH_SECTOR_7, 128 KB) */
+
+/* Linker symbol the recorder uses as flash base address, erased at start */
+uint8_t _srunlog[STUB_RUNLOG_SIZE] = {[0 ... STUB_RUNLOG_SIZE - 1] = 0xFF};
+
+/* Replay tools drive time explicitly; the tick is only here to link */
+uint32_t HAL_GetTick(void)
+{
+    return 0;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError)
+{
+    if (pEraseInit->Sector != FLASH_SECTOR_7 || pEraseInit->NbSectors != 1) {
+        *SectorError = pEraseInit->Sector;
+        return HAL_ERROR;
+    }
+    memset(_srunlog, 0xFF, sizeof(_srunlog));
+    *SectorError = 0xFFFFFFFFU;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    // Addresses are truncated to 32 bits by the firmware code, as is the base here
+    uint32_t offset = Address - (uint32_t)(uintptr_t)_srunlog;
+    uint32_t word = (uint32_t)Data;
+    uint8_t i;
+
+    if (TypeProgram != FLASH_TYPEPROGRAM_WORD || offset > STUB_RUNLOG_SIZE - 4 || (offset & 3u) != 0) {
+        return HAL_ERROR;
+    }
+    for (i = 0; i < 4; i++) {
+        _srunlog[offset + i] &= (uint8_t)(word >> (8 * i));
+    }
+    return HAL_OK;
+}
@@ -0,0 +1,62 @@
+/*
+ * main.h (host stub)
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Minimal stand-in for the firmware's main.h / STM32 HAL used by
+ *              the host tools. Only the types and calls reached by the
+ *              control code linked into the tools are provided; the flash
+ *              calls write to an image of the recorder sector in RAM.
+ */
+
+#ifndef TOOLS_STUBS_MAIN_H_
+#define TOOLS_STUBS_MAIN_H_
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * HAL TYPES
+ ******************************************************************************/
+typedef enum
+{
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct
+{
+    uint32_t TypeErase;
+    uint32_t Banks;
+    uint32_t Sector;
+    uint32_t NbSectors;
+    uint32_t VoltageRange;
+} FLASH_EraseInitTypeDef;
+
+/******************************************************************************
+ * HAL CONSTANTS
+ ******************************************************************************/
+#define FLASH_TYPEERASE_SECTORS 0x00000000U
+#define FLASH_VOLTAGE_RANGE_3   0x00000002U
+#define FLASH_TYPEPROGRAM_WORD  0x00000002U
+#define FLASH_SECTOR_7          7U
+
+#define TIM_CHANNEL_1           0x00000000U
+#define TIM_CHANNEL_4           0x0000000CU
+
+/******************************************************************************
+ * HAL FUNCTIONS (hal_stubs.c)
+ ******************************************************************************/
+uint32_t HAL_GetTick(void);
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *SectorError);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+
+#endif /* TOOLS_STUBS_MAIN_H_ */
@@ -0,0 +1,392 @@
+/*
+ * trace2json.c
+ *
+ * Created on: Oct 18, 2026
+ * Author: adrian
+ *
+ * Description: Host decoder of the firmware event trace (trace.h). The
+ *              input is a capture of the telemetry UART taken while the
+ *              "TRACE" command ran, e.g.
+ *                  cat /dev/ttyUSB0 | tee oven.log
+ *              Other telemetry lines in between are ignored; the last
+ *              complete $TRACE,BEGIN ... $TRACE,END block is decoded.
+ *
+ *              The DWT stamps wrap every 2^32 cycles (~43 s at 100 MHz);
+ *              they are unwrapped record to record, so two consecutive
+ *              records must lie less than half a wrap apart.
+ *
+ *              The output is a Chrome trace (open in chrome://tracing or
+ *              ui.perfetto.dev): one lane for the interrupts, one for the
+ *              control step, the MAX6675 reads, the GUI and the reflow
+ *              process, and one per scheduler task.
+ *
+ * Usage: trace2json [-o out.json] [-t] [log]
+ *        -o  write the Chrome trace here (default: stdout)
+ *        -t  print a text timeline instead
+ *        log defaults to stdin
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "trace.h"
+
+/* Timeline lanes (Chrome trace thread ids) */
+#define LANE_IRQ      1
+#define LANE_CONTROL  2
+#define LANE_SENSORS  3
+#define LANE_GUI      4
+#define LANE_PROCESS  5
+#define LANE_TASKS    100 /* + scheduler task id */
+
+#define MAX_TASKS     32u
+#define LINE_SIZE     512u
+
+/**
+ * @brief Decoded dump
+ */
+typedef struct {
+    Trace_record_t *records;
+    uint32_t count;        /* Records announced in the header */
+    uint32_t received;     /* Records decoded so far */
+    uint32_t dropped;      /* Events dropped while the ring was frozen */
+    uint32_t mask;
+    double cyclesPerUs;
+    char taskNames[MAX_TASKS][16];
+    bool complete;         /* $TRACE,END seen */
+} Trace_dump_t;
+
+static const char *const trace_eventNames[TRACE_NUM_EVENTS] = {
+    [TRACE_ZERO_CROSS] = "zero_cross",
+    [TRACE_MAINS_LOST] = "mains_lost",
+    [TRACE_MAINS_RESTORED] = "mains_restored",
+    [TRACE_BUTTON] = "button",
+    [TRACE_ENCODER] = "encoder",
+    [TRACE_UART_RX] = "uart_rx",
+    [TRACE_CONTROL_RELEASE] = "release",
+    [TRACE_CONTROL_BEGIN] = "control",
+    [TRACE_CONTROL_END] = "control",
+    [TRACE_TASK_BEGIN] = "task",
+    [TRACE_TASK_END] = "task",
+    [TRACE_PHASE] = "phase",
+    [TRACE_SENSOR_BEGIN] = "max6675",
+    [TRACE_SENSOR_END] = "max6675",
+    [TRACE_SENSOR_ERROR] = "max6675_error",
+    [TRACE_GUI_EVENT] = "gui_event",
+    [TRACE_FAULT] = "fault",
+};
+
+/* Same order as ReflowPhases_t */
+static const char *const trace_phaseNames[] = {
+    "PREHEAT", "SOAK", "HEATUP", "REFLOW", "COOLDOWN", "IDLE", "STANDBY"};
+
+/******************************************************************************
+ * PRIVATE FUNCTIONS
+ ******************************************************************************/
+/**
+ * @brief Name of a reflow phase
+ *
+ * @param phase ReflowPhases_t value
+ * @return const char* - Phase name, "?" when unknown
+ */
+static const char *trace_phaseName(uint32_t phase)
+{
+    return (phase < sizeof(trace_phaseNames) / sizeof(trace_phaseNames[0])) ? trace_phaseNames[phase] : "?";
+}
+
+/**
+ * @brief Whether an event opens a duration
+ *
+ * @param event Trace event
+ * @return bool - True for the *_BEGIN events
+ */
+static bool trace_isBegin(Trace_event_t event)
+{
+    return event == TRACE_CONTROL_BEGIN || event == TRACE_SENSOR_BEGIN || event == TRACE_TASK_BEGIN;
+}
+
+/**
+ * @brief Whether an event closes a duration
+ *
+ * @param event Trace event
+ * @return bool - True for the *_END events
+ */
+static bool trace_isEnd(Trace_event_t event)
+{
+    return event == TRACE_CONTROL_END || event == TRACE_SENSOR_END || event == TRACE_TASK_END;
+}
+
+/**
+ * @brief Parse 8 hex digits
+ *
+ * @param text At least 8 characters
+ * @param value Parsed word
+ * @return bool - False on a non-hex digit
+ */
+static bool trace_parseWord(const char *text, uint32_t *value)
+{
+    char word[9];
+    char *end;
+
+    memcpy(word, text, 8);
+    word[8] = '\0';
+    *value = (uint32_t)strtoul(word, &end, 16);
+    return end == word + 8;
+}
+
+/**
+ * @brief Feed one line of the capture
+ *
+ * @param dump Dump being assembled
+ * @param line Line without its terminator
+ */
+static void trace_parseLine(Trace_dump_t *dump, const char *line)
+{
+    unsigned long hz, count, dropped, mask, index;
+    unsigned id;
+    char name[16];
+    const char *tag;
+    int used;
+
+    // Lines may carry noise ahead of the tag (boot garbage, partial lines)
+    if ((tag = strstr(line, "$TRACE,BEGIN,")) != NULL) {
+        if (sscanf(tag, "$TRACE,BEGIN,%lu,%lu,%lu,%lx", &hz, &count, &dropped, &mask) != 4) {
+            return;
+        }
+        free(dump->records);
+        memset(dump, 0, sizeof(*dump));
+        dump->records = calloc(count ? count : 1, sizeof(Trace_record_t));
+        dump->count = (uint32_t)count;
+        dump->dropped = (uint32_t)dropped;
+        dump->mask = (uint32_t)mask;
+        dump->cyclesPerUs = hz / 1e6;
+    } else if ((tag = strstr(line, "$TRACE,TASK,")) != NULL) {
+        if (sscanf(tag, "$TRACE,TASK,%u,%15s", &id, name) == 2 && id < MAX_TASKS) {
+            snprintf(dump->taskNames[id], sizeof(dump->taskNames[id]), "%s", name);
+        }
+    } else if (strstr(line, "$TRACE,END") != NULL) {
+        dump->complete = dump->records != NULL;
+    } else if ((tag = strstr(line, "$TR,")) != NULL && dump->records != NULL) {
+        if (sscanf(tag, "$TR,%lu,%n", &index, &used) != 1) {
+            return;
+        }
+        // A corrupted index would run past the records the dump announced
+        if (index >= dump->count) {
+            fprintf(stderr, "record %lu out of range (%u records), line dropped\n", index, dump->count);
+            return;
+        }
+        // A repeated line only overwrites records already decoded
+        if (index > dump->received) {
+            fprintf(stderr, "records %u..%lu missing from the capture\n", dump->received, index - 1);
+        }
+        tag += used;
+        while (index < dump->count && strlen(tag) >= 16) {
+            if (!trace_parseWord(tag, &dump->records[index].cycles) ||
+                !trace_parseWord(tag + 8, &dump->records[index].data)) {
+                break;
+            }
+            index++;
+            tag += 16;
+        }
+        if (index > dump->received) {
+            dump->received = (uint32_t)index;
+        }
+    }
+}
+
+/**
+ * @brief Name a Chrome trace thread id
+ *
+ * @param out Output
+ * @param lane Thread id
+ * @param name Lane name
+ */
+static void trace_emitLane(FILE *out, uint32_t lane, const char *name)
+{
+    fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}},\n",
+            lane, name);
+}
+
+/**
+ * @brief Write the decoded records as a Chrome trace or a text timeline
+ *
+ * @param dump Decoded dump
+ * @param out Output
+ * @param text True for the text timeline
+ */
+static void trace_emit(const Trace_dump_t *dump, FILE *out, bool text)
+{
+    uint32_t openDepth[LANE_TASKS + MAX_TASKS] = {0};
+    uint64_t cycles = 0;
+    uint32_t index, id, payload, lane;
+    const char *name, *phase;
+    char label[32];
+    double us;
+
+    if (!text) {
+        fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        trace_emitLane(out, LANE_IRQ, "interrupts");
+        trace_emitLane(out, LANE_CONTROL, "control");
+        trace_emitLane(out, LANE_SENSORS, "max6675");
+        trace_emitLane(out, LANE_GUI, "gui");
+        trace_emitLane(out, LANE_PROCESS, "process");
+        for (id = 0; id < MAX_TASKS; id++) {
+            if (dump->taskNames[id][0] != '\0') {
+                trace_emitLane(out, LANE_TASKS + id, dump->taskNames[id]);
+            }
+        }
+    }
+
+    for (index = 0; index < dump->received; index++) {
+        const Trace_record_t *record = &dump->records[index];
+        Trace_event_t event = (Trace_event_t)(record->data >> 24);
+
+        // Unwrap the stamp: consecutive records are less than half a wrap apart
+        if (index > 0) {
+            cycles += (int64_t)(int32_t)(record->cycles - dump->records[index - 1].cycles);
+        }
+        us = cycles / dump->cyclesPerUs;
+        payload = record->data & TRACE_PAYLOAD_MASK;
+        name = (event < TRACE_NUM_EVENTS) ? trace_eventNames[event] : "unknown";
+
+        if (text) {
+            fprintf(out, "%14.3f us  %-16s %-5s %u\n", us, name,
+                    trace_isBegin(event) ? "begin" : trace_isEnd(event) ? "end" : "", payload);
+            continue;
+        }
+
+        switch (event) {
+            case TRACE_CONTROL_BEGIN:
+            case TRACE_CONTROL_END:
+                lane = LANE_CONTROL;
+                break;
+            case TRACE_SENSOR_BEGIN:
+            case TRACE_SENSOR_END:
+                snprintf(label, sizeof(label), "max6675 #%u", payload);
+                name = label;
+                lane = LANE_SENSORS;
+                break;
+            case TRACE_TASK_BEGIN:
+            case TRACE_TASK_END:
+                if (payload >= MAX_TASKS) {
+                    continue;
+                }
+                name = (dump->taskNames[payload][0] != '\0') ? dump->taskNames[payload] : "task";
+                lane = LANE_TASKS + payload;
+                break;
+            case TRACE_SENSOR_ERROR:
+                snprintf(label, sizeof(label), "max6675 #%u error", payload >> 16);
+                name = label;
+                lane = LANE_SENSORS;
+                break;
+            case TRACE_GUI_EVENT:
+                lane = LANE_GUI;
+                break;
+            case TRACE_PHASE:
+                phase = trace_phaseName(payload >> 8 & 0xFF);
+                snprintf(label, sizeof(label), "%s -> %s", phase, trace_phaseName(payload & 0xFF));
+                name = label;
+                lane = LANE_PROCESS;
+                break;
+            case TRACE_FAULT:
+                lane = LANE_PROCESS;
+                break;
+            default:
+                lane = (event == TRACE_CONTROL_RELEASE) ? LANE_CONTROL : LANE_IRQ;
+                break;
+        }
+
+        // Durations cut by the start of the ring have no begin: drop their end
+        if (trace_isBegin(event)) {
+            openDepth[lane]++;
+            fprintf(out, "{\"name\":\"%s\",\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%.3f},\n", name, lane, us);
+        } else if (trace_isEnd(event)) {
+            if (openDepth[lane] == 0) {
+                continue;
+            }
+            openDepth[lane]--;
+            fprintf(out, "{\"name\":\"%s\",\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"payload\":%u}},\n",
+                    name, lane, us, payload);
+        } else {
+            fprintf(out,
+                    "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,"
+                    "\"args\":{\"payload\":%u}},\n",
+                    name, (event == TRACE_FAULT) ? 'g' : 't', lane, us, payload);
+        }
+    }
+
+    if (!text) {
+        // Closing metadata entry, so every event above can end with a comma
+        fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"reflow oven\"}}\n]}\n");
+    }
+}
+
+/******************************************************************************
+ * ENTRY POINT
+ ******************************************************************************/
+int main(int argc, char **argv)
+{
+    Trace_dump_t dump = {0}, last = {0};
+    char line[LINE_SIZE];
+    FILE *in = stdin, *out = stdout;
+    bool text = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:t")) != -1) {
+        switch (opt) {
+            case 'o':
+                out = fopen(optarg, "w");
+                if (out == NULL) {
+                    perror(optarg);
+                    return 2;
+                }
+                break;
+            case 't':
+                text = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-o out.json] [-t] [log]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind < argc && strcmp(argv[optind], "-") != 0) {
+        in = fopen(argv[optind], "r");
+        if (in == NULL) {
+            perror(argv[optind]);
+            return 2;
+        }
+    }
+
+    // Keep the last complete dump; a capture cut in the middle of a later one still decodes
+    while (fgets(line, sizeof(line), in) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        trace_parseLine(&dump, line);
+        if (dump.complete) {
+            free(last.records);
+            last = dump;
+            memset(&dump, 0, sizeof(dump));
+        }
+    }
+    free(dump.records);
+    if (in != stdin) {
+        fclose(in);
+    }
+    if (last.records == NULL) {
+        fprintf(stderr, "no complete $TRACE dump in the input\n");
+        return 1;
+    }
+
+    fprintf(stderr, "%u of %u records, %u events dropped while frozen, mask %08x\n", last.received, last.count,
+            last.dropped, last.mask);
+    trace_emit(&last, out, text);
+    if (out != stdout) {
+        fclose(out);
+    }
+    free(last.records);
+    return 0;
+}